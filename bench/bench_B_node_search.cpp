@@ -0,0 +1,124 @@
+// Compares the key search inside a B tree node (B_node_search.h) with the
+// binary search it replaced, on single nodes and on whole trees.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+#include "ronleeon/tree/B_node_search.h"
+#include "ronleeon/tree/B_tree.h"
+
+namespace{
+
+	// the former find_in_node: two comparisons per probe and an early exit on equality.
+	template<typename DataType, size_t Capacity, typename Compare>
+	std::pair<size_t, bool> binary_search(const std::array<DataType, Capacity>& Keys, size_t Size, const DataType& Data
+		, const Compare& comp){
+		if(Size == 0){
+			return {0, false};
+		}
+		size_t Left = 0;
+		size_t Right = Size - 1;
+		size_t Middle = 0;
+		while(Left <= Right){
+			Middle = Left + (Right - Left) / 2;
+			if(comp(Keys[Middle], Data)){
+				Left = Middle + 1;
+			}else if(comp(Data, Keys[Middle])){
+				if(Middle == 0){
+					break;
+				}
+				Right = Middle - 1;
+			}else{
+				return {Middle, true};
+			}
+		}
+		return {comp(Keys[Middle], Data) ? Middle + 1 : Middle, false};
+	}
+
+	template<typename Function>
+	double nanoseconds_per_call(size_t Calls, Function f){
+		auto Start = std::chrono::steady_clock::now();
+		f();
+		std::chrono::duration<double, std::nano> Elapsed = std::chrono::steady_clock::now() - Start;
+		return Elapsed.count() / static_cast<double>(Calls);
+	}
+
+	// full nodes of Capacity keys, searched for random present and absent keys.
+	template<typename DataType, size_t Capacity>
+	void bench_node(){
+		constexpr size_t Nodes = 1024;
+		constexpr size_t Queries = 1 << 22;
+		std::mt19937_64 gen(42);
+		std::vector<std::array<DataType, Capacity>> Keys(Nodes);
+		for(auto& Node : Keys){
+			for(auto& Key : Node){
+				Key = static_cast<DataType>(gen() % (Capacity * 4));
+			}
+			std::sort(Node.begin(), Node.end());
+		}
+		std::vector<DataType> Data(Queries);
+		for(auto& Value : Data){
+			Value = static_cast<DataType>(gen() % (Capacity * 4));
+		}
+		std::less<DataType> comp;
+		size_t Sink = 0;
+		double Old = nanoseconds_per_call(Queries, [&]{
+			for(size_t I = 0; I < Queries; ++I){
+				auto [Position, Found] = binary_search(Keys[I % Nodes], Capacity, Data[I], comp);
+				Sink += Position + Found;
+			}
+		});
+		double New = nanoseconds_per_call(Queries, [&]{
+			for(size_t I = 0; I < Queries; ++I){
+				auto [Position, Found] = ronleeon::tree::B_node_search(Keys[I % Nodes], Capacity, Data[I], comp);
+				Sink += Position + Found;
+			}
+		});
+		std::printf("%4zu keys of %zu bytes: binary search %6.2f ns, B_node_search %6.2f ns (%s)\t[%zu]\n", Capacity
+			, sizeof(DataType), Old, New
+			, ronleeon::tree::is_simd_searchable<DataType, std::less<DataType>>::value
+				&& Capacity * sizeof(DataType) <= ronleeon::tree::B_node_scan_bytes ? "scan" : "bisect", Sink % 10);
+	}
+
+	template<size_t NodeBytes>
+	void bench_tree(){
+		constexpr size_t Size = 1 << 20;
+		std::mt19937_64 gen(42);
+		std::vector<long> Data(Size);
+		for(auto& Value : Data){
+			Value = static_cast<long>(gen() % (Size * 2));
+		}
+		ronleeon::tree::B_tree_auto<long, NodeBytes> t;
+		for(auto Value : Data){
+			t.insert(Value);
+		}
+		std::shuffle(Data.begin(), Data.end(), gen);
+		size_t Sink = 0;
+		double Time = nanoseconds_per_call(Size, [&]{
+			for(auto Value : Data){
+				Sink += std::get<2>(t.find(Value));
+			}
+		});
+		std::printf("B_tree_auto<long, %zu> find: %6.2f ns\t[%zu]\n", NodeBytes, Time, Sink % 10);
+	}
+
+}
+
+int main(){
+	bench_node<long, 5>();
+	bench_node<long, 13>();
+	bench_node<long, 29>();
+	bench_node<long, 509>();
+	bench_node<int, 15>();
+	bench_node<int, 61>();
+	bench_node<double, 29>();
+	bench_tree<ronleeon::tree::B_node_cache_line>();
+	bench_tree<ronleeon::tree::B_node_two_lines>();
+	bench_tree<ronleeon::tree::B_node_block>();
+	bench_tree<ronleeon::tree::B_node_page>();
+	return 0;
+}
@@ -0,0 +1,115 @@
+// Compares d_ary_heap with std::priority_queue and with an rb_tree used as a priority queue
+// (insert, then erase its min node), on push/pop, bulk building and a top-k scan.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+#include "ronleeon/heap/d_ary_heap.h"
+#include "ronleeon/tree/rb_tree.h"
+
+namespace{
+
+	template<typename Function>
+	double nanoseconds_per_call(size_t Calls, Function f){
+		auto Start = std::chrono::steady_clock::now();
+		f();
+		std::chrono::duration<double, std::nano> Elapsed = std::chrono::steady_clock::now() - Start;
+		return Elapsed.count() / static_cast<double>(Calls);
+	}
+
+	// std::less without the SIMD child selection.
+	template<typename DataType>
+	struct plain_less{
+		bool operator()(DataType lhs, DataType rhs) const { return lhs < rhs; }
+	};
+
+	template<typename Heap>
+	void bench_heap(const char* Name, const std::vector<typename Heap::value_type>& Data){
+		size_t Sink = 0;
+		Heap h;
+		double PushPop = nanoseconds_per_call(Data.size(), [&]{
+			for(auto Value : Data){
+				h.push(Value);
+			}
+			while(!h.empty()){
+				Sink += static_cast<size_t>(h.top());
+				h.pop();
+			}
+		});
+		double Build = nanoseconds_per_call(Data.size(), [&]{
+			h.heapify(Data.begin(), Data.end());
+		});
+		// the 1000 greatest values.
+		h.clear();
+		double TopK = nanoseconds_per_call(Data.size(), [&]{
+			for(auto Value : Data){
+				if(h.size() < 1000){
+					h.push(Value);
+				}else if(h.top() < Value){
+					h.replace_top(Value);
+				}
+			}
+		});
+		std::printf("%-26s push+pop %6.1f ns, heapify %5.1f ns, top-k %5.1f ns\t[%zu]\n", Name, PushPop, Build, TopK, Sink % 10);
+	}
+
+	void bench_std(const std::vector<long>& Data){
+		size_t Sink = 0;
+		std::priority_queue<long, std::vector<long>, std::greater<long>> h;
+		double PushPop = nanoseconds_per_call(Data.size(), [&]{
+			for(auto Value : Data){
+				h.push(Value);
+			}
+			while(!h.empty()){
+				Sink += static_cast<size_t>(h.top());
+				h.pop();
+			}
+		});
+		double Build = nanoseconds_per_call(Data.size(), [&]{
+			std::priority_queue<long, std::vector<long>, std::greater<long>> Built(Data.begin(), Data.end());
+			Sink += static_cast<size_t>(Built.top());
+		});
+		std::printf("%-26s push+pop %6.1f ns, heapify %5.1f ns\t[%zu]\n", "std::priority_queue", PushPop, Build, Sink % 10);
+	}
+
+	void bench_rb(const std::vector<long>& Data){
+		size_t Sink = 0;
+		ronleeon::tree::rb_tree<long> t;
+		double PushPop = nanoseconds_per_call(Data.size(), [&]{
+			for(auto Value : Data){
+				t.insert(Value);
+			}
+			while(auto Min = t.start()){
+				Sink += static_cast<size_t>(Min->data);
+				t.erase(Min);
+			}
+		});
+		std::printf("%-26s push+pop %6.1f ns (unique keys only)\t[%zu]\n", "rb_tree min node", PushPop, Sink % 10);
+	}
+
+}
+
+int main(){
+	constexpr size_t Size = 1 << 20;
+	std::mt19937_64 gen(42);
+	std::vector<long> Data(Size);
+	for(auto& Value : Data){
+		Value = static_cast<long>(gen() >> 1);
+	}
+	bench_std(Data);
+	bench_rb(Data);
+	bench_heap<ronleeon::heap::d_ary_heap<long, 2>>("d_ary_heap<long, 2>", Data);
+	bench_heap<ronleeon::heap::d_ary_heap<long, 4>>("d_ary_heap<long, 4>", Data);
+	bench_heap<ronleeon::heap::d_ary_heap<long, 8>>("d_ary_heap<long, 8>", Data);
+	// 32-bit priorities, 8 children take two registers.
+	std::vector<int> Ints(Data.size());
+	std::transform(Data.begin(), Data.end(), Ints.begin(), [](long Value){ return static_cast<int>(Value >> 32); });
+	bench_heap<ronleeon::heap::d_ary_heap<int, 4>>("d_ary_heap<int, 4>", Ints);
+	bench_heap<ronleeon::heap::d_ary_heap<int, 8, plain_less<int>>>("d_ary_heap<int, 8> scalar", Ints);
+	bench_heap<ronleeon::heap::d_ary_heap<int, 8>>("d_ary_heap<int, 8> SIMD", Ints);
+	return 0;
+}
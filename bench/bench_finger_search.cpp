@@ -0,0 +1,71 @@
+// A nearly sorted stream into tree_map: insertions and lookups searched from the root, from end()
+// and from the finger of the previous access(see abstract_bs_tree::find_from).
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+#include "ronleeon/tree/tree_map.h"
+
+namespace{
+
+	using Map = ronleeon::tree::tree_map<int, int>;
+	using Pair = ronleeon::tree::pair<int, int>;
+
+	template<typename Function>
+	double milliseconds(Function f){
+		auto Start = std::chrono::steady_clock::now();
+		f();
+		std::chrono::duration<double, std::milli> Elapsed = std::chrono::steady_clock::now() - Start;
+		return Elapsed.count();
+	}
+
+}
+
+int main(){
+	constexpr int Count = 1 << 20;
+	// increasing keys, one in a hundred swapped with a key a few places later.
+	std::mt19937 gen(42);
+	std::vector<int> Keys(Count);
+	for(int Index = 0; Index < Count; ++Index){
+		Keys[Index] = Index * 4;
+	}
+	for(int Index = 0; Index + 8 < Count; ++Index){
+		if(gen() % 100 == 0){
+			std::swap(Keys[Index], Keys[Index + 1 + gen() % 8]);
+		}
+	}
+	Map Root, End, Near;
+	std::printf("insert from the root     %7.1f ms\n", milliseconds([&]{
+		for(int Key : Keys){
+			Root.insert(Pair(Key, Key));
+		}
+	}));
+	std::printf("insert hinted by end()   %7.1f ms\n", milliseconds([&]{
+		for(int Key : Keys){
+			End.insert(End.end(), Pair(Key, Key));
+		}
+	}));
+	std::printf("insert_near              %7.1f ms\n", milliseconds([&]{
+		for(int Key : Keys){
+			Near.insert_near(Pair(Key, Key));
+		}
+	}));
+	long RootSum = 0, NearSum = 0;
+	std::printf("find from the root       %7.1f ms\n", milliseconds([&]{
+		for(int Key : Keys){
+			RootSum += Root.find(Key + (Key & 4 ? 1 : 0)) != Root.end();
+		}
+	}));
+	std::printf("find_near                %7.1f ms\n", milliseconds([&]{
+		for(int Key : Keys){
+			NearSum += Near.find_near(Key + (Key & 4 ? 1 : 0)) != Near.end();
+		}
+	}));
+	if(Root.size() != Count || End.size() != Count || Near.size() != Count || RootSum != NearSum){
+		std::printf("maps differ!\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,119 @@
+// Dijkstra on a random graph with three priority queues: pairing_heap with decrease-key, an rb_tree
+// whose entry is erased and reinserted on every improvement, and a d_ary_heap keeping stale entries.
+
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+#include "ronleeon/heap/d_ary_heap.h"
+#include "ronleeon/heap/pairing_heap.h"
+#include "ronleeon/tree/rb_tree.h"
+
+namespace{
+
+	using Entry = std::pair<long, int>;
+	using Graph = std::vector<std::vector<std::pair<int, int>>>;
+	constexpr long Unreached = std::numeric_limits<long>::max();
+
+	template<typename Function>
+	double milliseconds(Function f){
+		auto Start = std::chrono::steady_clock::now();
+		f();
+		std::chrono::duration<double, std::milli> Elapsed = std::chrono::steady_clock::now() - Start;
+		return Elapsed.count();
+	}
+
+	std::vector<long> dijkstra_pairing(const Graph& Edges){
+		std::vector<long> Dist(Edges.size(), Unreached);
+		ronleeon::heap::pairing_heap<Entry> Queue;
+		std::vector<ronleeon::heap::pairing_heap<Entry>::handle> Handles(Edges.size(), nullptr);
+		std::vector<bool> Done(Edges.size(), false);
+		Dist[0] = 0;
+		Handles[0] = Queue.push({0, 0});
+		while(!Queue.empty()){
+			int From = Queue.extract_top().second;
+			Done[From] = true;
+			for(auto [To, Weight] : Edges[From]){
+				long Through = Dist[From] + Weight;
+				if(Done[To] || Through >= Dist[To]){
+					continue;
+				}
+				Dist[To] = Through;
+				if(Handles[To]){
+					Queue.decrease(Handles[To], {Through, To});
+				}else{
+					Handles[To] = Queue.push({Through, To});
+				}
+			}
+		}
+		return Dist;
+	}
+
+	std::vector<long> dijkstra_rb(const Graph& Edges){
+		std::vector<long> Dist(Edges.size(), Unreached);
+		ronleeon::tree::rb_tree<Entry> Queue;
+		Dist[0] = 0;
+		Queue.insert({0, 0});
+		while(auto Min = Queue.start()){
+			int From = Min->data.second;
+			Queue.erase(Min);
+			for(auto [To, Weight] : Edges[From]){
+				long Through = Dist[From] + Weight;
+				if(Through >= Dist[To]){
+					continue;
+				}
+				if(Dist[To] != Unreached){
+					Queue.erase(Entry(Dist[To], To));
+				}
+				Dist[To] = Through;
+				Queue.insert({Through, To});
+			}
+		}
+		return Dist;
+	}
+
+	std::vector<long> dijkstra_lazy(const Graph& Edges){
+		std::vector<long> Dist(Edges.size(), Unreached);
+		ronleeon::heap::d_ary_heap<Entry, 4> Queue;
+		Dist[0] = 0;
+		Queue.push({0, 0});
+		while(!Queue.empty()){
+			auto [Reached, From] = Queue.extract_top();
+			if(Reached > Dist[From]){
+				continue;
+			}
+			for(auto [To, Weight] : Edges[From]){
+				long Through = Reached + Weight;
+				if(Through < Dist[To]){
+					Dist[To] = Through;
+					Queue.push({Through, To});
+				}
+			}
+		}
+		return Dist;
+	}
+
+}
+
+int main(){
+	constexpr int Vertices = 1 << 18;
+	constexpr int Degree = 8;
+	std::mt19937_64 gen(42);
+	Graph Edges(Vertices);
+	for(auto& Out : Edges){
+		for(int Edge = 0; Edge < Degree; ++Edge){
+			Out.emplace_back(static_cast<int>(gen() % Vertices), static_cast<int>(gen() % 1000));
+		}
+	}
+	std::vector<long> Pairing, Rb, Lazy;
+	std::printf("pairing_heap decrease-key   %7.1f ms\n", milliseconds([&]{ Pairing = dijkstra_pairing(Edges); }));
+	std::printf("rb_tree erase + reinsert    %7.1f ms\n", milliseconds([&]{ Rb = dijkstra_rb(Edges); }));
+	std::printf("d_ary_heap stale entries    %7.1f ms\n", milliseconds([&]{ Lazy = dijkstra_lazy(Edges); }));
+	if(Pairing != Rb || Pairing != Lazy){
+		std::printf("distances differ!\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,87 @@
+// Compares splay_tree with rb_tree on lookups following a Zipf or a uniform distribution,
+// and on a mixed trace of lookups, inserts and erases.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "ronleeon/tree/rb_tree.h"
+#include "ronleeon/tree/splay_tree.h"
+
+namespace{
+
+	template<typename Function>
+	double nanoseconds_per_call(size_t Calls, Function f){
+		auto Start = std::chrono::steady_clock::now();
+		f();
+		std::chrono::duration<double, std::nano> Elapsed = std::chrono::steady_clock::now() - Start;
+		return Elapsed.count() / static_cast<double>(Calls);
+	}
+
+	// Keys of rank r (from 0) are drawn with probability proportional to 1/(r+1)^Skew, ranks are
+	// mapped to shuffled keys so that hot keys are spread over the key space. Skew 0 is uniform.
+	std::vector<long> make_trace(const std::vector<long>& Keys, double Skew, size_t Length, std::mt19937_64& gen){
+		std::vector<double> Cumulative(Keys.size());
+		double Sum = 0;
+		for(size_t Rank = 0; Rank < Keys.size(); ++Rank){
+			Sum += 1 / std::pow(static_cast<double>(Rank + 1), Skew);
+			Cumulative[Rank] = Sum;
+		}
+		std::uniform_real_distribution<double> dist(0, Sum);
+		std::vector<long> Trace(Length);
+		for(auto& Key : Trace){
+			auto Rank = static_cast<size_t>(std::lower_bound(Cumulative.begin(), Cumulative.end(), dist(gen)) - Cumulative.begin());
+			Key = Keys[std::min(Rank, Keys.size() - 1)];
+		}
+		return Trace;
+	}
+
+	template<typename Tree>
+	void bench(const char* Name, const std::vector<long>& Keys, const std::vector<long>& Trace, double Skew){
+		Tree t;
+		for(auto Key : Keys){
+			t.insert(Key);
+		}
+		size_t Sink = 0;
+		double Find = nanoseconds_per_call(Trace.size(), [&]{
+			for(auto Key : Trace){
+				Sink += t.find(Key).second;
+			}
+		});
+		// every 4th access replaces the key by its neighbour, then puts it back.
+		double Mixed = nanoseconds_per_call(Trace.size(), [&]{
+			for(size_t I = 0; I < Trace.size(); ++I){
+				auto Key = Trace[I];
+				if(I % 4 == 3){
+					t.erase(Key);
+					Sink += t.insert(Key + 1).second;
+					t.erase(Key + 1);
+					t.insert(Key);
+				}else{
+					Sink += t.find(Key).second;
+				}
+			}
+		});
+		std::printf("%-10s skew %.2f: find %7.1f ns, mixed %7.1f ns\t[%zu]\n", Name, Skew, Find, Mixed, Sink % 10);
+	}
+
+}
+
+int main(){
+	constexpr size_t Size = 1 << 20;
+	constexpr size_t Length = 1 << 22;
+	std::mt19937_64 gen(42);
+	std::vector<long> Keys(Size);
+	for(size_t I = 0; I < Size; ++I){
+		Keys[I] = static_cast<long>(I * 2);
+	}
+	std::shuffle(Keys.begin(), Keys.end(), gen);
+	for(double Skew : {0.0, 0.99, 1.2}){
+		auto Trace = make_trace(Keys, Skew, Length, gen);
+		bench<ronleeon::tree::rb_tree<long>>("rb_tree", Keys, Trace, Skew);
+		bench<ronleeon::tree::splay_tree<long>>("splay_tree", Keys, Trace, Skew);
+	}
+	return 0;
+}
@@ -0,0 +1,70 @@
+// Compares tree_234 with rb_tree on small keys: inserts, lookups of present and absent keys,
+// erases and an in-order walk.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "ronleeon/tree/rb_tree.h"
+#include "ronleeon/tree/tree_234.h"
+
+namespace{
+
+	template<typename Function>
+	double nanoseconds_per_call(size_t Calls, Function f){
+		auto Start = std::chrono::steady_clock::now();
+		f();
+		std::chrono::duration<double, std::nano> Elapsed = std::chrono::steady_clock::now() - Start;
+		return Elapsed.count() / static_cast<double>(Calls);
+	}
+
+	template<typename Tree>
+	void bench(const char* Name, size_t Size){
+		std::mt19937_64 gen(42);
+		std::vector<long> Data(Size);
+		for(auto& Value : Data){
+			Value = static_cast<long>(gen() % (Size * 4)) * 2;
+		}
+		std::vector<long> Queries(Data);
+		std::shuffle(Queries.begin(), Queries.end(), gen);
+		size_t Sink = 0;
+		Tree t;
+		double Insert = nanoseconds_per_call(Size, [&]{
+			for(auto Value : Data){
+				Sink += t.insert(Value).second;
+			}
+		});
+		double Hit = nanoseconds_per_call(Size, [&]{
+			for(auto Value : Queries){
+				Sink += t.find(Value).second;
+			}
+		});
+		double Miss = nanoseconds_per_call(Size, [&]{
+			for(auto Value : Queries){
+				Sink += t.find(Value + 1).second;
+			}
+		});
+		double Walk = nanoseconds_per_call(t.size(), [&]{
+			for(auto Slot = t.start(); Slot; Slot = Tree::increment(Slot)){
+				Sink += static_cast<size_t>(Slot->data);
+			}
+		});
+		double Erase = nanoseconds_per_call(Size, [&]{
+			for(auto Value : Queries){
+				t.erase(Value);
+			}
+		});
+		std::printf("%-9s %8zu keys: insert %6.1f ns, find hit %6.1f ns, miss %6.1f ns, walk %5.1f ns, erase %6.1f ns\t[%zu]\n"
+			, Name, Size, Insert, Hit, Miss, Walk, Erase, Sink % 10);
+	}
+
+}
+
+int main(){
+	for(size_t Size : {size_t(1) << 10, size_t(1) << 16, size_t(1) << 20}){
+		bench<ronleeon::tree::rb_tree<long>>("rb_tree", Size);
+		bench<ronleeon::tree::tree_234<long>>("tree_234", Size);
+	}
+	return 0;
+}
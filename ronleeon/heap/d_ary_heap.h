@@ -0,0 +1,356 @@
+// Provides an implicit d-ary heap: a complete d-ary tree laid out in an array.
+
+#ifndef RONLEEON_ADT_D_ARY_HEAP_H
+#define RONLEEON_ADT_D_ARY_HEAP_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace ronleeon::heap{
+
+	// Arity 32-bit arithmetic priorities ordered by std::less fill two registers or more, the minimum
+	// among them is then found without branching on the priorities. Measured at a million elements,
+	// children fitting one register or 64-bit priorities(no vector comparison before SSE4.2, four
+	// registers for 8 children) are picked faster by the unrolled scalar loop, so they take it.
+	template<typename DataType, typename Compare, size_t Arity>
+	struct is_simd_min_selectable:std::bool_constant<std::is_arithmetic_v<DataType> && sizeof(DataType) == 4
+		&& (std::is_same_v<Compare, std::less<DataType>> || std::is_same_v<Compare, std::less<>>)
+		&& Arity % 4 == 0 && Arity >= 8>{};
+
+	// index of the lowest set bit of a non-zero mask.
+	inline size_t lowest_lane(unsigned Mask){
+#if defined(__GNUC__)
+		return static_cast<size_t>(__builtin_ctz(Mask));
+#else
+		size_t Lane = 0;
+		for(; !(Mask & 1u); Mask >>= 1){
+			++Lane;
+		}
+		return Lane;
+#endif
+	}
+
+	// Position of the first minimum among Children[0, Count), scalar.
+	template<typename DataType, typename Compare>
+	size_t min_child(const DataType* Children, size_t Count, const Compare& comp){
+		size_t Best = 0;
+		for(size_t Index = 1; Index < Count; ++Index){
+			if(comp(Children[Index], Children[Best])){
+				Best = Index;
+			}
+		}
+		return Best;
+	}
+
+#if defined(__SSE2__)
+	// Position of the first minimum among Children[0, Arity), see is_simd_min_selectable.
+	// The registers are folded into one by vertical minimums, the lanes of that one by shuffles,
+	// then every child is compared with the broadcast minimum. No lane equals it only with NaN,
+	// which is left to the scalar selection.
+	template<typename DataType, size_t Arity>
+	size_t simd_min_child(const DataType* Children){
+		constexpr size_t Registers = Arity / 4;
+		unsigned Mask = 0;
+		if constexpr(std::is_same_v<DataType, float>){
+			__m128 Child[Registers];
+			for(size_t R = 0; R < Registers; ++R){
+				Child[R] = _mm_loadu_ps(Children + R * 4);
+			}
+			__m128 Min = Child[0];
+			for(size_t R = 1; R < Registers; ++R){
+				Min = _mm_min_ps(Min, Child[R]);
+			}
+			Min = _mm_min_ps(Min, _mm_shuffle_ps(Min, Min, _MM_SHUFFLE(2, 3, 0, 1)));
+			Min = _mm_min_ps(Min, _mm_shuffle_ps(Min, Min, _MM_SHUFFLE(1, 0, 3, 2)));
+			for(size_t R = 0; R < Registers; ++R){
+				Mask |= static_cast<unsigned>(_mm_movemask_ps(_mm_cmpeq_ps(Child[R], Min))) << (R * 4);
+			}
+		}else{
+			// unsigned priorities are biased into the signed range,
+			// min(a, b) = a ^ ((a ^ b) & (a > b)).
+			const __m128i Bias = _mm_set1_epi32(std::is_signed_v<DataType> ? 0 : static_cast<int>(0x80000000u));
+			auto Minimum = [](__m128i Lhs, __m128i Rhs){
+				return _mm_xor_si128(Lhs, _mm_and_si128(_mm_xor_si128(Lhs, Rhs), _mm_cmpgt_epi32(Lhs, Rhs)));
+			};
+			__m128i Child[Registers];
+			for(size_t R = 0; R < Registers; ++R){
+				Child[R] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Children + R * 4)), Bias);
+			}
+			__m128i Min = Child[0];
+			for(size_t R = 1; R < Registers; ++R){
+				Min = Minimum(Min, Child[R]);
+			}
+			Min = Minimum(Min, _mm_shuffle_epi32(Min, _MM_SHUFFLE(2, 3, 0, 1)));
+			Min = Minimum(Min, _mm_shuffle_epi32(Min, _MM_SHUFFLE(1, 0, 3, 2)));
+			for(size_t R = 0; R < Registers; ++R){
+				Mask |= static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(Child[R], Min)))) << (R * 4);
+			}
+		}
+		if(!Mask){
+			return min_child(Children, Arity, std::less<DataType>{});
+		}
+		return lowest_lane(Mask);
+	}
+#endif
+
+	// Min-heap (by Compare) of Arity-ary nodes stored level by level in one array: the children of
+	// the i-th element are the elements Arity * i + 1 to Arity * i + Arity. A wider node halves or
+	// thirds the depth of a binary heap, pop compares more children per level but they are contiguous.
+	// 32-bit arithmetic priorities ordered by std::less with Arity of 8 pick the minimum child with SIMD,
+	// the array then starts with Arity - 1 unused slots so that every group of children starts on a
+	// multiple of Arity.
+	template<typename DataType, size_t Arity = 4, typename Compare = std::less<DataType>, typename Allocator = std::allocator<DataType>>
+	class d_ary_heap{
+		static_assert(Arity >= 2, "A heap node must have at least 2 children");
+		static constexpr bool Simd =
+#if defined(__SSE2__)
+			is_simd_min_selectable<DataType, Compare, Arity>::value;
+#else
+			false;
+#endif
+		static constexpr size_t Offset = Simd ? Arity - 1 : 0;
+	public:
+		using value_type = DataType;
+		using allocator_type = Allocator;
+		using const_reference = const DataType&;
+	private:
+		std::vector<DataType, Allocator> _data;
+		Compare comp;
+
+		DataType& at(size_t Index){
+			return _data[Offset + Index];
+		}
+
+		const DataType& at(size_t Index) const {
+			return _data[Offset + Index];
+		}
+
+		static size_t parent(size_t Index){
+			return (Index - 1) / Arity;
+		}
+
+		// the least of the Count children starting at First.
+		size_t least_child(size_t First, size_t Count) const {
+			if(Count == Arity){
+#if defined(__SSE2__)
+				if constexpr(Simd){
+					return First + simd_min_child<DataType, Arity>(&at(First));
+				}
+#endif
+				// a constant count is unrolled.
+				return First + min_child(&at(First), Arity, comp);
+			}
+			return First + min_child(&at(First), Count, comp);
+		}
+
+		// move the element at Hole up to its place.
+		void sift_up(size_t Hole){
+			DataType Value = std::move(at(Hole));
+			while(Hole > 0){
+				size_t Parent = parent(Hole);
+				if(!comp(Value, at(Parent))){
+					break;
+				}
+				at(Hole) = std::move(at(Parent));
+				Hole = Parent;
+			}
+			at(Hole) = std::move(Value);
+		}
+
+		// move the element at Hole down to its place, its subtrees are heaps.
+		void sift_down(size_t Hole){
+			const size_t Size = size();
+			DataType Value = std::move(at(Hole));
+			while(true){
+				size_t First = Arity * Hole + 1;
+				if(First >= Size){
+					break;
+				}
+				size_t Least = least_child(First, std::min(Arity, Size - First));
+				if(!comp(at(Least), Value)){
+					break;
+				}
+				at(Hole) = std::move(at(Least));
+				Hole = Least;
+			}
+			at(Hole) = std::move(Value);
+		}
+
+		// sift_down for an element taken from the bottom level, which mostly goes back there: the hole
+		// follows the least children down to a leaf without comparing them with Value, which is then
+		// sifted up from there (Floyd), saving a comparison per level.
+		void sift_down_to_leaf(size_t Hole, DataType Value){
+			const size_t Size = size();
+			size_t First = Arity * Hole + 1;
+			for(; First + Arity <= Size; First = Arity * Hole + 1){
+				size_t Least = least_child(First, Arity);
+				at(Hole) = std::move(at(Least));
+				Hole = Least;
+			}
+			if(First < Size){
+				size_t Least = least_child(First, Size - First);
+				at(Hole) = std::move(at(Least));
+				Hole = Least;
+			}
+			while(Hole > 0){
+				size_t Parent = parent(Hole);
+				if(!comp(Value, at(Parent))){
+					break;
+				}
+				at(Hole) = std::move(at(Parent));
+				Hole = Parent;
+			}
+			at(Hole) = std::move(Value);
+		}
+
+		// restore the heap once the elements from First on were appended: the ancestors of a range of
+		// positions form a range on every level, they are sifted down level by level from the bottom.
+		// O(k + log(n) * log(k)) for k elements appended to n, O(n) from an empty heap.
+		void heapify_from(size_t First){
+			size_t Last = size();
+			if(Last - First < 2 && First > 0){
+				if(First < Last){
+					sift_up(First);
+				}
+				return;
+			}
+			if(Last < 2){
+				return;
+			}
+			size_t Low = First;
+			size_t High = Last - 1;
+			while(High > 0){
+				High = parent(High);
+				Low = Low > 0 ? parent(Low) : 0;
+				for(size_t Index = High + 1; Index-- > Low;){
+					sift_down(Index);
+				}
+			}
+		}
+
+	public:
+		explicit d_ary_heap(Compare comp_ = Compare{}, const Allocator& alloc = Allocator())
+			:_data(Offset, alloc), comp(comp_){}
+
+		template<typename InputIt>
+		d_ary_heap(InputIt first, InputIt last, Compare comp_ = Compare{}, const Allocator& alloc = Allocator())
+			:d_ary_heap(comp_, alloc){
+			push_batch(first, last);
+		}
+
+		[[nodiscard]] size_t size() const {
+			return _data.size() - Offset;
+		}
+
+		[[nodiscard]] bool empty() const {
+			return size() == 0;
+		}
+
+		allocator_type get_allocator() const {
+			return _data.get_allocator();
+		}
+
+		void reserve(size_t Capacity){
+			_data.reserve(Offset + Capacity);
+		}
+
+		void clear(){
+			_data.resize(Offset);
+		}
+
+		// the least element.
+		const_reference top() const {
+			assert(!empty() && "Empty heap!");
+			return at(0);
+		}
+
+		void push(const DataType& Value){
+			_data.push_back(Value);
+			sift_up(size() - 1);
+		}
+
+		void push(DataType&& Value){
+			_data.push_back(std::move(Value));
+			sift_up(size() - 1);
+		}
+
+		template<typename... Args>
+		void emplace(Args&&... args){
+			_data.emplace_back(std::forward<Args>(args)...);
+			sift_up(size() - 1);
+		}
+
+		// erase the least element.
+		void pop(){
+			assert(!empty() && "Empty heap!");
+			DataType Last = std::move(_data.back());
+			_data.pop_back();
+			if(!empty()){
+				sift_down_to_leaf(0, std::move(Last));
+			}
+		}
+
+		// pop() then push(Value) with one sift, e.g. to keep the k greatest elements seen.
+		void replace_top(DataType Value){
+			assert(!empty() && "Empty heap!");
+			at(0) = std::move(Value);
+			sift_down(0);
+		}
+
+		// take the least element out.
+		DataType extract_top(){
+			assert(!empty() && "Empty heap!");
+			DataType Ret = std::move(at(0));
+			DataType Last = std::move(_data.back());
+			_data.pop_back();
+			if(!empty()){
+				sift_down_to_leaf(0, std::move(Last));
+			}
+			return Ret;
+		}
+
+		// add every element of [first, last) at once, see heapify_from.
+		template<typename InputIt>
+		void push_batch(InputIt first, InputIt last){
+			size_t First = size();
+			_data.insert(_data.end(), first, last);
+			heapify_from(First);
+		}
+
+		// replace the content by the elements of [first, last), in O(n).
+		template<typename InputIt>
+		void heapify(InputIt first, InputIt last){
+			clear();
+			push_batch(first, last);
+		}
+
+		// whether every element is not less than its parent.
+		[[nodiscard]] bool is_heap() const {
+			for(size_t Index = 1; Index < size(); ++Index){
+				if(comp(at(Index), at(parent(Index)))){
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	template<typename DataType, typename Compare = std::less<DataType>, typename Allocator = std::allocator<DataType>>
+	using quaternary_heap = d_ary_heap<DataType, 4, Compare, Allocator>;
+
+	template<typename DataType, typename Compare = std::less<DataType>, typename Allocator = std::allocator<DataType>>
+	using octonary_heap = d_ary_heap<DataType, 8, Compare, Allocator>;
+
+}
+
+#endif
@@ -0,0 +1,295 @@
+// Provides an addressable pairing heap: a node-based heap whose elements are reached back through
+// handles, to change their priority or erase them.
+
+#ifndef RONLEEON_ADT_PAIRING_HEAP_H
+#define RONLEEON_ADT_PAIRING_HEAP_H
+
+#include "ronleeon/tree/node.h"
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ronleeon::heap{
+
+	// Min-heap (by Compare) kept as a heap-ordered tree of any shape (Fredman, Sedgewick, Sleator
+	// and Tarjan): two heaps are melded by making the greater root the leftmost child of the other,
+	// pop pairs up the children of the root left to right then melds the pairs right to left.
+	// push, meld and decrease take O(1), pop and erase O(log n) amortized.
+	// An element keeps its node until it is popped or erased, the handle returned by push stays
+	// valid meanwhile, whatever happens to the other elements.
+	// Allocator is given for DataType (like std containers) and rebound to NodeType, every node of
+	// the heap is created and released through it.
+	template<typename DataType, typename Compare = std::less<DataType>, typename NodeType = node::pairing_node<DataType>
+		, typename Allocator = std::allocator<DataType>>
+	class pairing_heap{
+	public:
+		using value_type = DataType;
+		using const_reference = const DataType&;
+		using node_type = NodeType;
+		// reads the element as `handle->data`.
+		using handle = const NodeType*;
+		using allocator_type = Allocator;
+		using node_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<NodeType>;
+	private:
+		using node_pointer = NodeType*;
+		using node_allocator_traits = std::allocator_traits<node_allocator_type>;
+		static_assert(std::is_same_v<typename node_allocator_traits::pointer, node_pointer>,
+			"Node allocator must hand out raw node pointers");
+
+		node_pointer _root = nullptr;
+		size_t _size = 0;
+		Compare comp;
+		node_allocator_type _alloc;
+
+		template<typename... Args>
+		node_pointer allocate_node(Args&&... args){
+			node_pointer node = node_allocator_traits::allocate(_alloc, 1);
+			try{
+				node_allocator_traits::construct(_alloc, node, std::in_place, std::forward<Args>(args)...);
+			}catch(...){
+				node_allocator_traits::deallocate(_alloc, node, 1);
+				throw;
+			}
+			return node;
+		}
+
+		void deallocate_node(node_pointer node){
+			node_allocator_traits::destroy(_alloc, node);
+			node_allocator_traits::deallocate(_alloc, node, 1);
+		}
+
+		// meld two roots, the greater one becomes the leftmost child of the other which is returned.
+		node_pointer link(node_pointer lhs, node_pointer rhs) const {
+			if(comp(rhs->data, lhs->data)){
+				std::swap(lhs, rhs);
+			}
+			rhs->prev = lhs;
+			rhs->next = lhs->child;
+			if(lhs->child){
+				lhs->child->prev = rhs;
+			}
+			lhs->child = rhs;
+			lhs->prev = lhs->next = nullptr;
+			return lhs;
+		}
+
+		// detach the subtree of a non root node from its parent.
+		static void cut(node_pointer node){
+			if(node->prev->child == node){
+				node->prev->child = node->next;
+			}else{
+				node->prev->next = node->next;
+			}
+			if(node->next){
+				node->next->prev = node->prev;
+			}
+			node->prev = node->next = nullptr;
+		}
+
+		// meld the subtrees of the sibling list starting at first into one, two-pass pairing.
+		// The pairs are stacked through next, so the second pass meets them right to left.
+		node_pointer combine(node_pointer first) const {
+			if(!first){
+				return nullptr;
+			}
+			node_pointer Pairs = nullptr;
+			while(first){
+				node_pointer lhs = first;
+				node_pointer rhs = first->next;
+				if(!rhs){
+					lhs->prev = nullptr;
+					lhs->next = Pairs;
+					Pairs = lhs;
+					break;
+				}
+				first = rhs->next;
+				node_pointer Pair = link(lhs, rhs);
+				Pair->next = Pairs;
+				Pairs = Pair;
+			}
+			node_pointer Root = Pairs;
+			Pairs = Pairs->next;
+			while(Pairs){
+				node_pointer Pair = Pairs;
+				Pairs = Pairs->next;
+				Root = link(Root, Pair);
+			}
+			Root->prev = Root->next = nullptr;
+			return Root;
+		}
+
+		// release the subtree, children lists are spliced ahead of the next nodes to visit
+		// so no stack is needed.
+		void destroy_subtree(node_pointer node){
+			while(node){
+				node_pointer Next = node->next;
+				if(node_pointer Child = node->child){
+					node_pointer Tail = Child;
+					while(Tail->next){
+						Tail = Tail->next;
+					}
+					Tail->next = Next;
+					Next = Child;
+				}
+				deallocate_node(node);
+				node = Next;
+			}
+		}
+
+		template<typename... Args>
+		handle insert_node(Args&&... args){
+			node_pointer node = allocate_node(std::forward<Args>(args)...);
+			_root = _root ? link(_root, node) : node;
+			++_size;
+			return node;
+		}
+
+	public:
+		explicit pairing_heap(Compare comp_ = Compare{}, const Allocator& alloc = Allocator())
+			:comp(comp_), _alloc(alloc){}
+		pairing_heap(const pairing_heap&) = delete;
+		pairing_heap& operator=(const pairing_heap&) = delete;
+		pairing_heap(pairing_heap&& rhs) noexcept
+			:_root(rhs._root), _size(rhs._size), comp(std::move(rhs.comp)), _alloc(std::move(rhs._alloc)){
+			rhs._root = nullptr;
+			rhs._size = 0;
+		}
+
+		~pairing_heap(){
+			clear();
+		}
+
+		[[nodiscard]] size_t size() const {
+			return _size;
+		}
+
+		[[nodiscard]] bool empty() const {
+			return _size == 0;
+		}
+
+		allocator_type get_allocator() const {
+			return allocator_type(_alloc);
+		}
+
+		// the least element.
+		const_reference top() const {
+			assert(_root && "Empty heap!");
+			return _root->data;
+		}
+
+		handle top_handle() const {
+			return _root;
+		}
+
+		handle push(const DataType& Value){
+			return insert_node(Value);
+		}
+
+		handle push(DataType&& Value){
+			return insert_node(std::move(Value));
+		}
+
+		template<typename... Args>
+		handle emplace(Args&&... args){
+			return insert_node(std::forward<Args>(args)...);
+		}
+
+		// erase the least element.
+		void pop(){
+			assert(_root && "Empty heap!");
+			node_pointer Root = _root;
+			_root = combine(Root->child);
+			--_size;
+			deallocate_node(Root);
+		}
+
+		// take the least element out.
+		DataType extract_top(){
+			assert(_root && "Empty heap!");
+			DataType Ret = std::move(_root->data);
+			pop();
+			return Ret;
+		}
+
+		// Give the element of Handle the priority Value, which must not be greater than its current one.
+		// Its subtree is cut and melded with the root.
+		void decrease(handle Handle, DataType Value){
+			auto node = const_cast<node_pointer>(Handle);
+			assert(!comp(node->data, Value) && "Priority is increased!");
+			node->data = std::move(Value);
+			if(node != _root){
+				cut(node);
+				_root = link(_root, node);
+			}
+		}
+
+		// Erase the element of Handle, its children are paired like on pop and melded with the root.
+		void erase(handle Handle){
+			auto node = const_cast<node_pointer>(Handle);
+			if(node == _root){
+				pop();
+				return;
+			}
+			cut(node);
+			if(node_pointer Children = combine(node->child)){
+				_root = link(_root, Children);
+			}
+			--_size;
+			deallocate_node(node);
+		}
+
+		// Move every element of rhs here in O(1), their handles stay valid.
+		// Nodes change owner, so both allocators must compare equal.
+		void meld(pairing_heap& rhs){
+			assert(_alloc == rhs._alloc && "Heaps with unequal allocators can't share nodes");
+			if(this == &rhs || !rhs._root){
+				return;
+			}
+			_root = _root ? link(_root, rhs._root) : rhs._root;
+			_size += rhs._size;
+			rhs._root = nullptr;
+			rhs._size = 0;
+		}
+
+		void meld(pairing_heap&& rhs){
+			meld(rhs);
+		}
+
+		void clear(){
+			destroy_subtree(_root);
+			_root = nullptr;
+			_size = 0;
+		}
+
+		// whether every element is not less than its parent and the links agree.
+		[[nodiscard]] bool is_heap() const {
+			if(!_root){
+				return _size == 0;
+			}
+			if(_root->prev || _root->next){
+				return false;
+			}
+			size_t Count = 0;
+			std::vector<handle> Stack{_root};
+			while(!Stack.empty()){
+				handle node = Stack.back();
+				Stack.pop_back();
+				++Count;
+				handle Prev = node;
+				for(handle Child = node->child; Child; Prev = Child, Child = Child->next){
+					if(Child->prev != Prev || comp(Child->data, node->data)){
+						return false;
+					}
+					Stack.push_back(Child);
+				}
+			}
+			return Count == _size;
+		}
+	};
+
+}
+
+#endif //RONLEEON_ADT_PAIRING_HEAP_H
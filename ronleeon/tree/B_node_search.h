@@ -0,0 +1,154 @@
+// Provides the key search inside a B tree node: a SIMD scan for small nodes of
+// arithmetic keys and a branchless lower bound otherwise.
+
+#ifndef RONLEEON_ADT_B_NODE_SEARCH_H
+#define RONLEEON_ADT_B_NODE_SEARCH_H
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace ronleeon::tree{
+
+	// Nodes whose keys take at most this many bytes are scanned, larger ones are bisected.
+	// A 16 byte register scan only keeps up with the bisection over a few registers.
+#if defined(__AVX2__)
+	inline constexpr size_t B_node_scan_bytes = 512;
+#else
+	inline constexpr size_t B_node_scan_bytes = 64;
+#endif
+
+	// Keys of DataType one instruction compares with the instruction set the code is built for, 0 if none.
+	template<typename DataType>
+	constexpr size_t simd_lanes(){
+#if defined(__AVX2__)
+		return 32 / sizeof(DataType);
+#elif defined(__SSE4_2__)
+		return 16 / sizeof(DataType);
+#elif defined(__SSE2__)
+		// SSE2 has no 64-bit integer comparison, it comes with SSE4.2.
+		return std::is_integral_v<DataType> && sizeof(DataType) == 8 ? 0 : 16 / sizeof(DataType);
+#else
+		return 0;
+#endif
+	}
+
+	// Keys ordered by std::less as plain numbers, so that several of them can be compared at once.
+	template<typename DataType, typename Compare>
+	struct is_simd_searchable:std::bool_constant<std::is_arithmetic_v<DataType> && !std::is_same_v<DataType, bool>
+		&& (sizeof(DataType) == 4 || sizeof(DataType) == 8)
+		&& (std::is_same_v<Compare, std::less<DataType>> || std::is_same_v<Compare, std::less<>>)
+		&& simd_lanes<DataType>() != 0>{};
+
+	// number of set bits of a movemask result, at most 8 lanes.
+	inline size_t count_lanes(unsigned Mask){
+#if defined(__POPCNT__)
+		return static_cast<size_t>(_mm_popcnt_u32(Mask));
+#else
+		constexpr unsigned char Bits[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+		return Bits[Mask & 0xF] + Bits[(Mask >> 4) & 0xF];
+#endif
+	}
+
+	// Number of keys less than Data among the sorted Keys[0, Size), that is their lower bound.
+	// Keys are compared a register at a time and every register is counted, so that the
+	// scan has no data dependent branch, the tail is compared one by one.
+	template<typename DataType>
+	size_t count_less(const DataType* Keys, size_t Size, DataType Data){
+		size_t Index = 0;
+		size_t Count = 0;
+#if defined(__AVX2__)
+		constexpr size_t Lanes = 32 / sizeof(DataType);
+		for(; Index + Lanes <= Size; Index += Lanes){
+			unsigned Mask;
+			if constexpr(std::is_same_v<DataType, float>){
+				Mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(Keys + Index), _mm256_set1_ps(Data), _CMP_LT_OQ));
+			}else if constexpr(std::is_same_v<DataType, double>){
+				Mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(Keys + Index), _mm256_set1_pd(Data), _CMP_LT_OQ));
+			}else if constexpr(sizeof(DataType) == 4){
+				// unsigned keys are biased into the signed range.
+				const __m256i Bias = _mm256_set1_epi32(std::is_signed_v<DataType> ? 0 : static_cast<int>(0x80000000u));
+				__m256i Value = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(Data)), Bias);
+				__m256i Key = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Keys + Index)), Bias);
+				Mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(Value, Key)));
+			}else{
+				const __m256i Bias = _mm256_set1_epi64x(std::is_signed_v<DataType> ? 0 : static_cast<long long>(0x8000000000000000ull));
+				__m256i Value = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(Data)), Bias);
+				__m256i Key = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Keys + Index)), Bias);
+				Mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(Value, Key)));
+			}
+			Count += count_lanes(Mask);
+		}
+#elif defined(__SSE2__)
+		constexpr size_t Lanes = 16 / sizeof(DataType);
+		for(; Index + Lanes <= Size; Index += Lanes){
+			unsigned Mask = 0;
+			if constexpr(std::is_same_v<DataType, float>){
+				Mask = _mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(Keys + Index), _mm_set1_ps(Data)));
+			}else if constexpr(std::is_same_v<DataType, double>){
+				Mask = _mm_movemask_pd(_mm_cmplt_pd(_mm_loadu_pd(Keys + Index), _mm_set1_pd(Data)));
+			}else if constexpr(sizeof(DataType) == 4){
+				const __m128i Bias = _mm_set1_epi32(std::is_signed_v<DataType> ? 0 : static_cast<int>(0x80000000u));
+				__m128i Value = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(Data)), Bias);
+				__m128i Key = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Keys + Index)), Bias);
+				Mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(Value, Key)));
+			}else{
+	#if defined(__SSE4_2__)
+				const __m128i Bias = _mm_set1_epi64x(std::is_signed_v<DataType> ? 0 : static_cast<long long>(0x8000000000000000ull));
+				__m128i Value = _mm_xor_si128(_mm_set1_epi64x(static_cast<long long>(Data)), Bias);
+				__m128i Key = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Keys + Index)), Bias);
+				Mask = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(Value, Key)));
+	#else
+				for(size_t Lane = 0; Lane < Lanes; ++Lane){
+					Mask |= static_cast<unsigned>(Keys[Index + Lane] < Data) << Lane;
+				}
+	#endif
+			}
+			Count += count_lanes(Mask);
+		}
+#endif
+		for(; Index < Size; ++Index){
+			Count += Keys[Index] < Data;
+		}
+		return Count;
+	}
+
+	// Lower bound of Data among the sorted Keys[0, Size), one comparison per probe and
+	// no data dependent branch: the probe only picks which half to keep.
+	template<typename DataType, typename Compare>
+	size_t branchless_lower_bound(const DataType* Keys, size_t Size, const DataType& Data, const Compare& comp){
+		if(Size == 0){
+			return 0;
+		}
+		const DataType* Base = Keys;
+		while(Size > 1){
+			size_t Half = Size / 2;
+			Base = comp(Base[Half], Data) ? Base + Half : Base;
+			Size -= Half;
+		}
+		return static_cast<size_t>(Base - Keys) + (comp(*Base, Data) ? 1 : 0);
+	}
+
+	// Search Data among the first Size keys of a node.
+	// Return the position of Data and true if found, otherwise the position Data would be inserted at and false.
+	// The method is picked at compile time from the key type, the comparator and the node capacity.
+	template<typename DataType, size_t Capacity, typename Compare>
+	std::pair<size_t, bool> B_node_search(const std::array<DataType, Capacity>& Keys, size_t Size, const DataType& Data
+		, const Compare& comp){
+		size_t Position;
+		if constexpr(is_simd_searchable<DataType, Compare>::value && Capacity * sizeof(DataType) <= B_node_scan_bytes){
+			Position = count_less(Keys.data(), Size, Data);
+		}else{
+			Position = branchless_lower_bound(Keys.data(), Size, Data, comp);
+		}
+		return {Position, Position < Size && !comp(Data, Keys[Position])};
+	}
+
+}
+
+#endif
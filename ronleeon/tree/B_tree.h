@@ -4,12 +4,17 @@
 
 #include "ronleeon/tree/node.h"
 #include "ronleeon/tree/abstract_tree.h"
+#include "ronleeon/tree/B_node_search.h"
+#include "ronleeon/tree/B_tree_build.h"
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <limits>
 #include <tuple> 
 #include <cmath>
+#include <vector>
 namespace ronleeon::tree{
 
     template<typename NodeType>
@@ -50,9 +55,9 @@ namespace ronleeon::tree{
     // Thus we can maintain these properties when merging and splitting,
     // Root child number is in [2,m]
     // All leaves are in the same level.
-	template<typename DataType,size_t Size, typename Compare = std::less<DataType>, typename NodeType=node::B_node<DataType, Size>
-        , typename NodePrintTrait = B_node_print_trait<NodeType>>
-	class B_tree_Kruth final:public abstract_tree<DataType,Size,NodeType,B_tree_Kruth<DataType,Size,Compare,NodeType,NodePrintTrait>, NodePrintTrait>{
+	template<typename DataType,size_t Size, typename Compare = std::less<DataType>, typename NodeType=node::split_B_node<DataType, Size>
+        , typename NodePrintTrait = B_node_print_trait<NodeType>, typename Allocator = std::allocator<DataType>>
+	class B_tree_Kruth final:public abstract_tree<DataType,Size,NodeType,B_tree_Kruth<DataType,Size,Compare,NodeType,NodePrintTrait,Allocator>, NodePrintTrait,Allocator>{
     
     private:    
         // minimum size 3.
@@ -62,7 +67,14 @@ namespace ronleeon::tree{
 
         size_t height = 0;// Tree height.
 
-        using basic_type=abstract_tree<DataType,Size,NodeType,B_tree_Kruth<DataType,Size,Compare,NodeType,NodePrintTrait>,NodePrintTrait>;
+        NodeType* detach_nodes() override {
+            height = 0;
+            return basic_type::detach_nodes();
+        }
+
+        using basic_type=abstract_tree<DataType,Size,NodeType,B_tree_Kruth<DataType,Size,Compare,NodeType,NodePrintTrait,Allocator>,NodePrintTrait,Allocator>;
+        // children are reached through node_layout, leaves of split nodes have none.
+        using node_layout = node::B_node_layout<NodeType>;
         // prohibit all create functions.
         using basic_type::create_tree_l;
         using basic_type::create_tree_r;
@@ -79,7 +91,7 @@ namespace ronleeon::tree{
 
     private:
 
-        explicit B_tree_Kruth(std::nullptr_t, Compare comp_ = Compare{}):basic_type(nullptr), comp(comp_){}
+        explicit B_tree_Kruth(std::nullptr_t, Compare comp_ = Compare{}, const Allocator& alloc = Allocator()):basic_type(nullptr, alloc), comp(comp_){}
 
         Compare comp;
 
@@ -95,7 +107,7 @@ namespace ronleeon::tree{
             }
             const_node_pointer tmp=node;
             // see node.h child_begin() and child_end()
-            while(tmp->child_size != 0){
+            while(node_layout::child_size(tmp) != 0){
                 tmp = *(tmp->child_begin());
             }
             return tmp;
@@ -113,51 +125,23 @@ namespace ronleeon::tree{
             }
             const_node_pointer tmp=node;
             // cannot use child_rend() here
-            while(tmp->child_size != 0){
-                tmp = tmp->children[tmp->child_size-1];
+            while(node_layout::child_size(tmp) != 0){
+                tmp = node_layout::child(tmp, node_layout::child_size(tmp)-1);
             }
             return tmp;
         }
 
         
         // Find a data in one node.
-        // Using binary search.
-        //  the first offset denotes the position offset(and the original data will be moved to the right)
-        // Otherwise, return the offset , the second is true.
+        // If found, return its offset and true,
+        // otherwise the first is the position offset(and the original data will be moved to the right).
         // Notice that : offset may be the size which means Data should be pushed back.
+        // see B_node_search.h for how the keys are searched.
         std::pair<size_t,bool> find_in_node(const_node_pointer node,const DataType& Data) const {
             if(!node){
                 return {0,false};
             }
-            if(node->data_size == 0){
-                return {0,false};
-            }
-            size_t Left = 0;
-            size_t Right = node->data_size - 1; // Right >= Left
-            size_t Middle = 0;
-            while(Left<=Right){
-                Middle = Left + (Right - Left) / 2; // avoid overflow
-                if(comp(node->data[Middle],Data)){
-                    // overflow.
-                    if(Middle == std::numeric_limits<size_t>::max()){
-                        break;
-                    }
-                    Left = Middle + 1;
-                }else if(comp(Data,node->data[Middle])){
-                    if(Middle == std::numeric_limits<size_t>::min()){
-                        break;
-                    }
-                    Right = Middle - 1;
-                }else{
-                    return {Middle, true};
-                }
-            }
-            if(comp(node->data[Middle],Data)){
-                return {Middle + 1,false};
-            }else {
-                // comp(Data,data[Middle]) == true.
-                return {Middle,false};
-            }
+            return B_node_search(node->data, node->data_size, Data, comp);
         }
 
         /**
@@ -173,22 +157,22 @@ namespace ronleeon::tree{
             // Avoiding -1. Each index + 1
             for(size_t Index = node->data_size; Index > InsertedPosition; --Index){
                 size_t ActualIndex = Index - 1;
-                node->children[ActualIndex + 2]= node->children[ActualIndex + 1];
+                node_layout::set_child(node, ActualIndex + 2, node_layout::child(node, ActualIndex + 1));
                 node->data[ActualIndex + 1] = node->data[ActualIndex];
             }
             // insert the data.
             node->data[InsertedPosition] = Data;
-            node->children[InsertedPosition + 1] = RChild;
+            node_layout::set_child(node, InsertedPosition + 1, RChild);
             if(RChild){
                 RChild->parent = node;
             }
-            node->children[InsertedPosition] = LChild;
+            node_layout::set_child(node, InsertedPosition, LChild);
             if(LChild){
                 LChild->parent = node;
             }
             ++node->data_size;
             if(!node->is_leaf){
-                ++node->child_size;
+                node_layout::refresh_child_size(node);
             }
         }
 
@@ -201,148 +185,67 @@ namespace ronleeon::tree{
          * 3: Data must be the splitting result the InsertedPosition-th child of this node, thus the splitting result is the tuple (left, right, middle data)
          *      which is also the returned type of splitNode
          * 4:if node is leaf, LChild and RChild is null otherwise they cannot be null.
-         * 5:the original InsertedPosition-th child of node now was splitted before calling splitNode, so the original children[InsertedPosition] must be set to
-         *    null before calling this function, as the function would override it.
-         * 6:like 5, child_size of node must be updated before calling this function as it lost InsertedPosition-th child.
+         * 5:LChild and RChild are the two halves of the original InsertedPosition-th child of node, LChild takes its place
+         *    and RChild follows it.
          */
         [[nodiscard("allocate a new node")]] std::tuple<node_pointer, node_pointer, DataType> insert_full(node_pointer node, 
             const DataType& Data, size_t InsertedPosition,node_pointer LChild, node_pointer RChild){
-            const int UpperCeil = std::ceil(Size / 2.0);
+            const size_t UpperCeil = (Size + 1) / 2;
             // if node cannot be splitted, do nothing.
             if(!node  || InsertedPosition < 0 || InsertedPosition > node->data_size || node->data_size != Size - 1){
                 return {nullptr, nullptr,DataType{}};
             }
-            // else, split the node.
-            // node->data_size == Size - 1.
+            // lay out the m keys and m + 1 children the node would have,
             // range: [0,...,ceil(Size/2) - 2] [ceil(Size/2) - 1] [ceil(Size/2),... Size - 1]
-            // Size >= 3 (at least 3 keys to be splitted)
-            // Compute the middle position.
-            size_t Middle = UpperCeil - 1;// >= 1
-            node_pointer RightNode = new node_type();
-            ++basic_type::num_of_nodes;
-            // firstly fill RightNode.
-            // RightNode has Size - Middle keys.
-            // Avoiding -1. ProcessIndex1InNode is the right of processing node.
-            size_t ProcessIndex1InNode = Size - 1;
-            bool allocateRChild = false;
-            // Avoiding -1. Each index + 1
-            for(size_t Index = Size - Middle - 1;Index > 0;--Index){
-                size_t ActualIndex = Index - 1;
-                // InsertedPosition may be the size of node(that means appending to the last).
-                if(ProcessIndex1InNode == InsertedPosition){
-                    RightNode->data[ActualIndex] = Data;
-                    if(RChild){
-                        RightNode->children[ActualIndex + 1]  = RChild;
-                        RChild->parent = RightNode;
-                    }
-                    allocateRChild = true;
-                    InsertedPosition = Size; // set it to the max, so that this branch will not be executed again.
+            std::array<DataType, Size> Keys;
+            std::array<node_pointer, Size + 1> Children{};
+            for(size_t Index = 0; Index < Size; ++Index){
+                if(Index < InsertedPosition){
+                    Keys[Index] = node->data[Index];
+                }else if(Index == InsertedPosition){
+                    Keys[Index] = Data;
                 }else{
-                    RightNode->data[ActualIndex] = node->data[ProcessIndex1InNode - 1];
-                    if(allocateRChild){
-                        if(LChild){
-                            RightNode->children[ActualIndex + 1]  = LChild;
-                            LChild->parent = RightNode;
-                        }
-                        allocateRChild = false;
-                    }else{
-                        if(node->children[ProcessIndex1InNode]){
-                            RightNode->children[ActualIndex + 1] = node->children[ProcessIndex1InNode];
-                            node->children[ProcessIndex1InNode]->parent = RightNode;
-                        }
-                    }
-                    --ProcessIndex1InNode;
-                }
-            }
-            // OK, now we process RightNode[0], because Child number = Key number + 1
-            if(allocateRChild){
-                if(LChild){
-                    RightNode->children[0]  = LChild;
-                    LChild->parent = RightNode;
-                }
-                allocateRChild = false;
-            }else{
-                if(node->children[ProcessIndex1InNode]){
-                    RightNode->children[0] = node->children[ProcessIndex1InNode];
-                    node->children[ProcessIndex1InNode]->parent = RightNode;
+                    Keys[Index] = node->data[Index - 1];
                 }
             }
-            // Get the middle key.
-            DataType PopData = Data;
-            if(ProcessIndex1InNode == InsertedPosition){
-                InsertedPosition = Size;
-            }else{
-                PopData = node->data[ProcessIndex1InNode - 1];
-                --ProcessIndex1InNode;
-            }
-            // new LeftNode key size is ceil(Size/2) - 1
-            for(size_t Index = Middle;Index > 0;--Index){
-                size_t ActualIndex = Index - 1;
-                if(ProcessIndex1InNode == InsertedPosition){
-                    node->data[ActualIndex] = Data;
-                    if(RChild){
-                        node->children[ActualIndex + 1]  = RChild;
-                        RChild->parent = node;
-                    }else{
-                        node->children[ActualIndex + 1] = nullptr;
-                    }
-                    allocateRChild = true;
-                    InsertedPosition = Size; 
+            for(size_t Index = 0; Index <= Size; ++Index){
+                if(Index < InsertedPosition){
+                    Children[Index] = node_layout::child(node, Index);
+                }else if(Index == InsertedPosition){
+                    Children[Index] = LChild;
+                }else if(Index == InsertedPosition + 1){
+                    Children[Index] = RChild;
                 }else{
-                    node->data[ActualIndex] = node->data[ProcessIndex1InNode - 1];
-                    // allocateRChild may be true when the Data is the middle.
-                    if(allocateRChild){
-                        if(LChild){
-                            node->children[ActualIndex + 1]  = LChild;
-                            LChild->parent = node;
-                        }else{
-                            node->children[ActualIndex + 1] = nullptr;
-                        }
-                        allocateRChild = false;
-                    }else{
-                        if(node->children[ProcessIndex1InNode]){
-                            node->children[ActualIndex + 1]  = node->children[ProcessIndex1InNode];
-                            node->children[ProcessIndex1InNode]->parent = node;
-                        }else{
-                            node->children[ActualIndex + 1] = nullptr;
-                        }
-                    }
-                    --ProcessIndex1InNode;
+                    Children[Index] = node_layout::child(node, Index - 1);
                 }
             }
-            // OK, now we process LightNode[0], because Child number = Key number + 1
-            if(allocateRChild){
-                if(LChild){
-                    node->children[0]  = LChild;
-                    LChild->parent = node;
-                }else{
-                    node->children[0] = nullptr;
+            // Compute the middle position.
+            size_t Middle = UpperCeil - 1;// >= 1
+            // the right half is of the same kind as node.
+            node_pointer RightNode = node->is_leaf ? basic_type::allocate_node() : basic_type::allocate_internal_node();
+            ++basic_type::num_of_nodes;
+            RightNode->is_leaf = node->is_leaf;
+            // new LeftNode key size is ceil(Size/2) - 1, RightNode has Size - ceil(Size/2) keys.
+            for(size_t Index = 0; Index <= Size; ++Index){
+                node_pointer Target = Index <= Middle ? node : RightNode;
+                size_t Position = Index <= Middle ? Index : Index - Middle - 1;
+                if(Index < Size && Index != Middle){
+                    Target->data[Position] = Keys[Index];
                 }
-                allocateRChild = false;
-            }else{
-                if(node->children[ProcessIndex1InNode]){
-                    node->children[0] = node->children[ProcessIndex1InNode];
-                    node->children[ProcessIndex1InNode]->parent = node;// actually ProcessIndex1InNode is 1 here, because we have already dealt with the whole thing.
-                }else{
-                    node->children[0] = nullptr;
+                node_layout::set_child(Target, Position, Children[Index]);
+                if(Children[Index]){
+                    Children[Index]->parent = Target;
                 }
             }
-            // update some fields.
-            if(node->is_leaf){
-                RightNode->is_leaf = true;
-                RightNode->child_size = 0;
-            }else{
-                node->child_size =  Middle + 1;// node as new left node.
-                RightNode->is_leaf = false;
-                RightNode->child_size = Size - UpperCeil + 1;
-            }
-            RightNode->data_size = Size - UpperCeil;
-            node->data_size = Middle;
             // free the extra children avoiding double free.
-            for(size_t Index = node->child_size; Index < Size; ++Index){
-                node->children[Index] = nullptr;
+            for(size_t Index = Middle + 1; Index < Size; ++Index){
+                node_layout::set_child(node, Index, nullptr);
             }
-            return {node, RightNode, PopData};
+            node->data_size = Middle;
+            RightNode->data_size = Size - UpperCeil;
+            node_layout::refresh_child_size(node);
+            node_layout::refresh_child_size(RightNode);
+            return {node, RightNode, Keys[Middle]};
         }
 
         /**
@@ -358,28 +261,28 @@ namespace ronleeon::tree{
             }
             for(size_t Index = ErasePosition; Index < node->data_size - 1; ++Index){
                 if(Index == ErasePosition){
-                    node->children[Index] = child;
+                    node_layout::set_child(node, Index, child);
                     if(child){
                         child->parent = node;
                     }
                 }else{
-                    node->children[Index]= node->children[Index + 1];
+                    node_layout::set_child(node, Index, node_layout::child(node, Index + 1));
                 }
                 node->data[Index] = node->data[Index + 1];
             }
             // process last child
             if(ErasePosition == node->data_size - 1){
-                node->children[node->data_size - 1] = child;
+                node_layout::set_child(node, node->data_size - 1, child);
                 if(child){
                     child->parent = node;
                 }
             }else{
-                node->children[node->data_size - 1] = node->children[node->data_size];
+                node_layout::set_child(node, node->data_size - 1, node_layout::child(node, node->data_size));
             }
-            node->children[node->data_size] = nullptr;
+            node_layout::set_child(node, node->data_size, nullptr);
             --node->data_size;
             if(!node->is_leaf){
-                --node->child_size;
+                node_layout::refresh_child_size(node);
             }
         }
         /**
@@ -393,8 +296,8 @@ namespace ronleeon::tree{
             if(!node || RotatePosition < 0 || RotatePosition >= node->data_size || node->is_leaf){
                 return;
             }
-            auto LChild = node->children[RotatePosition];
-            auto RChild = node->children[RotatePosition + 1];
+            auto LChild = node_layout::child(node, RotatePosition);
+            auto RChild = node_layout::child(node, RotatePosition + 1);
             if(!LChild || !RChild){
                 return;
             }
@@ -408,24 +311,25 @@ namespace ronleeon::tree{
             }
             // LChild adds a new data and a new child.
             LChild->data[LChild->data_size] = node->data[RotatePosition];
-            LChild->children[LChild->child_size + 1] = RChild->children[0];
-            if(RChild->children[0]){
-                RChild->children[0]->parent = LChild;
+            node_layout::set_child(LChild, LChild->data_size + 1, node_layout::child(RChild, 0));
+            if(node_layout::child(RChild, 0)){
+                node_layout::child(RChild, 0)->parent = LChild;
             }
             node->data[RotatePosition] = RChild->data[0];
             // RChild deletes the first data.
             for(size_t Index = 0; Index < RChild->data_size - 1; ++Index){
-                RChild->children[Index] = RChild->children[Index + 1];
+                node_layout::set_child(RChild, Index, node_layout::child(RChild, Index + 1));
                 RChild->data[Index] = RChild->data[Index + 1];
             }
-            RChild->children[RChild->data_size-1] = RChild->children[RChild->data_size];
+            node_layout::set_child(RChild, RChild->data_size-1, node_layout::child(RChild, RChild->data_size));
+            node_layout::set_child(RChild, RChild->data_size, nullptr);
             ++LChild->data_size;
             --RChild->data_size;
             if(!LChild->is_leaf){
-                ++LChild->child_size;
+                node_layout::refresh_child_size(LChild);
             }
             if(!RChild->is_leaf){
-                --RChild->child_size;
+                node_layout::refresh_child_size(RChild);
             }
         }
 
@@ -440,8 +344,8 @@ namespace ronleeon::tree{
             if(!node || RotatePosition < 0 || RotatePosition >= node->data_size || node->is_leaf){
                 return;
             }
-            auto LChild = node->children[RotatePosition];
-            auto RChild = node->children[RotatePosition + 1];
+            auto LChild = node_layout::child(node, RotatePosition);
+            auto RChild = node_layout::child(node, RotatePosition + 1);
             if(!LChild || !RChild){
                 return;
             }
@@ -455,24 +359,25 @@ namespace ronleeon::tree{
             }
             // RChild adds a new data and a new child.
             // RChild move to right.
+            node_layout::set_child(RChild, RChild->data_size + 1, node_layout::child(RChild, RChild->data_size));
             for(size_t Index = RChild->data_size; Index >= 1; --Index){
-                RChild->children[Index] = RChild->children[Index-1];
+                node_layout::set_child(RChild, Index, node_layout::child(RChild, Index-1));
                 RChild->data[Index] = RChild->data[Index-1];
             }
             RChild->data[0] = node->data[RotatePosition];
-            RChild->children[0] = LChild->children[LChild->data_size];
-            if(LChild->children[LChild->data_size]){
-                LChild->children[LChild->data_size]->parent = RChild;
+            node_layout::set_child(RChild, 0, node_layout::child(LChild, LChild->data_size));
+            if(node_layout::child(LChild, LChild->data_size)){
+                node_layout::child(LChild, LChild->data_size)->parent = RChild;
             }
             node->data[RotatePosition] = LChild->data[LChild->data_size - 1];
-            LChild->children[LChild->data_size] = nullptr;
+            node_layout::set_child(LChild, LChild->data_size, nullptr);
             --LChild->data_size;
             ++RChild->data_size;
             if(!LChild->is_leaf){
-                --LChild->child_size;
+                node_layout::refresh_child_size(LChild);
             }
             if(!RChild->is_leaf){
-                ++RChild->child_size;
+                node_layout::refresh_child_size(RChild);
             }
         }
 
@@ -487,8 +392,8 @@ namespace ronleeon::tree{
             if(!node || ErasePosition < 0 || ErasePosition >= node->data_size || node->is_leaf){
                 return nullptr;
             }
-            auto LChild = node->children[ErasePosition];
-            auto RChild = node->children[ErasePosition + 1];
+            auto LChild = node_layout::child(node, ErasePosition);
+            auto RChild = node_layout::child(node, ErasePosition + 1);
             if(!LChild || !RChild){
                 return nullptr;
             }
@@ -496,41 +401,41 @@ namespace ronleeon::tree{
             if(MayOverFlowSum < LChild->data_size){
                 return nullptr;// upper overflow
             }
-            if(MayOverFlowSum >= 2*Size){
+            if(MayOverFlowSum > Size - 1){
                 return nullptr;// cannot merge
             }
             LChild->data[LChild->data_size] = node->data[ErasePosition];
             for(size_t Index = 0; Index < RChild->data_size; ++Index){
                 LChild->data[Index + LChild->data_size + 1] = RChild->data[Index];
-                LChild->children[Index + LChild->data_size + 1] = RChild->children[Index];
-                if(LChild->children[Index]){
-                    LChild->children[Index]->parent = LChild;
+                node_layout::set_child(LChild, Index + LChild->data_size + 1, node_layout::child(RChild, Index));
+                if(node_layout::child(RChild, Index)){
+                    node_layout::child(RChild, Index)->parent = LChild;
                 }
             }
             // last child
-            LChild->children[RChild->data_size + LChild->data_size] = RChild->children[RChild->data_size];
-            if(RChild->children[RChild->data_size]){
-                RChild->children[RChild->data_size]->parent = LChild;
+            node_layout::set_child(LChild, RChild->data_size + LChild->data_size + 1, node_layout::child(RChild, RChild->data_size));
+            if(node_layout::child(RChild, RChild->data_size)){
+                node_layout::child(RChild, RChild->data_size)->parent = LChild;
             }
             // delete the RChild.
-            for(size_t Index = 0; Index < RChild->child_size; ++Index){
-                RChild->children[Index] = nullptr;
+            for(size_t Index = 0; Index < node_layout::child_size(RChild); ++Index){
+                node_layout::set_child(RChild, Index, nullptr);
             }
             LChild->data_size += RChild->data_size + 1;
             if(!LChild->is_leaf){
-                LChild->child_size = LChild->data_size + 1;
+                node_layout::set_child_size(LChild, LChild->data_size + 1);
             }
             // set the two children to nullptr;
-            node->children[ErasePosition] = nullptr;
-            node->children[ErasePosition + 1] = nullptr;
+            node_layout::set_child(node, ErasePosition, nullptr);
+            node_layout::set_child(node, ErasePosition + 1, nullptr);
             erase_directly(node, ErasePosition, LChild);
-            delete RChild;
+            basic_type::deallocate_node(RChild);
             --basic_type::num_of_nodes;
             return LChild;
         }
     public:
         B_tree_Kruth(const B_tree_Kruth&) = delete;
-        explicit B_tree_Kruth(Compare comp_ = Compare{}):B_tree_Kruth(nullptr, comp_){}
+        explicit B_tree_Kruth(Compare comp_ = Compare{}, const Allocator& alloc = Allocator()):B_tree_Kruth(nullptr, comp_, alloc){}
         B_tree_Kruth(B_tree_Kruth && tree) noexcept :basic_type(std::move(tree)) {}
 
         static B_tree_Kruth create_tree(std::istream &in=std::cin) {
@@ -567,7 +472,7 @@ namespace ronleeon::tree{
         // if bool is false, then the first is the node.(also may be null,empty tree), the second is the data inserted position inside the node.
         std::tuple<const_node_pointer,size_t,bool> find(const DataType& data)const{
             if(basic_type::is_empty()){
-                return std::make_tuple(nullptr,typename node_type::const_data_iterator(),false);
+                return {nullptr,0,false};
             }
             const_node_pointer start=basic_type::get_root();
             while(true){
@@ -579,14 +484,14 @@ namespace ronleeon::tree{
                 size_t Offset = FResult.first;
                 if(Offset == start->data_size){
                     // we must search data in the last child
-                    auto NextNode = start->children[Offset];
+                    auto NextNode = node_layout::child(start, Offset);
                     if(NextNode){
                         start = NextNode;
                     }else{
                         return {start, Offset, false};
                     }
                 }else{
-                    auto NextNode = start->children[Offset];
+                    auto NextNode = node_layout::child(start, Offset);
                     if(NextNode){
                         start = NextNode;
                     }else{
@@ -612,13 +517,13 @@ namespace ronleeon::tree{
         std::tuple<const_node_pointer,size_t,bool> insert(const DataType& Data){
             if(basic_type::is_empty()){
                 // empty tree inserted  the data as a root.
-                basic_type::_root=new NodeType();
+                basic_type::_root=basic_type::allocate_node();
                 // the node is either supported O(1) retrieval,
                 // or has an overloaded operator[].
                 basic_type::_root->data[0] = Data;
                 basic_type::num_of_nodes = 1;
                 basic_type::_root->data_size = 1;
-                basic_type::_root->child_size=0;
+                node_layout::set_child_size(basic_type::_root, 0);
                 ++height;
                 return {basic_type::_root,0,true};
             }
@@ -641,7 +546,7 @@ namespace ronleeon::tree{
                 size_t Offset = FindResult.first;
                 if(Offset == start->data_size){
                     // we must search data in the last child
-                    auto NextNode = start->children[Offset];
+                    auto NextNode = node_layout::child(start, Offset);
                     if(NextNode){
                         start = NextNode;
                         LookUpChain.push_back(Offset);
@@ -652,7 +557,7 @@ namespace ronleeon::tree{
                         break;
                     }
                 }else{
-                    auto NextNode = start->children[Offset];
+                    auto NextNode = node_layout::child(start, Offset);
                     if(NextNode){
                         start = NextNode;
                         LookUpChain.push_back(Offset);
@@ -673,7 +578,8 @@ namespace ronleeon::tree{
             // now the node of inserted position is a leaf.
             node_pointer LChild = nullptr;
             node_pointer RChild = nullptr;
-            auto CBegin = LookUpChain.cbegin();
+            // walk the lookup chain back up from the leaf.
+            auto CBegin = LookUpChain.crbegin();
             auto InsertedData = Data;
             while(true){
                 // Case 1: the node has less than m-1 keys, just insert the data without rebalancing the tree.
@@ -692,15 +598,15 @@ namespace ronleeon::tree{
                     LChild = std::get<0>(Tuple);
                     RChild = std::get<1>(Tuple);
                     if(isRoot){
-                        basic_type::_root = new NodeType();
+                        basic_type::_root = basic_type::allocate_internal_node();
                         ++height;
                         basic_type::_root->data[0] = InsertedData;
-                        basic_type::_root->children[0] = LChild;
-                        basic_type::_root->children[1] = RChild;
+                        node_layout::set_child(basic_type::_root, 0, LChild);
+                        node_layout::set_child(basic_type::_root, 1, RChild);
                         LChild->parent = basic_type::_root;
                         RChild->parent = basic_type::_root;
                         basic_type::_root->is_leaf = false;
-                        basic_type::_root->child_size = 2;
+                        node_layout::set_child_size(basic_type::_root, 2);
                         basic_type::_root->data_size = 1;
                         ++basic_type::num_of_nodes;
                         break;
@@ -711,6 +617,11 @@ namespace ronleeon::tree{
                     }
                 }
             }
+            if(LChild){
+                // the leaf was split, the data may have moved to its right half or up.
+                auto Result = this->find(Data);
+                return {std::get<0>(Result), std::get<1>(Result), true};
+            }
             return {BakInsertedNode,BakInsertPosition, true};
         }
 
@@ -750,7 +661,7 @@ namespace ronleeon::tree{
                 size_t Offset = FindResult.first;
                 if(Offset == start->data_size){
                     // we must search data in the last child
-                    auto NextNode = start->children[Offset];
+                    auto NextNode = node_layout::child(start, Offset);
                     if(NextNode){
                         start = NextNode;
                         LookUpChain.push_back(Offset);
@@ -761,7 +672,7 @@ namespace ronleeon::tree{
                         break;
                     }
                 }else{
-                    auto NextNode = start->children[Offset];
+                    auto NextNode = node_layout::child(start, Offset);
                     if(NextNode){
                         start = NextNode;
                         LookUpChain.push_back(Offset);
@@ -780,20 +691,20 @@ namespace ronleeon::tree{
                 // it has two nodes right and left
                 if(left){
                     // replace the data with the left sub tree max data.
-                    node_pointer LeftNode=ErasedNode->children[ErasedPosition];
+                    node_pointer LeftNode=node_layout::child(ErasedNode, ErasedPosition);
                     LookUpChain.push_back(ErasedPosition);
-                    while(LeftNode->child_size != 0){
-                        LookUpChain.push_back(LeftNode->child_size - 1);
-                        LeftNode = LeftNode->children[LeftNode->child_size-1];
+                    while(node_layout::child_size(LeftNode) != 0){
+                        LookUpChain.push_back(node_layout::child_size(LeftNode) - 1);
+                        LeftNode = node_layout::child(LeftNode, node_layout::child_size(LeftNode)-1);
                     }
                     ErasedNode->data[ErasedPosition] = LeftNode->data[LeftNode->data_size - 1];
                     ErasedNode = LeftNode;
                     ErasedPosition = LeftNode->data_size - 1;
                 }else{
                     // replace the data with the right sub tree min data.
-                    node_pointer RightNode=ErasedNode->children[ErasedPosition + 1];
+                    node_pointer RightNode=node_layout::child(ErasedNode, ErasedPosition + 1);
                     LookUpChain.push_back(ErasedPosition + 1);
-                    while(RightNode->child_size != 0){
+                    while(node_layout::child_size(RightNode) != 0){
                         LookUpChain.push_back(0);
                         RightNode = *(RightNode->child_begin());
                     }
@@ -805,7 +716,8 @@ namespace ronleeon::tree{
             size_t UpperCeil = std::ceil(Size / 2.0);
             // Now InsertedNode is a leaf(by definition).
             assert(ErasedNode->is_leaf);
-            auto CBegin = LookUpChain.cbegin();
+            // walk the lookup chain back up from the leaf.
+            auto CBegin = LookUpChain.crbegin();
             if(ErasedNode == basic_type::_root || ErasedNode->data_size > UpperCeil - 1){
                 // just delete the data.
                 erase_directly(ErasedNode, ErasedPosition, nullptr);
@@ -814,9 +726,9 @@ namespace ronleeon::tree{
                     basic_type::num_of_nodes = 0;
                     ErasedNode->parent = nullptr;
                     --height;
-                    ErasedNode->children[0] = nullptr;// it may have one child as its data_size is 0.
+                    node_layout::set_child(ErasedNode, 0, nullptr);// it may have one child as its data_size is 0.
                     // delete the root.                    
-                    delete ErasedNode;
+                    basic_type::deallocate_node(ErasedNode);
                 }
                 return;
             }
@@ -831,8 +743,8 @@ namespace ronleeon::tree{
                 }
                 bool isRoot = ParentNode == basic_type::_root;
                 size_t ChildIndex = *CBegin;
-                bool leftCanBorrow = ChildIndex > 0 && (ParentNode->children[ChildIndex - 1]->data_size > UpperCeil - 1);
-                bool rightCanBorrow = ChildIndex < ParentNode->data_size && ParentNode->children[ChildIndex + 1]->data_size > UpperCeil - 1;
+                bool leftCanBorrow = ChildIndex > 0 && (node_layout::child(ParentNode, ChildIndex - 1)->data_size > UpperCeil - 1);
+                bool rightCanBorrow = ChildIndex < ParentNode->data_size && node_layout::child(ParentNode, ChildIndex + 1)->data_size > UpperCeil - 1;
                 if(leftCanBorrow && (borrowLeft || !rightCanBorrow)){
                     rotate_right(ParentNode,  ChildIndex - 1);
                     break;
@@ -854,21 +766,66 @@ namespace ronleeon::tree{
                     // if parent node is root and have no data, delete it.
                     if(isRoot && ParentNode->data_size == 0){
                         // ParentNode have one child, reset to null
-                        ParentNode->children[0] = nullptr;
+                        node_layout::set_child(ParentNode, 0, nullptr);
                         basic_type::_root = newNode;
                         --height;
                         newNode->parent = nullptr;
                         --basic_type::num_of_nodes;
-                        delete ParentNode;
+                        basic_type::deallocate_node(ParentNode);
                         break;
                     }
                     ErasedNode = ParentNode;
+                    // the merge took a key from the parent, go on only if it is now under the minimum.
+                    if(isRoot || ErasedNode->data_size >= UpperCeil - 1){
+                        break;
+                    }
                     ++CBegin;// if !isRoot then CBegin cannot be in the end.
                 }
             }
             
         }
 
+        /**
+         * @brief replace the content of the tree by the data in [first, last), which must be strictly increasing
+         * and must not be read from this tree.
+         * @param fill_factor the share of the maximum keys every node gets(never less than the minimum),
+         *     leave room(less than 1) if more data will be inserted.
+         * @details
+         * Leaves are filled first and the data between two of them goes up to build the next level, and so on
+         * up to the root, in O(n) without the splits of one insert per data.
+         */
+        template<typename ForwardIt>
+        void build_from_sorted(ForwardIt first, ForwardIt last, double fill_factor = 1.0){
+            assert(std::adjacent_find(first, last, [this](const DataType& lhs, const DataType& rhs){
+                return !comp(lhs, rhs);
+            }) == last && "Data must be strictly increasing");
+            basic_type::destroy();
+            size_t Count = static_cast<size_t>(std::distance(first, last));
+            if(Count == 0){
+                return;
+            }
+            const size_t MinKeys = (Size + 1) / 2 - 1;
+            const size_t MaxKeys = Size - 1;
+            std::vector<DataType> Separators;
+            auto Leaves = build_B_leaves<node_pointer>(first, Count, true, fill_factor, MinKeys, MaxKeys, [this]{
+                ++basic_type::num_of_nodes;
+                return basic_type::allocate_node();
+            }, Separators);
+            height = 1;
+            basic_type::_root = build_B_internal_levels<node_layout>(std::move(Leaves), std::move(Separators), fill_factor
+                , MinKeys, MaxKeys, [this]{
+                    ++basic_type::num_of_nodes;
+                    return basic_type::allocate_internal_node();
+                }, height);
+        }
+
+        // rebuild the tree with every node holding fill_factor of the maximum keys, see build_from_sorted.
+        void compact(double fill_factor = 1.0){
+            std::vector<DataType> Data;
+            collect_B_data<node_layout>(basic_type::_root, Data);
+            build_from_sorted(std::make_move_iterator(Data.begin()), std::make_move_iterator(Data.end()), fill_factor);
+        }
+
         [[nodiscard]] std::string to_string()const override {
             return "<-B Tree->";
         }
@@ -900,9 +857,9 @@ namespace ronleeon::tree{
     // We can merge two nodes even they both have m keys. 
     // Root child number is in [2,2m]
     // All leaves are in the same level.
-	template<typename DataType,size_t Size, typename Compare = std::less<DataType>, typename NodeType=node::B_node<DataType, 2 * Size>
-        , typename NodePrintTrait = B_node_print_trait<NodeType>>
-	class B_tree_Cormen final:public abstract_tree<DataType,Size,NodeType,B_tree_Cormen<DataType,Size,Compare,NodeType,NodePrintTrait>, NodePrintTrait>{
+	template<typename DataType,size_t Size, typename Compare = std::less<DataType>, typename NodeType=node::split_B_node<DataType, 2 * Size>
+        , typename NodePrintTrait = B_node_print_trait<NodeType>, typename Allocator = std::allocator<DataType>>
+	class B_tree_Cormen final:public abstract_tree<DataType,Size,NodeType,B_tree_Cormen<DataType,Size,Compare,NodeType,NodePrintTrait,Allocator>, NodePrintTrait,Allocator>{
     
     private:    
         // minimum size 2.
@@ -912,7 +869,14 @@ namespace ronleeon::tree{
 
         size_t height = 0;
 
-        using basic_type=abstract_tree<DataType,Size,NodeType,B_tree_Cormen<DataType,Size,Compare,NodeType,NodePrintTrait>,NodePrintTrait>;
+        NodeType* detach_nodes() override {
+            height = 0;
+            return basic_type::detach_nodes();
+        }
+
+        using basic_type=abstract_tree<DataType,Size,NodeType,B_tree_Cormen<DataType,Size,Compare,NodeType,NodePrintTrait,Allocator>,NodePrintTrait,Allocator>;
+        // children are reached through node_layout, leaves of split nodes have none.
+        using node_layout = node::B_node_layout<NodeType>;
         // prohibit all create functions.
         using basic_type::create_tree_l;
         using basic_type::create_tree_r;
@@ -929,7 +893,7 @@ namespace ronleeon::tree{
 
     private:
 
-        explicit B_tree_Cormen(std::nullptr_t, Compare comp_ = Compare{}):basic_type(nullptr), comp(comp_){}
+        explicit B_tree_Cormen(std::nullptr_t, Compare comp_ = Compare{}, const Allocator& alloc = Allocator()):basic_type(nullptr, alloc), comp(comp_){}
 
         Compare comp;
 
@@ -945,7 +909,7 @@ namespace ronleeon::tree{
             }
             const_node_pointer tmp=node;
             // see node.h child_begin() and child_end()
-            while(tmp->child_size != 0){
+            while(node_layout::child_size(tmp) != 0){
                 tmp = *(tmp->child_begin());
             }
             return tmp;
@@ -963,51 +927,23 @@ namespace ronleeon::tree{
             }
             const_node_pointer tmp=node;
             // cannot use child_rend() here
-            while(tmp->child_size != 0){
-                tmp = tmp->children[tmp->child_size-1];
+            while(node_layout::child_size(tmp) != 0){
+                tmp = node_layout::child(tmp, node_layout::child_size(tmp)-1);
             }
             return tmp;
         }
 
         
         // Find a data in one node.
-        // Using binary search.
-        //  the first offset denotes the position offset(and the original data will be moved to the right)
-        // Otherwise, return the offset , the second is true.
+        // If found, return its offset and true,
+        // otherwise the first is the position offset(and the original data will be moved to the right).
         // Notice that : offset may be the size which means Data should be pushed back.
+        // see B_node_search.h for how the keys are searched.
         std::pair<size_t,bool> find_in_node(const_node_pointer node,const DataType& Data) const {
             if(!node){
                 return {0,false};
             }
-            if(node->data_size == 0){
-                return {0,false};
-            }
-            size_t Left = 0;
-            size_t Right = node->data_size - 1; // Right >= Left
-            size_t Middle = 0;
-            while(Left<=Right){
-                Middle = Left + (Right - Left) / 2; // avoid overflow
-                if(comp(node->data[Middle],Data)){
-                    // overflow.
-                    if(Middle == std::numeric_limits<size_t>::max()){
-                        break;
-                    }
-                    Left = Middle + 1;
-                }else if(comp(Data,node->data[Middle])){
-                    if(Middle == std::numeric_limits<size_t>::min()){
-                        break;
-                    }
-                    Right = Middle - 1;
-                }else{
-                    return {Middle, true};
-                }
-            }
-            if(comp(node->data[Middle],Data)){
-                return {Middle + 1,false};
-            }else {
-                // comp(Data,data[Middle]) == true.
-                return {Middle,false};
-            }
+            return B_node_search(node->data, node->data_size, Data, comp);
         }
 
         /**
@@ -1023,22 +959,22 @@ namespace ronleeon::tree{
             // Avoiding -1. Each index + 1
             for(size_t Index = node->data_size; Index > InsertedPosition; --Index){
                 size_t ActualIndex = Index - 1;
-                node->children[ActualIndex + 2]= node->children[ActualIndex + 1];
+                node_layout::set_child(node, ActualIndex + 2, node_layout::child(node, ActualIndex + 1));
                 node->data[ActualIndex + 1] = node->data[ActualIndex];
             }
             // insert the data.
             node->data[InsertedPosition] = Data;
-            node->children[InsertedPosition + 1] = RChild;
+            node_layout::set_child(node, InsertedPosition + 1, RChild);
             if(RChild){
                 RChild->parent = node;
             }
-            node->children[InsertedPosition] = LChild;
+            node_layout::set_child(node, InsertedPosition, LChild);
             if(LChild){
                 LChild->parent = node;
             }
             ++node->data_size;
             if(!node->is_leaf){
-                ++node->child_size;
+                node_layout::refresh_child_size(node);
             }
         }
 
@@ -1059,31 +995,32 @@ namespace ronleeon::tree{
             size_t Middle =  Size - 1;
             // Middle data.
             auto PopData = node->data[Middle];
-            node_pointer RightNode = new node_type();
+            // the right half is of the same kind as node.
+            node_pointer RightNode = node->is_leaf ? basic_type::allocate_node() : basic_type::allocate_internal_node();
             ++basic_type::num_of_nodes;
             // Filling the right node
             for(size_t Index = Middle + 1;Index < 2*Size -1;++Index){
                 RightNode->data[Index - Middle - 1] = node->data[Index];
-                RightNode->children[Index - Middle - 1] = node->children[Index];
-                if(node->children[Index]){
-                    node->children[Index]->parent = RightNode;
+                node_layout::set_child(RightNode, Index - Middle - 1, node_layout::child(node, Index));
+                if(node_layout::child(node, Index)){
+                    node_layout::child(node, Index)->parent = RightNode;
                 }
-                node->children[Index] = nullptr;
+                node_layout::set_child(node, Index, nullptr);
             }
             // last child.
-            RightNode->children[Middle] = node->children[2*Size-1];
-            if(node->children[2*Size-1]){
-                node->children[2*Size-1]->parent = RightNode;
+            node_layout::set_child(RightNode, Middle, node_layout::child(node, 2*Size-1));
+            if(node_layout::child(node, 2*Size-1)){
+                node_layout::child(node, 2*Size-1)->parent = RightNode;
             }
-            node->children[2*Size-1] = nullptr;
+            node_layout::set_child(node, 2*Size-1, nullptr);
             // update some fields.
             if(node->is_leaf){
                 RightNode->is_leaf = true;
-                RightNode->child_size = 0;
+                node_layout::set_child_size(RightNode, 0);
             }else{
-                node->child_size =  Middle + 1;// node as new left node.
+                node_layout::set_child_size(node, Middle + 1);// node as new left node.
                 RightNode->is_leaf = false;
-                RightNode->child_size = Middle + 1;
+                node_layout::set_child_size(RightNode, Middle + 1);
             }
             RightNode->data_size = Middle;
             node->data_size = Middle;
@@ -1103,28 +1040,28 @@ namespace ronleeon::tree{
             }
             for(size_t Index = ErasePosition; Index < node->data_size - 1; ++Index){
                 if(Index == ErasePosition){
-                    node->children[Index] = child;
+                    node_layout::set_child(node, Index, child);
                     if(child){
                         child->parent = node;
                     }
                 }else{
-                    node->children[Index]= node->children[Index + 1];
+                    node_layout::set_child(node, Index, node_layout::child(node, Index + 1));
                 }
                 node->data[Index] = node->data[Index + 1];
             }
             // process last child
             if(ErasePosition == node->data_size - 1){
-                node->children[node->data_size - 1] = child;
+                node_layout::set_child(node, node->data_size - 1, child);
                 if(child){
                     child->parent = node;
                 }
             }else{
-                node->children[node->data_size - 1] = node->children[node->data_size];
+                node_layout::set_child(node, node->data_size - 1, node_layout::child(node, node->data_size));
             }
-            node->children[node->data_size] = nullptr;
+            node_layout::set_child(node, node->data_size, nullptr);
             --node->data_size;
             if(!node->is_leaf){
-                --node->child_size;
+                node_layout::refresh_child_size(node);
             }
         }
         /**
@@ -1137,8 +1074,8 @@ namespace ronleeon::tree{
             if(!node || RotatePosition < 0 || RotatePosition >= node->data_size || node->is_leaf){
                 return;
             }
-            auto LChild = node->children[RotatePosition];
-            auto RChild = node->children[RotatePosition + 1];
+            auto LChild = node_layout::child(node, RotatePosition);
+            auto RChild = node_layout::child(node, RotatePosition + 1);
             if(!LChild || !RChild){
                 return;
             }
@@ -1152,24 +1089,25 @@ namespace ronleeon::tree{
             }
             // LChild adds a new data and a new child.
             LChild->data[LChild->data_size] = node->data[RotatePosition];
-            LChild->children[LChild->child_size + 1] = RChild->children[0];
-            if(RChild->children[0]){
-                RChild->children[0]->parent = LChild;
+            node_layout::set_child(LChild, LChild->data_size + 1, node_layout::child(RChild, 0));
+            if(node_layout::child(RChild, 0)){
+                node_layout::child(RChild, 0)->parent = LChild;
             }
             node->data[RotatePosition] = RChild->data[0];
             // RChild deletes the first data.
             for(size_t Index = 0; Index < RChild->data_size - 1; ++Index){
-                RChild->children[Index] = RChild->children[Index + 1];
+                node_layout::set_child(RChild, Index, node_layout::child(RChild, Index + 1));
                 RChild->data[Index] = RChild->data[Index + 1];
             }
-            RChild->children[RChild->data_size-1] = RChild->children[RChild->data_size];
+            node_layout::set_child(RChild, RChild->data_size-1, node_layout::child(RChild, RChild->data_size));
+            node_layout::set_child(RChild, RChild->data_size, nullptr);
             ++LChild->data_size;
             --RChild->data_size;
             if(!LChild->is_leaf){
-                ++LChild->child_size;
+                node_layout::refresh_child_size(LChild);
             }
             if(!RChild->is_leaf){
-                --RChild->child_size;
+                node_layout::refresh_child_size(RChild);
             }
         }
 
@@ -1183,8 +1121,8 @@ namespace ronleeon::tree{
             if(!node || RotatePosition < 0 || RotatePosition >= node->data_size || node->is_leaf){
                 return;
             }
-            auto LChild = node->children[RotatePosition];
-            auto RChild = node->children[RotatePosition + 1];
+            auto LChild = node_layout::child(node, RotatePosition);
+            auto RChild = node_layout::child(node, RotatePosition + 1);
             if(!LChild || !RChild){
                 return;
             }
@@ -1198,24 +1136,25 @@ namespace ronleeon::tree{
             }
             // RChild adds a new data and a new child.
             // RChild move to right.
+            node_layout::set_child(RChild, RChild->data_size + 1, node_layout::child(RChild, RChild->data_size));
             for(size_t Index = RChild->data_size; Index >= 1; --Index){
-                RChild->children[Index] = RChild->children[Index-1];
+                node_layout::set_child(RChild, Index, node_layout::child(RChild, Index-1));
                 RChild->data[Index] = RChild->data[Index-1];
             }
             RChild->data[0] = node->data[RotatePosition];
-            RChild->children[0] = LChild->children[LChild->data_size];
-            if(LChild->children[LChild->data_size]){
-                LChild->children[LChild->data_size]->parent = RChild;
+            node_layout::set_child(RChild, 0, node_layout::child(LChild, LChild->data_size));
+            if(node_layout::child(LChild, LChild->data_size)){
+                node_layout::child(LChild, LChild->data_size)->parent = RChild;
             }
             node->data[RotatePosition] = LChild->data[LChild->data_size - 1];
-            LChild->children[LChild->data_size] = nullptr;
+            node_layout::set_child(LChild, LChild->data_size, nullptr);
             --LChild->data_size;
             ++RChild->data_size;
             if(!LChild->is_leaf){
-                --LChild->child_size;
+                node_layout::refresh_child_size(LChild);
             }
             if(!RChild->is_leaf){
-                ++RChild->child_size;
+                node_layout::refresh_child_size(RChild);
             }
         }
 
@@ -1230,8 +1169,8 @@ namespace ronleeon::tree{
             if(!node || ErasePosition < 0 || ErasePosition >= node->data_size || node->is_leaf){
                 return nullptr;
             }
-            auto LChild = node->children[ErasePosition];
-            auto RChild = node->children[ErasePosition + 1];
+            auto LChild = node_layout::child(node, ErasePosition);
+            auto RChild = node_layout::child(node, ErasePosition + 1);
             if(!LChild || !RChild){
                 return nullptr;
             }
@@ -1245,29 +1184,29 @@ namespace ronleeon::tree{
             LChild->data[LChild->data_size] = node->data[ErasePosition];
             for(size_t Index = 0; Index < RChild->data_size; ++Index){
                 LChild->data[Index + LChild->data_size + 1] = RChild->data[Index];
-                LChild->children[Index + LChild->data_size + 1] = RChild->children[Index];
-                if(RChild->children[Index]){
-                    RChild->children[Index]->parent = LChild;
+                node_layout::set_child(LChild, Index + LChild->data_size + 1, node_layout::child(RChild, Index));
+                if(node_layout::child(RChild, Index)){
+                    node_layout::child(RChild, Index)->parent = LChild;
                 }
             }
             // last child
-            LChild->children[RChild->data_size + LChild->data_size + 1] = RChild->children[RChild->data_size];
-            if(RChild->children[RChild->data_size]){
-                RChild->children[RChild->data_size]->parent = LChild;
+            node_layout::set_child(LChild, RChild->data_size + LChild->data_size + 1, node_layout::child(RChild, RChild->data_size));
+            if(node_layout::child(RChild, RChild->data_size)){
+                node_layout::child(RChild, RChild->data_size)->parent = LChild;
             }
             // delete the RChild.
-            for(size_t Index = 0; Index < RChild->child_size; ++Index){
-                RChild->children[Index] = nullptr;
+            for(size_t Index = 0; Index < node_layout::child_size(RChild); ++Index){
+                node_layout::set_child(RChild, Index, nullptr);
             }
             LChild->data_size += RChild->data_size + 1;
             if(!LChild->is_leaf){
-                LChild->child_size = LChild->data_size + 1;
+                node_layout::set_child_size(LChild, LChild->data_size + 1);
             }
             // set the two children to nullptr;
-            node->children[ErasePosition] = nullptr;
-            node->children[ErasePosition + 1] = nullptr;
+            node_layout::set_child(node, ErasePosition, nullptr);
+            node_layout::set_child(node, ErasePosition + 1, nullptr);
             erase_directly(node, ErasePosition, LChild);
-            delete RChild;
+            basic_type::deallocate_node(RChild);
             --basic_type::num_of_nodes;
             return LChild;
         }
@@ -1284,10 +1223,10 @@ namespace ronleeon::tree{
          * @return the new node who may have the erased data and its child index
          */
         std::pair<node_pointer, size_t> erase_transform(node_pointer parent, size_t Offset, size_t FlagPosition, bool borrowLeft = true, bool mergeLeft = true){
-            if(!parent || Offset < 0 || Offset >= parent->child_size){
+            if(!parent || Offset < 0 || Offset >= node_layout::child_size(parent)){
                 return {nullptr,0};
             }
-            node_pointer node = parent->children[Offset];
+            node_pointer node = node_layout::child(parent, Offset);
             if(!node || node->data_size >= Size || FlagPosition < 0 || FlagPosition > node->data_size){
                 // (more keys) node cannot be processed.
                 return {nullptr,0};
@@ -1295,8 +1234,8 @@ namespace ronleeon::tree{
             size_t newPosition = FlagPosition;
             node_pointer newNode = node;
             // minimum data size.
-            bool leftCanBorrow = Offset > 0 && (parent->children[Offset - 1]->data_size >= Size);
-            bool rightCanBorrow = Offset < parent->data_size && parent->children[Offset + 1]->data_size >= Size;
+            bool leftCanBorrow = Offset > 0 && (node_layout::child(parent, Offset - 1)->data_size >= Size);
+            bool rightCanBorrow = Offset < parent->data_size && node_layout::child(parent, Offset + 1)->data_size >= Size;
             if(leftCanBorrow && (borrowLeft || !rightCanBorrow)){
                 rotate_right(parent,  Offset - 1);
                 newPosition = FlagPosition + 1;
@@ -1312,7 +1251,7 @@ namespace ronleeon::tree{
                 bool isRoot = parent == basic_type::_root;
                 node_pointer mergedNode = nullptr;
                 if(leftCanMerge && (mergeLeft || !rightCanMerge)){
-                    size_t LeftDataSize = parent->children[Offset - 1]->data_size;
+                    size_t LeftDataSize = node_layout::child(parent, Offset - 1)->data_size;
                     mergedNode = merge(parent, Offset - 1);
                     newPosition = FlagPosition + LeftDataSize + 1;
                     newNode = mergedNode;
@@ -1328,8 +1267,8 @@ namespace ronleeon::tree{
                     --height;
                     mergedNode->parent = nullptr;
                     --basic_type::num_of_nodes;
-                    parent->children[0] = nullptr;// it may have one child as its data_size is 0.
-                    delete parent;
+                    node_layout::set_child(parent, 0, nullptr);// it may have one child as its data_size is 0.
+                    basic_type::deallocate_node(parent);
                 }
             }
             return {newNode, newPosition};
@@ -1337,8 +1276,10 @@ namespace ronleeon::tree{
 
     public:
         B_tree_Cormen(const B_tree_Cormen&) = delete;
-        explicit B_tree_Cormen(Compare comp_ = Compare{}):B_tree_Cormen(nullptr, comp_){}
-        B_tree_Cormen(B_tree_Cormen && tree) noexcept :basic_type(std::move(tree)) {}
+        explicit B_tree_Cormen(Compare comp_ = Compare{}, const Allocator& alloc = Allocator()):B_tree_Cormen(nullptr, comp_, alloc){}
+        B_tree_Cormen(B_tree_Cormen && tree) noexcept :basic_type(std::move(tree)), height(tree.height), comp(std::move(tree.comp)) {
+            tree.height = 0;
+        }
 
         static B_tree_Cormen create_tree(std::istream &in=std::cin) {
             B_tree_Cormen tree; 
@@ -1374,7 +1315,7 @@ namespace ronleeon::tree{
         // if bool is false, then the first is the node.(also may be null,empty tree), the second is the data inserted position inside the node.
         std::tuple<const_node_pointer,size_t,bool> find(const DataType& data)const{
             if(basic_type::is_empty()){
-                return std::make_tuple(nullptr,typename node_type::const_data_iterator(),false);
+                return {nullptr,0,false};
             }
             const_node_pointer start=basic_type::get_root();
             while(true){
@@ -1386,14 +1327,14 @@ namespace ronleeon::tree{
                 size_t Offset = FResult.first;
                 if(Offset == start->data_size){
                     // we must search data in the last child
-                    auto NextNode = start->children[Offset];
+                    auto NextNode = node_layout::child(start, Offset);
                     if(NextNode){
                         start = NextNode;
                     }else{
                         return {start, Offset, false};
                     }
                 }else{
-                    auto NextNode = start->children[Offset];
+                    auto NextNode = node_layout::child(start, Offset);
                     if(NextNode){
                         start = NextNode;
                     }else{
@@ -1420,13 +1361,13 @@ namespace ronleeon::tree{
             if(basic_type::is_empty()){
                 ++height;
                 // empty tree inserted  the data as a root.
-                basic_type::_root=new NodeType();
+                basic_type::_root=basic_type::allocate_node();
                 // the node is either supported O(1) retrieval,
                 // or has an overloaded operator[].
                 basic_type::_root->data[0] = Data;
                 basic_type::num_of_nodes = 1;
                 basic_type::_root->data_size = 1;
-                basic_type::_root->child_size=0;
+                node_layout::set_child_size(basic_type::_root, 0);
                 return {basic_type::_root,0,true};
             }
             node_pointer start=const_cast<node_pointer>(basic_type::get_root());
@@ -1436,7 +1377,7 @@ namespace ronleeon::tree{
                 bool split = false;
                 bool find = false;
                 size_t Offset = 0;
-                std::tuple<node_pointer, node_pointer, size_t> SplitTuple;
+                std::tuple<node_pointer, node_pointer, DataType> SplitTuple;
                 if(std::pair<size_t , bool> FindResult = find_in_node(start,Data); FindResult.second){
                     // OK, we find the inserted Data.
                     find = true;
@@ -1444,7 +1385,7 @@ namespace ronleeon::tree{
                 }else{
                     // data is not in find_in_node
                     Offset = FindResult.first;
-                    Bak = start->children[Offset];
+                    Bak = node_layout::child(start, Offset);
                     find = false;
                 }
                 // full node : 2m-1:[m-1,1,m-1]
@@ -1454,15 +1395,15 @@ namespace ronleeon::tree{
                     SplitTuple = split_full(start);
                     split = true;
                     if(isRoot){
-                        basic_type::_root = new NodeType();
+                        basic_type::_root = basic_type::allocate_internal_node();
                         ++height;
                         basic_type::_root->data[0] = std::get<2>(SplitTuple);
-                        basic_type::_root->children[0] = std::get<0>(SplitTuple);
-                        basic_type::_root->children[1] = std::get<1>(SplitTuple);
+                        node_layout::set_child(basic_type::_root, 0, std::get<0>(SplitTuple));
+                        node_layout::set_child(basic_type::_root, 1, std::get<1>(SplitTuple));
                         std::get<0>(SplitTuple)->parent = basic_type::_root;
                         std::get<1>(SplitTuple)->parent = basic_type::_root;
                         basic_type::_root->is_leaf = false;
-                        basic_type::_root->child_size = 2;
+                        node_layout::set_child_size(basic_type::_root, 2);
                         basic_type::_root->data_size = 1;
                         ++basic_type::num_of_nodes;
                         // update Offset.
@@ -1473,6 +1414,16 @@ namespace ronleeon::tree{
 
                 }
                 if(find){
+                    if(split){
+                        // the data is either the middle one moved up, or in one of the two halves.
+                        if(Offset == Size - 1){
+                            node_pointer Parent = std::get<0>(SplitTuple)->parent;
+                            return {Parent, find_in_node(Parent, Data).first, false};
+                        }
+                        if(Offset > Size - 1){
+                            return {std::get<1>(SplitTuple), Offset - Size, false};
+                        }
+                    }
                     return {start, Offset, false}; 
                 }
                 if(!Bak){
@@ -1496,7 +1447,8 @@ namespace ronleeon::tree{
                     }
                 }else{
                     start = Bak;
-                    BakPosition = Offset;
+                    // after a split, the right half holds the children from Size on.
+                    BakPosition = split && Offset > Size - 1 ? Offset - Size : Offset;
                     // continue loop.
                 }
             }
@@ -1509,125 +1461,122 @@ namespace ronleeon::tree{
          * @param left Whether to replace the internal deleted data with its left sub tree max data.
          * @param borrowLeft Whether to borrow the data from the left sibling(if allowed).
          * @param mergeLeft Whether to merge the node with its left sibling(if allowed).
+         * @return whether the data was found and erased.
          * @details
          * According to Wiki @a https://en.wikipedia.org/wiki/B-tree
          * By this definition of B tree 
          * after transform the deleted data with a leaf data, we got the inserted data on a leaf.
          * when finding the deleted position, merge or rotate the nodes with the minimum keys encountered, and merge will ensure its parent 
          * having not less than the minimum keys, in this case, if the erased data is in a leaf we just need one traversal.
-         * If the erased data is in an internal node, we still need another a small traversal to
-         * find its sub left max or sub right min data.
+         * If the erased data is in an internal node, it is replaced with its sub left max or sub right min data
+         * (or moved down by a merge) and the same traversal goes on erasing that data.
          */
-        void erase(const DataType& Data,bool left = true, bool borrowLeft = true, bool mergeLeft = true){
+        bool erase(const DataType& Data,bool left = true, bool borrowLeft = true, bool mergeLeft = true){
             if(basic_type::is_empty()){
-                return;
+                return false;
             }
-            node_pointer ErasedNode = const_cast<node_pointer>(basic_type::get_root());
-            size_t ErasedPosition = 0;
-            bool find = false;
-            node_pointer Bak = nullptr;
-            size_t FlagPosition = 0;
-            size_t ChildIndex = 0;
+            node_pointer ErasedNode = basic_type::_root;
+            // the key still to be erased, once an internal key is replaced it becomes its predecessor(or successor).
+            DataType Key = Data;
+            bool Erased = false;
             while(true){
-                std::pair<size_t , bool> FindResult = find_in_node(ErasedNode,Data);
-                ErasedPosition = FindResult.first;
-                find = FindResult.second;
-                FlagPosition = ErasedPosition;
-                // first transform if needed.
-                if(ErasedNode->data_size < Size && ErasedNode != basic_type::_root){
-                    // ROOT cannot be here.
-                    auto Pair = erase_transform(ErasedNode->parent, ChildIndex, FlagPosition, borrowLeft, mergeLeft);
-                    ErasedNode = Pair.first;
-                    FlagPosition = Pair.second;
-                    ChildIndex = FlagPosition;
-                    Bak = ErasedNode->children[ChildIndex];
-                }else{
-                    ChildIndex = ErasedPosition;
-                    Bak =  ErasedNode->children[ErasedPosition];
-                }
-                if(find || !Bak){
-                    // find the erased data position OR reach the leaf node and still not find the data.
+                auto [ErasedPosition, find] = find_in_node(ErasedNode, Key);
+                Erased = Erased || find;
+                if(ErasedNode->is_leaf){
+                    if(find){
+                        erase_directly(ErasedNode, ErasedPosition, nullptr);
+                    }
                     break;
                 }
-                ErasedNode = Bak;
-            }
-            if(!find){
-                // still not found the erased data.
-                return;
-            }
-            // ErasedNode is an internal node
-            // Extra traversal
-            if(!ErasedNode->is_leaf){
-                // it has two nodes right and left
-                if(left){
-                    // replace the data with the left sub tree max data.
-                    node_pointer LeftNode=ErasedNode->children[ErasedPosition];
-                    while(LeftNode->child_size != 0){
-                        LeftNode = LeftNode->children[LeftNode->child_size-1];
-                    }
-                    ErasedNode->data[ErasedPosition] = LeftNode->data[LeftNode->data_size - 1];
-                    LeftNode=ErasedNode->children[ErasedPosition];
-                    node_pointer Parent = ErasedNode;
-                    size_t NextChildPosition = LeftNode->data_size;// right after the last child
-                    while(LeftNode){
-                        if(LeftNode->data_size < Size){
-                            auto Pair = erase_transform(Parent, ErasedPosition, NextChildPosition, borrowLeft, mergeLeft);
-                            Parent = Pair.first;
-                            ErasedPosition = Pair.second; 
-                            LeftNode = Parent->children[ErasedPosition];
-                            NextChildPosition = ErasedPosition;
-                        }else{
-                            Parent = LeftNode;
-                            ErasedPosition = LeftNode->data_size;
-                            LeftNode = LeftNode->children[ErasedPosition];
-                            NextChildPosition = ErasedPosition;
-                        }
-                    }
-                    // simple erase it 
-                    erase_directly(Parent, NextChildPosition - 1, nullptr);
-                }else{
-                    // replace the data with the right sub tree min data.
-                    node_pointer RightNode=ErasedNode->children[ErasedPosition + 1];
-                    while(RightNode->child_size != 0){
-                        RightNode = RightNode->children[0];
-                    }
-                    ErasedNode->data[ErasedPosition] = RightNode->data[0];
-                    // replace the data with the right sub tree min data.
-                    RightNode=ErasedNode->children[ErasedPosition + 1];
-                    node_pointer Parent = ErasedNode;
-                    size_t ChildIndex = ErasedPosition + 1;
-                    size_t NextChildPosition = 0;
-                    // process including leaf node.
-                    while(RightNode){
-                        if(RightNode->data_size < Size){
-                            auto Pair = erase_transform(Parent, ChildIndex, NextChildPosition, borrowLeft, mergeLeft);
-                            Parent = Pair.first;
-                            ChildIndex = Pair.second; 
-                            RightNode = Parent->children[ChildIndex];
-                            NextChildPosition = ChildIndex;
-                        }else{
-                            NextChildPosition = 0;
-                            Parent = RightNode;
-                            ChildIndex = 0;
-                            RightNode = RightNode->children[0];
+                node_pointer LChild = node_layout::child(ErasedNode, ErasedPosition);
+                if(find){
+                    node_pointer RChild = node_layout::child(ErasedNode, ErasedPosition + 1);
+                    bool leftCanGive = LChild->data_size >= Size;
+                    bool rightCanGive = RChild->data_size >= Size;
+                    if(leftCanGive && (left || !rightCanGive)){
+                        // replace the data with the left sub tree max data, then erase that one.
+                        const_node_pointer Max = right_most(LChild);
+                        Key = Max->data[Max->data_size - 1];
+                        ErasedNode->data[ErasedPosition] = Key;
+                        ErasedNode = LChild;
+                    }else if(rightCanGive){
+                        // replace the data with the right sub tree min data, then erase that one.
+                        Key = left_most(RChild)->data[0];
+                        ErasedNode->data[ErasedPosition] = Key;
+                        ErasedNode = RChild;
+                    }else{
+                        // both children have the minimum keys, the data moves down into the merged node.
+                        bool isRoot = ErasedNode == basic_type::_root;
+                        node_pointer mergedNode = merge(ErasedNode, ErasedPosition);
+                        assert(mergedNode != nullptr);
+                        if(isRoot && ErasedNode->data_size == 0){
+                            basic_type::_root = mergedNode;
+                            --height;
+                            mergedNode->parent = nullptr;
+                            --basic_type::num_of_nodes;
+                            node_layout::set_child(ErasedNode, 0, nullptr);
+                            basic_type::deallocate_node(ErasedNode);
                         }
+                        ErasedNode = mergedNode;
                     }
-                    // simple erase it
-                    erase_directly(Parent, NextChildPosition, nullptr);
+                    continue;
                 }
-            }else{
-                erase_directly(ErasedNode, FlagPosition, nullptr);
-                // if the node is root, we need judge whether it is empty.
-                // if parent node is root and have no data, delete it.
-                if(ErasedNode == basic_type::_root && ErasedNode->data_size == 0){
-                    basic_type::_root = nullptr;
-                    ErasedNode->parent = nullptr;
-                    basic_type::num_of_nodes = 0;
-                    --height;
-                    ErasedNode->children[0] = nullptr;// it may have one child as its data_size is 0.
-                    delete ErasedNode;
+                // make sure the next node has more than the minimum keys before going down.
+                if(LChild->data_size < Size){
+                    LChild = erase_transform(ErasedNode, ErasedPosition, 0, borrowLeft, mergeLeft).first;
                 }
+                ErasedNode = LChild;
+            }
+            // if the root is a leaf without data, delete it.
+            node_pointer Root = basic_type::_root;
+            if(Root->is_leaf && Root->data_size == 0){
+                basic_type::_root = nullptr;
+                basic_type::num_of_nodes = 0;
+                height = 0;
+                basic_type::deallocate_node(Root);
+            }
+            return Erased;
+        }
+
+        /**
+         * @brief replace the content of the tree by the data in [first, last), which must be strictly increasing
+         * and must not be read from this tree.
+         * @param fill_factor the share of the maximum keys every node gets(never less than the minimum),
+         *     leave room(less than 1) if more data will be inserted.
+         * @details
+         * Leaves are filled first and the data between two of them goes up to build the next level, and so on
+         * up to the root, in O(n) without the splits of one insert per data.
+         */
+        template<typename ForwardIt>
+        void build_from_sorted(ForwardIt first, ForwardIt last, double fill_factor = 1.0){
+            assert(std::adjacent_find(first, last, [this](const DataType& lhs, const DataType& rhs){
+                return !comp(lhs, rhs);
+            }) == last && "Data must be strictly increasing");
+            basic_type::destroy();
+            size_t Count = static_cast<size_t>(std::distance(first, last));
+            if(Count == 0){
+                return;
             }
+            const size_t MinKeys = Size - 1;
+            const size_t MaxKeys = 2 * Size - 1;
+            std::vector<DataType> Separators;
+            auto Leaves = build_B_leaves<node_pointer>(first, Count, true, fill_factor, MinKeys, MaxKeys, [this]{
+                ++basic_type::num_of_nodes;
+                return basic_type::allocate_node();
+            }, Separators);
+            height = 1;
+            basic_type::_root = build_B_internal_levels<node_layout>(std::move(Leaves), std::move(Separators), fill_factor
+                , MinKeys, MaxKeys, [this]{
+                    ++basic_type::num_of_nodes;
+                    return basic_type::allocate_internal_node();
+                }, height);
+        }
+
+        // rebuild the tree with every node holding fill_factor of the maximum keys, see build_from_sorted.
+        void compact(double fill_factor = 1.0){
+            std::vector<DataType> Data;
+            collect_B_data<node_layout>(basic_type::_root, Data);
+            build_from_sorted(std::make_move_iterator(Data.begin()), std::make_move_iterator(Data.end()), fill_factor);
         }
 
         [[nodiscard]] std::string to_string()const override {
@@ -1649,6 +1598,32 @@ namespace ronleeon::tree{
             return find_result->data[find_result->data_size - 1];
         }
     };
+
+    // Node sizes B_tree_auto can aim at: one cache line, two or four of them, or a page.
+    inline constexpr size_t B_node_cache_line = 64;
+    inline constexpr size_t B_node_two_lines = 128;
+    inline constexpr size_t B_node_block = 256;
+    inline constexpr size_t B_node_page = 4096;
+
+    // Minimum degree m of a B_tree_Cormen whose leaves, 2m - 1 keys followed by data_size, is_leaf
+    // and parent, fit in NodeBytes (at least 2, so very large keys may overflow it).
+    template<typename DataType, size_t NodeBytes>
+    struct B_auto_degree{
+        static constexpr size_t header = sizeof(size_t) + alignof(void*) + sizeof(void*);
+        static constexpr size_t keys = NodeBytes > header ? (NodeBytes - header) / sizeof(DataType) : 0;
+        static constexpr size_t value = keys >= 3 ? (keys + 1) / 2 : 2;
+    };
+
+    // B tree whose fanout is derived from the key size so that a node fills NodeBytes.
+    // Nodes are cache line aligned with their keys first, so a lookup on 8-byte keys reads one line
+    // per level with 64 byte nodes and at most two with the default 128 byte ones(13 keys), while
+    // 256 byte nodes spread their 29 keys over four lines.
+    template<typename DataType, size_t NodeBytes = B_node_two_lines, typename Compare = std::less<DataType>
+        , typename Allocator = std::allocator<DataType>>
+    using B_tree_auto = B_tree_Cormen<DataType, B_auto_degree<DataType, NodeBytes>::value, Compare
+        , node::split_B_node<DataType, 2 * B_auto_degree<DataType, NodeBytes>::value, B_node_cache_line>
+        , B_node_print_trait<node::split_B_node<DataType, 2 * B_auto_degree<DataType, NodeBytes>::value, B_node_cache_line>>
+        , Allocator>;
 }
 
 
@@ -0,0 +1,137 @@
+// Provides the bottom-up construction of B trees and B+ trees from sorted data:
+// nodes are filled level by level from the leaves up, in O(n).
+
+#ifndef RONLEEON_ADT_B_TREE_BUILD_H
+#define RONLEEON_ADT_B_TREE_BUILD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace ronleeon::tree{
+
+	// How a level of a tree built bottom-up shares out its keys: `count` nodes, the first
+	// `extra` of them get base + 1 keys and the others `base`.
+	// In a B tree level, like in a B+ internal level, one key sits between two neighbour nodes
+	// and goes up to the parent level, B+ leaves keep all their data and only copy one up.
+	struct B_level_layout{
+		size_t count = 0;
+		size_t base = 0;
+		size_t extra = 0;
+
+		// Keys keys shared by nodes of about Target keys, within [MinKeys, MaxKeys] unless there is a single node(the root).
+		B_level_layout(size_t Keys, bool KeysBetween, size_t Target, size_t MinKeys, size_t MaxKeys){
+			size_t Gap = KeysBetween ? 1 : 0;
+			// Keys + Gap = sum of (keys of a node + Gap).
+			size_t Total = Keys + Gap;
+			count = (Total + Target + Gap - 1) / (Target + Gap);
+			count = std::max(count, (Total + MaxKeys + Gap - 1) / (MaxKeys + Gap));
+			count = std::min(count, std::max<size_t>(Total / (MinKeys + Gap), 1));
+			size_t Stored = Keys - (count - 1) * Gap;
+			base = Stored / count;
+			extra = Stored % count;
+		}
+
+		[[nodiscard]] size_t keys_of(size_t Index) const {
+			return base + (Index < extra ? 1 : 0);
+		}
+
+		// keys per node aimed at for a fill factor in (0, 1].
+		static size_t target(double FillFactor, size_t MinKeys, size_t MaxKeys){
+			auto Keys = static_cast<size_t>(std::max(std::lround(FillFactor * static_cast<double>(MaxKeys)), 0L));
+			return std::clamp(Keys, std::max<size_t>(MinKeys, 1), MaxKeys);
+		}
+	};
+
+	// Fill the leaves with the Count sorted data read from first.
+	// With KeysBetween(B tree) the data between two leaves is moved to Separators,
+	// otherwise(B+ tree) the first data of every leaf but the first one is copied there.
+	template<typename NodePointer, typename DataType, typename ForwardIt, typename AllocateLeaf>
+	std::vector<NodePointer> build_B_leaves(ForwardIt first, size_t Count, bool KeysBetween, double FillFactor
+		, size_t MinKeys, size_t MaxKeys, AllocateLeaf allocate_leaf, std::vector<DataType>& Separators){
+		B_level_layout Layout(Count, KeysBetween, B_level_layout::target(FillFactor, MinKeys, MaxKeys), MinKeys, MaxKeys);
+		std::vector<NodePointer> Leaves;
+		Leaves.reserve(Layout.count);
+		Separators.reserve(Layout.count - 1);
+		for(size_t Index = 0; Index < Layout.count; ++Index){
+			if(Index > 0 && KeysBetween){
+				Separators.push_back(*first);
+				++first;
+			}
+			NodePointer Leaf = allocate_leaf();
+			size_t Keys = Layout.keys_of(Index);
+			for(size_t Key = 0; Key < Keys; ++Key, ++first){
+				Leaf->data[Key] = *first;
+			}
+			Leaf->data_size = Keys;
+			if(Index > 0 && !KeysBetween){
+				Separators.push_back(Leaf->data[0]);
+			}
+			Leaves.push_back(Leaf);
+		}
+		return Leaves;
+	}
+
+	// Build the internal levels above Nodes, a level in order with Separators[i] between Nodes[i]
+	// and Nodes[i + 1], up to a single node which is returned as the root.
+	// allocate_internal() hands out an empty internal node, Levels is increased by the number of levels added.
+	template<typename NodeLayout, typename NodePointer, typename DataType, typename AllocateInternal>
+	NodePointer build_B_internal_levels(std::vector<NodePointer> Nodes, std::vector<DataType> Separators, double FillFactor
+		, size_t MinKeys, size_t MaxKeys, AllocateInternal allocate_internal, size_t& Levels){
+		size_t Target = B_level_layout::target(FillFactor, MinKeys, MaxKeys);
+		while(Nodes.size() > 1){
+			B_level_layout Layout(Separators.size(), true, Target, MinKeys, MaxKeys);
+			std::vector<NodePointer> Parents;
+			std::vector<DataType> UpSeparators;
+			Parents.reserve(Layout.count);
+			UpSeparators.reserve(Layout.count - 1);
+			// the first child of the next parent.
+			size_t First = 0;
+			for(size_t Index = 0; Index < Layout.count; ++Index){
+				NodePointer Parent = allocate_internal();
+				Parent->is_leaf = false;
+				size_t Keys = Layout.keys_of(Index);
+				for(size_t Key = 0; Key <= Keys; ++Key){
+					NodeLayout::set_child(Parent, Key, Nodes[First + Key]);
+					Nodes[First + Key]->parent = Parent;
+					if(Key < Keys){
+						Parent->data[Key] = std::move(Separators[First + Key]);
+					}
+				}
+				Parent->data_size = Keys;
+				NodeLayout::refresh_child_size(Parent);
+				if(Index + 1 < Layout.count){
+					UpSeparators.push_back(std::move(Separators[First + Keys]));
+				}
+				First += Keys + 1;
+				Parents.push_back(Parent);
+			}
+			Nodes = std::move(Parents);
+			Separators = std::move(UpSeparators);
+			++Levels;
+		}
+		return Nodes.front();
+	}
+
+	// Move the data of the B tree rooted at node to Data in order(the recursion is as deep as the tree).
+	template<typename NodeLayout, typename NodePointer, typename DataType>
+	void collect_B_data(NodePointer node, std::vector<DataType>& Data){
+		if(!node){
+			return;
+		}
+		for(size_t Index = 0; Index < node->data_size; ++Index){
+			if(!node->is_leaf){
+				collect_B_data<NodeLayout>(NodeLayout::child(node, Index), Data);
+			}
+			Data.push_back(std::move(node->data[Index]));
+		}
+		if(!node->is_leaf){
+			collect_B_data<NodeLayout>(NodeLayout::child(node, node->data_size), Data);
+		}
+	}
+
+}
+
+#endif
@@ -0,0 +1,643 @@
+#ifndef RONLEEON_ADT_BPLUS_TREE_H
+#define RONLEEON_ADT_BPLUS_TREE_H
+
+
+#include "ronleeon/tree/node.h"
+#include "ronleeon/tree/abstract_tree.h"
+#include "ronleeon/tree/B_tree.h"
+#include "ronleeon/tree/B_node_search.h"
+#include "ronleeon/tree/B_tree_build.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <vector>
+namespace ronleeon::tree{
+
+    // m-order B+ tree, the degree is defined as in B_tree_Cormen:
+    // m means least child number, 2m means most child number
+    // node child number except root node/leaf nodes is in [m, 2m]
+    // Unlike B tree, all data lives in the leaves, each of them has [m - 1, 2m - 1] keys(except the root leaf),
+    // the keys of internal nodes are only separators: the i-th child holds the data in [data[i - 1], data[i]).
+    // Leaves are linked in order through Pre and Next, so a range is read along the leaf chain
+    // after a single descent.
+    // All leaves are in the same level.
+    template<typename DataType,size_t Size, typename Compare = std::less<DataType>, typename NodeType=node::Bplus_node<DataType, 2 * Size>
+        , typename NodePrintTrait = B_node_print_trait<NodeType>, typename Allocator = std::allocator<DataType>>
+    class Bplus_tree final:public abstract_tree<DataType,Size,NodeType,Bplus_tree<DataType,Size,Compare,NodeType,NodePrintTrait,Allocator>, NodePrintTrait,Allocator>{
+
+    private:
+        // minimum size 2.
+        // child [2,4]
+        // key [1,3]
+        static_assert(Size >= 2);
+
+        size_t height = 0;
+
+        NodeType* detach_nodes() override {
+            height = 0;
+            return basic_type::detach_nodes();
+        }
+
+        using basic_type=abstract_tree<DataType,Size,NodeType,Bplus_tree<DataType,Size,Compare,NodeType,NodePrintTrait,Allocator>,NodePrintTrait,Allocator>;
+        using node_layout = node::B_node_layout<NodeType>;
+        // prohibit all create functions.
+        using basic_type::create_tree_l;
+        using basic_type::create_tree_r;
+        using basic_type::shift_height;
+    public:
+        using node_type = NodeType;
+        using node_pointer = NodeType*;
+        using node_type_reference = NodeType&;
+        using const_node_type = const NodeType;
+        using const_node_pointer = const NodeType*;
+        using const_node_type_reference = const NodeType&;
+
+        using PrintTrait = typename basic_type::PrintTrait;
+
+        // Iterates the data in order along the leaf chain.
+        class const_iterator{
+            const_node_pointer node = nullptr;
+            size_t position = 0;
+
+            friend class Bplus_tree;
+            // the position past the last data of a leaf is the first data of the next leaf.
+            const_iterator(const_node_pointer node_, size_t position_):node(node_), position(position_){
+                if(node && position == node->data_size){
+                    node = node->Next;
+                    position = 0;
+                }
+            }
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = DataType;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const DataType*;
+            using reference = const DataType&;
+
+            const_iterator() = default;
+
+            reference operator*() const {
+                return node->data[position];
+            }
+            pointer operator->() const {
+                return &node->data[position];
+            }
+            const_iterator& operator++(){
+                if(++position == node->data_size){
+                    node = node->Next;
+                    position = 0;
+                }
+                return *this;
+            }
+            const_iterator operator++(int){
+                const_iterator Old = *this;
+                ++*this;
+                return Old;
+            }
+            friend bool operator==(const const_iterator& lhs, const const_iterator& rhs){
+                return lhs.node == rhs.node && lhs.position == rhs.position;
+            }
+            friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs){
+                return !(lhs == rhs);
+            }
+        };
+
+    private:
+
+        explicit Bplus_tree(std::nullptr_t, Compare comp_ = Compare{}, const Allocator& alloc = Allocator()):basic_type(nullptr, alloc), comp(comp_){}
+
+        Compare comp;
+
+        /**
+         * @brief get the left most node of the tree.
+         *
+         * @param node
+         * @return the left most node
+         */
+        static const_node_pointer left_most(const_node_pointer node){
+            if(!node){
+                return nullptr;
+            }
+            const_node_pointer tmp=node;
+            while(node_layout::child_size(tmp) != 0){
+                tmp = node_layout::child(tmp, 0);
+            }
+            return tmp;
+        }
+
+        /**
+         * @brief get the right most node of the tree.
+         *
+         * @param node
+         * @return the right most node
+         */
+        static const_node_pointer right_most(const_node_pointer node) {
+            if(!node){
+                return nullptr;
+            }
+            const_node_pointer tmp=node;
+            while(node_layout::child_size(tmp) != 0){
+                tmp = node_layout::child(tmp, node_layout::child_size(tmp)-1);
+            }
+            return tmp;
+        }
+
+        // Find a data in one node.
+        // If found, return its offset and true,
+        // otherwise the first is the position offset(and the original data will be moved to the right).
+        // see B_node_search.h for how the keys are searched.
+        std::pair<size_t,bool> find_in_node(const_node_pointer node,const DataType& Data) const {
+            if(!node){
+                return {0,false};
+            }
+            return B_node_search(node->data, node->data_size, Data, comp);
+        }
+
+        // The child of an internal node whose range holds Data, a data equal to a separator is on its right.
+        size_t child_position(const_node_pointer node, const DataType& Data) const {
+            auto [Position, find] = find_in_node(node, Data);
+            return find ? Position + 1 : Position;
+        }
+
+        // descend to the leaf whose range holds Data.
+        const_node_pointer find_leaf(const DataType& Data) const {
+            const_node_pointer start = basic_type::get_root();
+            while(start && !start->is_leaf){
+                start = node_layout::child(start, child_position(start, Data));
+            }
+            return start;
+        }
+
+        /**
+         * @brief
+         * insert the separator Key to a not full internal node, RChild becomes the child on its right.
+         */
+        void insert_in_internal(node_pointer node, size_t InsertedPosition, const DataType& Key, node_pointer RChild){
+            for(size_t Index = node->data_size; Index > InsertedPosition; --Index){
+                node->data[Index] = node->data[Index - 1];
+                node_layout::set_child(node, Index + 1, node_layout::child(node, Index));
+            }
+            node->data[InsertedPosition] = Key;
+            node_layout::set_child(node, InsertedPosition + 1, RChild);
+            RChild->parent = node;
+            ++node->data_size;
+            node_layout::refresh_child_size(node);
+        }
+
+        /**
+         * @brief split the full node with 2m - 1 keys into two nodes, return the right one and the separator
+         * to insert into the parent(by this definition of B+ tree, if parent is full we already split it before).
+         * A leaf keeps m - 1 keys, the right leaf takes the other m keys and its first key is copied up as the separator,
+         * it is linked right after the node.
+         * An internal node keeps m - 1 keys and m children, the right one takes m - 1 keys and m children
+         * and the middle key moves up.
+         */
+        [[nodiscard("allocate a new node")]] std::pair<node_pointer, DataType> split_full(node_pointer node){
+            size_t Middle = Size - 1;
+            // the right half is of the same kind as node.
+            node_pointer RightNode = node->is_leaf ? basic_type::allocate_node() : basic_type::allocate_internal_node();
+            ++basic_type::num_of_nodes;
+            RightNode->is_leaf = node->is_leaf;
+            if(node->is_leaf){
+                for(size_t Index = Middle; Index < 2 * Size - 1; ++Index){
+                    RightNode->data[Index - Middle] = node->data[Index];
+                }
+                RightNode->data_size = Size;
+                node->data_size = Middle;
+                RightNode->Pre = node;
+                RightNode->Next = node->Next;
+                if(node->Next){
+                    node->Next->Pre = RightNode;
+                }
+                node->Next = RightNode;
+                return {RightNode, RightNode->data[0]};
+            }
+            DataType Separator = node->data[Middle];
+            for(size_t Index = Middle + 1; Index < 2 * Size; ++Index){
+                if(Index < 2 * Size - 1){
+                    RightNode->data[Index - Middle - 1] = node->data[Index];
+                }
+                node_pointer Child = node_layout::child(node, Index);
+                node_layout::set_child(RightNode, Index - Middle - 1, Child);
+                Child->parent = RightNode;
+                node_layout::set_child(node, Index, nullptr);
+            }
+            RightNode->data_size = Size - 1;
+            node->data_size = Middle;
+            node_layout::refresh_child_size(node);
+            node_layout::refresh_child_size(RightNode);
+            return {RightNode, Separator};
+        }
+
+        /**
+         * @brief
+         * In B+ tree deletion, rotate left, the right child lends its first data to the left child.
+         * A leaf takes the data itself and the separator becomes the new first data of the right leaf,
+         * an internal node takes the separator and the first child of the right one.
+         * @param node the node which is to be processed.
+         * @param RotatePosition the position of the separator between the two children.
+         */
+        void rotate_left(node_pointer node, size_t RotatePosition){
+            auto LChild = node_layout::child(node, RotatePosition);
+            auto RChild = node_layout::child(node, RotatePosition + 1);
+            if(LChild->is_leaf){
+                LChild->data[LChild->data_size] = RChild->data[0];
+                for(size_t Index = 0; Index < RChild->data_size - 1; ++Index){
+                    RChild->data[Index] = RChild->data[Index + 1];
+                }
+                ++LChild->data_size;
+                --RChild->data_size;
+                node->data[RotatePosition] = RChild->data[0];
+                return;
+            }
+            LChild->data[LChild->data_size] = node->data[RotatePosition];
+            node_pointer Moved = node_layout::child(RChild, 0);
+            node_layout::set_child(LChild, LChild->data_size + 1, Moved);
+            Moved->parent = LChild;
+            node->data[RotatePosition] = RChild->data[0];
+            for(size_t Index = 0; Index < RChild->data_size - 1; ++Index){
+                RChild->data[Index] = RChild->data[Index + 1];
+                node_layout::set_child(RChild, Index, node_layout::child(RChild, Index + 1));
+            }
+            node_layout::set_child(RChild, RChild->data_size - 1, node_layout::child(RChild, RChild->data_size));
+            node_layout::set_child(RChild, RChild->data_size, nullptr);
+            ++LChild->data_size;
+            --RChild->data_size;
+            node_layout::refresh_child_size(LChild);
+            node_layout::refresh_child_size(RChild);
+        }
+
+        /**
+         * @brief
+         * In B+ tree deletion, rotate right, the left child lends its last data to the right child.
+         * @param node the node which is to be processed.
+         * @param RotatePosition the position of the separator between the two children.
+         */
+        void rotate_right(node_pointer node, size_t RotatePosition){
+            auto LChild = node_layout::child(node, RotatePosition);
+            auto RChild = node_layout::child(node, RotatePosition + 1);
+            if(LChild->is_leaf){
+                for(size_t Index = RChild->data_size; Index >= 1; --Index){
+                    RChild->data[Index] = RChild->data[Index - 1];
+                }
+                RChild->data[0] = LChild->data[LChild->data_size - 1];
+                --LChild->data_size;
+                ++RChild->data_size;
+                node->data[RotatePosition] = RChild->data[0];
+                return;
+            }
+            node_layout::set_child(RChild, RChild->data_size + 1, node_layout::child(RChild, RChild->data_size));
+            for(size_t Index = RChild->data_size; Index >= 1; --Index){
+                RChild->data[Index] = RChild->data[Index - 1];
+                node_layout::set_child(RChild, Index, node_layout::child(RChild, Index - 1));
+            }
+            RChild->data[0] = node->data[RotatePosition];
+            node_pointer Moved = node_layout::child(LChild, LChild->data_size);
+            node_layout::set_child(RChild, 0, Moved);
+            Moved->parent = RChild;
+            node->data[RotatePosition] = LChild->data[LChild->data_size - 1];
+            node_layout::set_child(LChild, LChild->data_size, nullptr);
+            --LChild->data_size;
+            ++RChild->data_size;
+            node_layout::refresh_child_size(LChild);
+            node_layout::refresh_child_size(RChild);
+        }
+
+        /**
+         * @brief
+         * In B+ tree deletion, if the left and the right node both have the minimum keys, merge them.
+         * Leaves drop the separator and the right leaf leaves the chain, internal nodes take the separator down.
+         * @param node the node which is to be processed.
+         * @param ErasePosition the position of the separator between the two merged children.
+         * @return the new merged node.
+         */
+        [[nodiscard]] node_pointer merge(node_pointer node, size_t ErasePosition){
+            auto LChild = node_layout::child(node, ErasePosition);
+            auto RChild = node_layout::child(node, ErasePosition + 1);
+            if(LChild->is_leaf){
+                for(size_t Index = 0; Index < RChild->data_size; ++Index){
+                    LChild->data[LChild->data_size + Index] = RChild->data[Index];
+                }
+                LChild->data_size += RChild->data_size;
+                LChild->Next = RChild->Next;
+                if(RChild->Next){
+                    RChild->Next->Pre = LChild;
+                }
+            }else{
+                LChild->data[LChild->data_size] = node->data[ErasePosition];
+                for(size_t Index = 0; Index <= RChild->data_size; ++Index){
+                    if(Index < RChild->data_size){
+                        LChild->data[LChild->data_size + 1 + Index] = RChild->data[Index];
+                    }
+                    node_pointer Moved = node_layout::child(RChild, Index);
+                    node_layout::set_child(LChild, LChild->data_size + 1 + Index, Moved);
+                    Moved->parent = LChild;
+                    node_layout::set_child(RChild, Index, nullptr);
+                }
+                LChild->data_size += RChild->data_size + 1;
+                node_layout::refresh_child_size(LChild);
+            }
+            // remove the separator and RChild from node.
+            for(size_t Index = ErasePosition; Index + 1 < node->data_size; ++Index){
+                node->data[Index] = node->data[Index + 1];
+                node_layout::set_child(node, Index + 1, node_layout::child(node, Index + 2));
+            }
+            node_layout::set_child(node, node->data_size, nullptr);
+            --node->data_size;
+            node_layout::refresh_child_size(node);
+            basic_type::deallocate_node(RChild);
+            --basic_type::num_of_nodes;
+            return LChild;
+        }
+
+        /**
+         * @brief
+         * Called by deletion before going down to the Offset-th child of parent having the minimum keys,
+         * borrow a data from a sibling or merge with one, so that the child can lose a data.
+         * @return the node to go down to.
+         */
+        node_pointer erase_transform(node_pointer parent, size_t Offset, bool borrowLeft, bool mergeLeft){
+            node_pointer node = node_layout::child(parent, Offset);
+            bool leftCanBorrow = Offset > 0 && node_layout::child(parent, Offset - 1)->data_size >= Size;
+            bool rightCanBorrow = Offset < parent->data_size && node_layout::child(parent, Offset + 1)->data_size >= Size;
+            if(leftCanBorrow && (borrowLeft || !rightCanBorrow)){
+                rotate_right(parent, Offset - 1);
+                return node;
+            }
+            if(rightCanBorrow){
+                rotate_left(parent, Offset);
+                return node;
+            }
+            bool leftCanMerge = Offset > 0;
+            bool rightCanMerge = Offset < parent->data_size;
+            bool isRoot = parent == basic_type::_root;
+            node_pointer mergedNode = merge(parent, leftCanMerge && (mergeLeft || !rightCanMerge) ? Offset - 1 : Offset);
+            // if parent node is root and have no data, delete it.
+            if(isRoot && parent->data_size == 0){
+                basic_type::_root = mergedNode;
+                --height;
+                mergedNode->parent = nullptr;
+                --basic_type::num_of_nodes;
+                node_layout::set_child(parent, 0, nullptr);
+                basic_type::deallocate_node(parent);
+            }
+            return mergedNode;
+        }
+
+    public:
+        Bplus_tree(const Bplus_tree&) = delete;
+        explicit Bplus_tree(Compare comp_ = Compare{}, const Allocator& alloc = Allocator()):Bplus_tree(nullptr, comp_, alloc){}
+        Bplus_tree(Bplus_tree && tree) noexcept :basic_type(std::move(tree)), height(tree.height), comp(std::move(tree.comp)) {
+            tree.height = 0;
+        }
+
+        static Bplus_tree create_tree(std::istream &in=std::cin) {
+            Bplus_tree tree;
+            char Indicator;
+            DataType Data;
+            // !!! allowed to read a char of indicator.
+            while(true){
+                root_input:
+                    if(in.good()){
+                        Indicator=in.peek();
+                    }else{
+                        Indicator=EMPTY_NODE_INDICATOR;
+                    }
+                if(Indicator=='\n'){
+                    in.get();
+                    goto root_input;
+                }else if(Indicator==' '||Indicator=='\t'){
+                    in.get();
+                    continue;
+                }else if(Indicator==EMPTY_NODE_INDICATOR || Indicator == EOF ){
+                    break;
+                }else {
+                    // take back to stream.
+                    in>> Data;
+                    tree.insert(Data);
+                }
+            }
+            return tree;
+        }
+
+        // return the result, the node is always a leaf.
+        // if bool is true, then the first is the result leaf, the second is the data position.
+        // if bool is false, then the first is the leaf.(also may be null,empty tree), the second is the data inserted position inside the leaf.
+        std::tuple<const_node_pointer,size_t,bool> find(const DataType& data)const{
+            const_node_pointer Leaf = find_leaf(data);
+            if(!Leaf){
+                return {nullptr,0,false};
+            }
+            auto [Position, find] = find_in_node(Leaf, data);
+            return {Leaf, Position, find};
+        }
+
+        /**
+         * @brief insert the data if find it, ignored!
+         * the third returns whether insert operation is successful.
+         *
+         * @param data inserted key.
+         * @return std::tuple<const_node_pointer,size_t,bool>
+         * @details
+         * As B_tree_Cormen::insert(const DataType&), every full node met on the way down is split first,
+         * so the data is inserted in one traversal.
+         */
+        std::tuple<const_node_pointer,size_t,bool> insert(const DataType& Data){
+            if(basic_type::is_empty()){
+                ++height;
+                // empty tree inserted  the data as a root.
+                basic_type::_root=basic_type::allocate_node();
+                basic_type::_root->data[0] = Data;
+                basic_type::num_of_nodes = 1;
+                basic_type::_root->data_size = 1;
+                node_layout::set_child_size(basic_type::_root, 0);
+                return {basic_type::_root,0,true};
+            }
+            if(basic_type::_root->data_size == 2 * Size - 1){
+                node_pointer OldRoot = basic_type::_root;
+                auto [RightNode, Separator] = split_full(OldRoot);
+                node_pointer Root = basic_type::allocate_internal_node();
+                ++basic_type::num_of_nodes;
+                ++height;
+                Root->is_leaf = false;
+                Root->data[0] = Separator;
+                Root->data_size = 1;
+                node_layout::set_child(Root, 0, OldRoot);
+                node_layout::set_child(Root, 1, RightNode);
+                node_layout::set_child_size(Root, 2);
+                OldRoot->parent = Root;
+                RightNode->parent = Root;
+                basic_type::_root = Root;
+            }
+            node_pointer start = basic_type::_root;
+            while(!start->is_leaf){
+                size_t Offset = child_position(start, Data);
+                node_pointer Child = node_layout::child(start, Offset);
+                // full node : 2m-1, start is not full so it can take the separator.
+                if(Child->data_size == 2 * Size - 1){
+                    auto [RightNode, Separator] = split_full(Child);
+                    insert_in_internal(start, Offset, Separator, RightNode);
+                    if(!comp(Data, Separator)){
+                        Child = RightNode;
+                    }
+                }
+                start = Child;
+            }
+            auto [Position, find] = find_in_node(start, Data);
+            if(find){
+                return {start, Position, false};
+            }
+            for(size_t Index = start->data_size; Index > Position; --Index){
+                start->data[Index] = start->data[Index - 1];
+            }
+            start->data[Position] = Data;
+            ++start->data_size;
+            return {start, Position, true};
+        }
+
+        /**
+         * @brief delete the data if find it, ignored!
+         *
+         * @param data deleted key.
+         * @param borrowLeft Whether to borrow the data from the left sibling(if allowed).
+         * @param mergeLeft Whether to merge the node with its left sibling(if allowed).
+         * @details
+         * As B_tree_Cormen::erase, every node having the minimum keys met on the way down borrows a data
+         * or is merged first, so the data is erased from its leaf in one traversal.
+         * Separators are left as they are, an erased data may still route the search, which is harmless.
+         */
+        void erase(const DataType& Data, bool borrowLeft = true, bool mergeLeft = true){
+            if(basic_type::is_empty()){
+                return;
+            }
+            node_pointer start = basic_type::_root;
+            while(!start->is_leaf){
+                size_t Offset = child_position(start, Data);
+                node_pointer Child = node_layout::child(start, Offset);
+                if(Child->data_size < Size){
+                    Child = erase_transform(start, Offset, borrowLeft, mergeLeft);
+                }
+                start = Child;
+            }
+            if(auto [Position, find] = find_in_node(start, Data); find){
+                for(size_t Index = Position; Index + 1 < start->data_size; ++Index){
+                    start->data[Index] = start->data[Index + 1];
+                }
+                --start->data_size;
+            }
+            // if the root is a leaf without data, delete it.
+            node_pointer Root = basic_type::_root;
+            if(Root->is_leaf && Root->data_size == 0){
+                basic_type::_root = nullptr;
+                basic_type::num_of_nodes = 0;
+                height = 0;
+                basic_type::deallocate_node(Root);
+            }
+        }
+
+        const_iterator begin() const {
+            return const_iterator(left_most(basic_type::_root), 0);
+        }
+        const_iterator end() const {
+            return const_iterator();
+        }
+        // the first data not less than Data.
+        const_iterator lower_bound(const DataType& Data) const {
+            auto [Leaf, Position, find] = this->find(Data);
+            return const_iterator(Leaf, Position);
+        }
+        // the first data greater than Data.
+        const_iterator upper_bound(const DataType& Data) const {
+            auto [Leaf, Position, find] = this->find(Data);
+            return const_iterator(Leaf, find ? Position + 1 : Position);
+        }
+
+        /**
+         * @brief visit the data in [Low, High) in order.
+         * Only the leaf of Low is searched from the root, the rest of the range is read along the leaf chain.
+         */
+        template<typename Visitor>
+        void for_each_in_range(const DataType& Low, const DataType& High, Visitor visit) const {
+            auto [Leaf, Position, find] = this->find(Low);
+            for(const_node_pointer node = Leaf; node; node = node->Next, Position = 0){
+                for(; Position < node->data_size; ++Position){
+                    if(!comp(node->data[Position], High)){
+                        return;
+                    }
+                    visit(node->data[Position]);
+                }
+            }
+        }
+
+        /**
+         * @brief replace the content of the tree by the data in [first, last), which must be strictly increasing
+         * and must not be read from this tree.
+         * @param fill_factor the share of the maximum keys every node gets(never less than the minimum),
+         *     leave room(less than 1) if more data will be inserted.
+         * @details
+         * Leaves are filled and chained first, the first data of each one is copied up to build the next level,
+         * and so on up to the root, in O(n) without the splits of one insert per data.
+         */
+        template<typename ForwardIt>
+        void build_from_sorted(ForwardIt first, ForwardIt last, double fill_factor = 1.0){
+            assert(std::adjacent_find(first, last, [this](const DataType& lhs, const DataType& rhs){
+                return !comp(lhs, rhs);
+            }) == last && "Data must be strictly increasing");
+            basic_type::destroy();
+            size_t Count = static_cast<size_t>(std::distance(first, last));
+            if(Count == 0){
+                return;
+            }
+            std::vector<DataType> Separators;
+            auto Leaves = build_B_leaves<node_pointer>(first, Count, false, fill_factor, Size - 1, 2 * Size - 1, [this]{
+                ++basic_type::num_of_nodes;
+                return basic_type::allocate_node();
+            }, Separators);
+            for(size_t Index = 1; Index < Leaves.size(); ++Index){
+                Leaves[Index - 1]->Next = Leaves[Index];
+                Leaves[Index]->Pre = Leaves[Index - 1];
+            }
+            height = 1;
+            basic_type::_root = build_B_internal_levels<node_layout>(std::move(Leaves), std::move(Separators), fill_factor
+                , Size - 1, 2 * Size - 1, [this]{
+                    ++basic_type::num_of_nodes;
+                    return basic_type::allocate_internal_node();
+                }, height);
+        }
+
+        // rebuild the tree with every node holding fill_factor of the maximum keys, see build_from_sorted.
+        void compact(double fill_factor = 1.0){
+            std::vector<DataType> Data;
+            for(auto node = const_cast<node_pointer>(left_most(basic_type::_root)); node; node = node->Next){
+                for(size_t Index = 0; Index < node->data_size; ++Index){
+                    Data.push_back(std::move(node->data[Index]));
+                }
+            }
+            build_from_sorted(std::make_move_iterator(Data.begin()), std::make_move_iterator(Data.end()), fill_factor);
+        }
+
+        [[nodiscard]] std::string to_string()const override {
+            return "<-B+ Tree->";
+        }
+
+        size_t get_height() const {
+            return height;
+        }
+        // find the min and the max data.
+        DataType min()const{
+            const auto find_result=left_most(basic_type::_root);
+            assert(find_result&&"Empty tree!");
+            return find_result->data[0];
+        }
+        DataType max()const{
+            const auto find_result=right_most(basic_type::_root);
+            assert(find_result&&"Empty tree!");
+            return find_result->data[find_result->data_size - 1];
+        }
+    };
+}
+
+
+#endif
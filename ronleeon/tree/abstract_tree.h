@@ -6,15 +6,24 @@
 #define RONLEEON_ADT_ABSTRACT_TREE_H
 
 #include "ronleeon/tree/node.h"
+#include "ronleeon/tree/node_arena.h"
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <ostream>
 #include <istream>
+#include <iterator>
 #include <string>
 #include <utility>
 #include <stack>
 #include <queue>
 #include <cstring>
+#include <future>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 
 // macros defines signals for an empty node
@@ -47,8 +56,8 @@ namespace ronleeon::tree {
 					os << t->data;
 				}
 				os << "]  ";
-				os<<"[Height:"<<t->height<<"] ";
-				if (t->is_leaf) {
+				os<<"[Height:"<<node::node_bookkeeping<NodeType>::height(t)<<"] ";
+				if (node::node_bookkeeping<NodeType>::is_leaf(t)) {
 					os << "Leaf";
 				}
 				else {
@@ -57,7 +66,91 @@ namespace ronleeon::tree {
 			}
 		};
 
-		template<typename DataType,size_t Size,typename NodeType,typename TreeType, typename NodePrintTrait = m_node_print_trait<NodeType>>
+		// A node unlinked from a tree(see abstract_bs_tree::extract) with its data, owned here until it
+		// is linked into a tree of the same type again(insert of a node handle), or released with the
+		// handle. The data may be changed meanwhile through value().
+		template<typename NodeType, typename Allocator>
+		class node_handle{
+		public:
+			using allocator_type = Allocator;
+		private:
+			using node_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<NodeType>;
+			using node_allocator_traits = std::allocator_traits<node_allocator_type>;
+
+			NodeType* node = nullptr;
+			node_allocator_type alloc;
+
+			void release_node(){
+				if(node){
+					node_allocator_traits::destroy(alloc, node);
+					node_allocator_traits::deallocate(alloc, node, 1);
+					node = nullptr;
+				}
+			}
+
+		public:
+			node_handle() = default;
+			node_handle(NodeType* node_, const node_allocator_type& alloc_):node(node_), alloc(alloc_){}
+			node_handle(const node_handle&) = delete;
+			node_handle& operator=(const node_handle&) = delete;
+			node_handle(node_handle&& rhs) noexcept :node(rhs.node), alloc(std::move(rhs.alloc)){
+				rhs.node = nullptr;
+			}
+			node_handle& operator=(node_handle&& rhs) noexcept {
+				if(this != &rhs){
+					release_node();
+					node = rhs.node;
+					alloc = std::move(rhs.alloc);
+					rhs.node = nullptr;
+				}
+				return *this;
+			}
+
+			~node_handle(){
+				release_node();
+			}
+
+			[[nodiscard]] bool empty() const {
+				return !node;
+			}
+
+			explicit operator bool() const {
+				return node != nullptr;
+			}
+
+			auto& value() const {
+				assert(node && "Empty node handle!");
+				return node->data;
+			}
+
+			allocator_type get_allocator() const {
+				return allocator_type(alloc);
+			}
+
+			// the tree linking the node takes it over.
+			NodeType* release(){
+				NodeType* Ret = node;
+				node = nullptr;
+				return Ret;
+			}
+		};
+
+		// Tree::node_handle_type, or for a tree not handing its nodes over(tree_234) a handle it never
+		// fills, so that containers over any tree name one.
+		template<typename Tree, typename = void>
+		struct node_handle_of{
+			using type = node_handle<typename Tree::node_type, typename Tree::allocator_type>;
+		};
+
+		template<typename Tree>
+		struct node_handle_of<Tree, std::void_t<typename Tree::node_handle_type>>{
+			using type = typename Tree::node_handle_type;
+		};
+
+		// Allocator is given for DataType (like std containers) and rebound to NodeType,
+		// every node of the tree is created and released through it.
+		template<typename DataType,size_t Size,typename NodeType,typename TreeType, typename NodePrintTrait = m_node_print_trait<NodeType>
+			, typename Allocator = std::allocator<DataType>>
 		class abstract_tree{
 		public:
 			using node_type = NodeType;
@@ -68,7 +161,21 @@ namespace ronleeon::tree {
 			using const_node_type_reference = const NodeType&;
 
 			using PrintTrait = NodePrintTrait;
+
+			using allocator_type = Allocator;
+			using node_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<NodeType>;
 		private:
+			using node_allocator_traits = std::allocator_traits<node_allocator_type>;
+			// node types with a separate internal layout (see node::split_B_node) allocate their internal nodes as it.
+			using internal_node_type = typename node::internal_node_of<NodeType>::type;
+			using internal_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<internal_node_type>;
+			using internal_allocator_traits = std::allocator_traits<internal_allocator_type>;
+		protected:
+			using node_bookkeeping = node::node_bookkeeping<NodeType>;
+		private:
+			static_assert(std::is_same_v<typename node_allocator_traits::pointer, node_pointer>,
+				"Node allocator must hand out raw node pointers");
+
 			void set_m(size_t m) {
 				_m=m;
 				assert(m >= 0 && "The tree must at least have one child");
@@ -78,12 +185,12 @@ namespace ronleeon::tree {
 					_root = nullptr;
 					return;
 				}
-				assert(t->child_size != 0 && "Cannot convert non empty node to be the root node!");
+				assert(!node_bookkeeping::is_leaf(t) && "Cannot convert non empty node to be the root node!");
 				_root = t;
 			}
 		protected:
 
-			explicit abstract_tree(std::nullptr_t) {
+			explicit abstract_tree(std::nullptr_t, const Allocator& alloc = Allocator()):_alloc(alloc) {
 				set_m(Size);
 				set_root(nullptr);
 			}
@@ -92,24 +199,161 @@ namespace ronleeon::tree {
 		protected:
 			node_pointer _root;
 			size_t _m{};
+			node_allocator_type _alloc;
+
+			// allocate and default construct a node.
+			node_pointer allocate_node(){
+				node_pointer node = node_allocator_traits::allocate(_alloc, 1);
+				try{
+					node_allocator_traits::construct(_alloc, node);
+				}catch(...){
+					node_allocator_traits::deallocate(_alloc, node, 1);
+					throw;
+				}
+				return node;
+			}
+
+			// allocate a node whose data is constructed from args, in place.
+			template<typename... Args>
+			node_pointer allocate_node(std::in_place_t, Args&&... args){
+				node_pointer node = node_allocator_traits::allocate(_alloc, 1);
+				try{
+					node_allocator_traits::construct(_alloc, node, std::in_place, std::forward<Args>(args)...);
+				}catch(...){
+					node_allocator_traits::deallocate(_alloc, node, 1);
+					throw;
+				}
+				return node;
+			}
+
+			// allocate and default construct a node meant to have children,
+			// the same as allocate_node() unless NodeType has a separate internal layout.
+			node_pointer allocate_internal_node(){
+				if constexpr(std::is_same_v<internal_node_type, NodeType>){
+					return allocate_node();
+				}else{
+					internal_allocator_type alloc(_alloc);
+					internal_node_type* node = internal_allocator_traits::allocate(alloc, 1);
+					try{
+						internal_allocator_traits::construct(alloc, node);
+					}catch(...){
+						internal_allocator_traits::deallocate(alloc, node, 1);
+						throw;
+					}
+					return node;
+				}
+			}
+
+			// destruct a single node as the kind it was allocated, memory is only given back if Deallocate.
+			template<bool Deallocate = true>
+			static void destroy_node(node_allocator_type& alloc, node_pointer node){
+				if constexpr(!std::is_same_v<internal_node_type, NodeType>){
+					if(!node->is_leaf){
+						internal_allocator_type internal_alloc(alloc);
+						auto internal = static_cast<internal_node_type*>(node);
+						internal_allocator_traits::destroy(internal_alloc, internal);
+						if constexpr(Deallocate){
+							internal_allocator_traits::deallocate(internal_alloc, internal, 1);
+						}
+						return;
+					}
+				}
+				node_allocator_traits::destroy(alloc, node);
+				if constexpr(Deallocate){
+					node_allocator_traits::deallocate(alloc, node, 1);
+				}
+			}
+
+			// destruct and release a single node, its children are not touched.
+			void deallocate_node(node_pointer node){
+				destroy_node(_alloc, node);
+			}
+
+			// Nodes detached by destroy_step() and not released yet.
+			// Like every teardown list, they are chained through their parent field.
+			node_pointer _pending = nullptr;
+
+			// Teardown does not recurse: nodes waiting to be released form a stack linked
+			// through their (no longer needed) parent field, so whatever the shape of the tree
+			// only O(1) extra space is used.
+			// Push a detached subtree onto such a stack and return the new top.
+			static node_pointer push_teardown(node_pointer stack, node_pointer node){
+				if(!node){
+					return stack;
+				}
+				node->parent = stack;
+				return node;
+			}
+
+			// Release at most Budget nodes of the teardown stack, return what is left of it.
+			// Memory is only given back if Deallocate, otherwise nodes are just destructed.
+			template<bool Deallocate = true>
+			static node_pointer release_teardown(node_allocator_type& alloc, node_pointer stack
+				, size_t Budget = std::numeric_limits<size_t>::max()){
+				while(stack && Budget != 0){
+					node_pointer node = stack;
+					stack = node->parent;
+					for(auto It = node->child_begin(), End = node->child_end(); It != End; ++It){
+						if(*It){
+							stack = push_teardown(stack, *It);
+						}
+					}
+					destroy_node<Deallocate>(alloc, node);
+					--Budget;
+				}
+				return stack;
+			}
+
+			// release node and all its descendants, node must be already unlinked from its parent.
+			void deallocate_subtree(node_pointer node){
+				release_teardown(_alloc, push_teardown(nullptr, node));
+			}
+
+			// Hand the whole node structure over to the caller, the tree becomes empty.
+			// Sub-classes reset their own bookkeeping here.
+			virtual node_pointer detach_nodes(){
+				node_pointer root = _root;
+				_root = nullptr;
+				num_of_nodes = 0;
+				return root;
+			}
+
+			// Release a teardown stack holding every node of this allocator.
+			// Arena backed allocators drop their slabs at once and per-node destructors
+			// are skipped when the nodes(and the internal ones of split B nodes) are trivially destructible.
+			static void release_all(node_allocator_type& alloc, node_pointer stack){
+				if constexpr(is_bulk_releasable<node_allocator_type>::value){
+					if(alloc.releasable()){
+						if constexpr(!std::is_trivially_destructible_v<NodeType>
+							|| !std::is_trivially_destructible_v<internal_node_type>){
+							release_teardown<false>(alloc, stack);
+						}
+						alloc.release();
+						return;
+					}
+				}
+				release_teardown(alloc, stack);
+			}
 			
 			// when create tree or modify it, change it height recursively,
 			// this request all subtree of node(except node itself) are height-corrective.
 
 			// Call this method only when node is modified 
 			void shift_height(node_pointer node){
-				while(node){
-					size_t height=0;
-					for(auto Child=node->child_begin(),End=node->child_end();Child!=End;++Child){
-						if(*Child){
-							height=std::max(height,(*Child)->height+1);
+				if constexpr(node_bookkeeping::has_height){
+					while(node){
+						size_t height=0;
+						for(auto Child=node->child_begin(),End=node->child_end();Child!=End;++Child){
+							if(*Child){
+								height=std::max(height,static_cast<size_t>((*Child)->height)+1);
+							}
+						}
+						if(height==node->height){
+							break;
+						}else{
+							node->height=height;
+							node=node->parent;
 						}
-					}
-					if(height==node->height){
-						break;
-					}else{
-						node->height=height;
-						node=node->parent;
 					}
 				}
 			}
@@ -136,18 +380,17 @@ namespace ronleeon::tree {
 				}else {
 					++num_of_nodes;
 					in>> Data;
-					node=new node_type();
+					node=allocate_node();
 					node->data = Data;
 				}
 				for(auto It = node->child_begin();It != node->child_end();++It){
 					auto NewNode = create_node_impl(in);
 					*It=NewNode;
 					if(NewNode){
-						++node->child_size;
-						node->is_leaf=false;
 						NewNode->parent=node;
 					}
 				}
+				node_bookkeeping::refresh(node);
 				shift_height(node);
 				return node;
 			}
@@ -181,7 +424,7 @@ namespace ronleeon::tree {
 				}else {
 					// take back to stream.
 					in>> Data;
-					node_pointer node=new node_type();
+					node_pointer node=Ret.allocate_node();
 					node->data = Data;
 					Ret._root=node;
 					tmp_queue.push(Ret._root);
@@ -207,16 +450,15 @@ namespace ronleeon::tree {
 							continue;
 						}else {
 							in>> Data;
-							node_pointer node=new node_type();
+							node_pointer node=Ret.allocate_node();
 							node->data = Data;
 							*It = node;
-							++pop->child_size;
-							pop->is_leaf=false;
 							node->parent=pop;
 							++Ret.num_of_nodes;
 							tmp_queue.push(node);
 						}
 					}
+					node_bookkeeping::refresh(pop);
 					Ret.shift_height(pop);
 				}
 				return Ret;
@@ -240,20 +482,63 @@ namespace ronleeon::tree {
 			abstract_tree(const abstract_tree&) = delete;
 			abstract_tree():abstract_tree(nullptr){}
             // OK,move semantics sets nullptr to temp tree.
-			abstract_tree(abstract_tree && tree) noexcept {
+			abstract_tree(abstract_tree && tree) noexcept :_alloc(std::move(tree._alloc)) {
 				_m=Size;
 				_root=tree._root;
 				tree._root=nullptr;
+				_pending=tree._pending;
+				tree._pending=nullptr;
 				num_of_nodes=tree.num_of_nodes;
 			}
 			const_node_pointer get_root()const {
 				return _root;
 			}
+
+			allocator_type get_allocator() const {
+				return allocator_type(_alloc);
+			}
 			
+			// Release every node (including the ones left by destroy_step()) without recursion.
 			virtual void destroy() {
-				delete _root;
-				_root=nullptr;
-				num_of_nodes=0;
+				node_pointer stack = push_teardown(_pending, detach_nodes());
+				_pending = nullptr;
+				release_all(_alloc, stack);
+			}
+
+			// Incremental teardown, for callers that cannot afford releasing a big tree at once.
+			// The first call detaches all nodes (the tree is empty and usable right away),
+			// every call releases at most Budget of them.
+			// Returns true once all detached nodes are released.
+			bool destroy_step(size_t Budget){
+				if(!_pending){
+					_pending = push_teardown(nullptr, detach_nodes());
+				}
+				_pending = release_teardown(_alloc, _pending, Budget);
+				return _pending == nullptr;
+			}
+
+			// Detach all nodes and release them on a background thread, the tree is empty
+			// right away. The returned future is ready once every node is released, it may be dropped.
+			// Arena backed allocators move their arena to the worker and the tree continues
+			// with a fresh one; other allocators must be safe to use from another thread.
+			// Pooled nodes (index_pool_allocator) are rejected, their pool is single threaded.
+			std::future<void> destroy_in_background(){
+				static_assert(!is_pool_allocator<node_allocator_type>::value
+					, "Pooled nodes share one node_pool per node type, which cannot be released from another thread");
+				node_pointer stack = push_teardown(_pending, detach_nodes());
+				_pending = nullptr;
+				node_allocator_type alloc = _alloc;
+				if constexpr(is_bulk_releasable<node_allocator_type>::value){
+					_alloc = node_allocator_type();
+				}
+				std::packaged_task<void()> task([stack, alloc = std::move(alloc)]() mutable {
+					// the worker's allocator is gone before the future is ready.
+					node_allocator_type Alloc = std::move(alloc);
+					release_all(Alloc, stack);
+				});
+				std::future<void> done = task.get_future();
+				std::thread(std::move(task)).detach();
+				return done;
 			}
 
 			[[nodiscard]] size_t size() const {
@@ -275,7 +560,7 @@ namespace ronleeon::tree {
 
 			size_t get_height(const_node_pointer node) const {
 				if(node){
-					return node->height;
+					return node_bookkeeping::height(node);
 				}
 				return 0;
 			}
@@ -384,22 +669,23 @@ namespace ronleeon::tree {
 					out << "Empty Tree!\n";
 					return;
 				}
-				std::stack<std::pair<const_node_pointer, bool>*> s;
-				s.push(new std::pair<const_node_pointer, bool>(std::make_pair(start, false)));
-				std::pair<const_node_pointer, bool>* t;
+				// the flag tells whether the children are already pushed.
+				std::stack<std::pair<const_node_pointer, bool>> s;
+				s.push(std::make_pair(start, false));
 				while (!s.empty()) {
-					t = s.top();
-					if (!t->second) {
-						t->second = true;
-						if (!t->first) {
+					auto& t = s.top();
+					if (!t.second) {
+						t.second = true;
+						if (!t.first) {
 							continue;
 						}
-						for (auto rit = t->first->children.rbegin(); rit != t->first->children.rend(); rit++) {
-							s.push(new std::pair<const_node_pointer, bool>(std::make_pair(*rit, false)));
+						const_node_pointer node = t.first;
+						for (auto rit = node->child_rbegin(); rit != node->child_rend(); rit++) {
+							s.push(std::make_pair(*rit, false));
 						}
 					}else {
-						if (Echo&&(t->first||ShowNullNode)) {
-							PrintTrait::print_visiting_node(t->first,out);
+						if (Echo&&(t.first||ShowNullNode)) {
+							PrintTrait::print_visiting_node(t.first,out);
 							out << '\n';
 						}
 						s.pop();
@@ -479,8 +765,8 @@ namespace ronleeon::tree {
 					os << t->data;
 				}
 				os << "]  ";
-				os<<"[Height:"<<t->height<<"] ";
-				if (t->is_leaf) {
+				os<<"[Height:"<<node::node_bookkeeping<NodeType>::height(t)<<"] ";
+				if (node::node_bookkeeping<NodeType>::is_leaf(t)) {
 					os << "Leaf";
 				}
 				else {
@@ -495,10 +781,11 @@ namespace ronleeon::tree {
 				}
 			}
 		};
-		template<typename DataType,typename NodeType,typename TreeType, typename NodePrintTrait = b_node_print_trait<NodeType>>
-		class abstract_b_tree:public abstract_tree<DataType,2,NodeType,TreeType,NodePrintTrait>{
+		template<typename DataType,typename NodeType,typename TreeType, typename NodePrintTrait = b_node_print_trait<NodeType>
+			, typename Allocator = std::allocator<DataType>>
+		class abstract_b_tree:public abstract_tree<DataType,2,NodeType,TreeType,NodePrintTrait,Allocator>{
 		
-			using basic_type=abstract_tree<DataType,2,NodeType,TreeType, NodePrintTrait>;
+			using basic_type=abstract_tree<DataType,2,NodeType,TreeType, NodePrintTrait,Allocator>;
 		public:
 			using node_type = NodeType;
 			using node_pointer = NodeType*;
@@ -509,15 +796,31 @@ namespace ronleeon::tree {
 
 			using PrintTrait = typename basic_type::PrintTrait;
 		protected:
+			using typename basic_type::node_bookkeeping;
+
+			explicit abstract_b_tree(std::nullptr_t, const Allocator& alloc = Allocator()):basic_type(nullptr, alloc){}
 
-			explicit abstract_b_tree(std::nullptr_t):abstract_tree<DataType,2,NodeType
-				,TreeType, NodePrintTrait>(nullptr){}
+			// put child in the place of old, which is a child of parent (or the root if parent is null).
+			void replace_child(node_pointer parent,const_node_pointer old,node_pointer child){
+				if(!parent){
+					basic_type::_root=child;
+				}else if(parent->left_child==old){
+					parent->left_child=child;
+				}else{
+					parent->right_child=child;
+				}
+				if(child){
+					child->parent=parent;
+				}
+				if(parent){
+					node_bookkeeping::refresh(parent);
+				}
+			}
 			
 		public:
 			abstract_b_tree(const abstract_b_tree&) = delete;
 			abstract_b_tree():abstract_b_tree(nullptr){}
-			abstract_b_tree(abstract_b_tree && tree) noexcept :abstract_tree<DataType,2,NodeType
-				,TreeType, NodePrintTrait>(std::move(tree)) {}
+			abstract_b_tree(abstract_b_tree && tree) noexcept :basic_type(std::move(tree)) {}
 
 			[[nodiscard]] std::string to_string()const override {
 				return "<-Binary tree->";
@@ -595,13 +898,20 @@ namespace ronleeon::tree {
 
 		};
 
+		// Marks a range already sorted and without duplicates, see abstract_bs_tree::build_from_sorted.
+		struct sorted_unique_t{
+			explicit sorted_unique_t() = default;
+		};
+		inline constexpr sorted_unique_t sorted_unique{};
+
 		// Guarantee all NodeType data are not equal,otherwise the latter 
 		// will be ignored.
 
 		// C++ style compare,not java compare style.
-		template<typename DataType,typename Compare,typename NodeType,typename TreeType,typename NodePrintTrait = b_node_print_trait<NodeType>>
-		class abstract_bs_tree:public abstract_b_tree<DataType,NodeType,TreeType, NodePrintTrait>{
-			using basic_type=abstract_b_tree<DataType,NodeType,TreeType, NodePrintTrait>;
+		template<typename DataType,typename Compare,typename NodeType,typename TreeType,typename NodePrintTrait = b_node_print_trait<NodeType>
+			, typename Allocator = std::allocator<DataType>>
+		class abstract_bs_tree:public abstract_b_tree<DataType,NodeType,TreeType, NodePrintTrait, Allocator>{
+			using basic_type=abstract_b_tree<DataType,NodeType,TreeType, NodePrintTrait, Allocator>;
 			// prohibit all create functions.
 			using basic_type::create_tree_l;
 			using basic_type::create_tree_r;
@@ -614,7 +924,10 @@ namespace ronleeon::tree {
 			using const_node_type_reference = const NodeType&;
 
 			using PrintTrait = typename basic_type::PrintTrait;
+			// a node taken out by extract, see node_handle.
+			using node_handle_type = node_handle<NodeType, Allocator>;
 		protected:
+			using typename basic_type::node_bookkeeping;
 			Compare comp;
 
 			// helper nodes , for map/set containers to define their iterators,
@@ -622,6 +935,167 @@ namespace ronleeon::tree {
 			// empty tree: they are all nullptr.
 			const_node_pointer min_node = nullptr; //< min_node points left most node of the root.
 			const_node_pointer max_node = nullptr; //< max_node points right most node of the root.
+
+			// find() by data or by a key Compare orders against data.
+			template<typename Key>
+			std::pair<const_node_pointer,bool> find_key(const Key& key)const{
+				if(basic_type::is_empty()){
+					return std::make_pair(nullptr,false);
+				}
+				return descend(basic_type::get_root(), key);
+			}
+
+			// find_key() in the subtree of start, key must be in the range of that subtree.
+			template<typename Key>
+			std::pair<const_node_pointer,bool> descend(const_node_pointer start, const Key& key)const{
+				while(true){
+					if(comp(key,start->data)) {
+						if (start->left_child) {
+							start=start->left_child;
+						} else {
+							return std::make_pair(start,false);
+						}
+					}else if(comp(start->data,key)) {
+						if(start->right_child){
+							start=start->right_child;
+						}else {
+							return std::make_pair(start,false);
+						}
+					}else{
+						return std::make_pair(start,true);
+					}
+				}
+			}
+
+			// Link node, new and holding data not in the tree, below parent where find() ended(null
+			// for an empty tree) and count it in, then restore the tree invariants.
+			virtual void link_new_node(node_pointer parent, node_pointer node){
+				++basic_type::num_of_nodes;
+				if(!parent){
+					// root.
+					basic_type::_root=node;
+					min_node = max_node = node;
+					refresh_augmented_path(node);
+					return;
+				}
+				// not equal
+				if(comp(node->data,parent->data)){
+					assert(!parent->left_child);
+					parent->left_child=node;
+				}else{
+					assert(!parent->right_child);
+					parent->right_child=node;
+				}
+				node->parent=parent;
+				node_bookkeeping::refresh(parent);
+				// update min_node and max_node.
+				if(min_node&& (min_node->left_child == node)){
+					min_node = node;
+				}
+				if(max_node&&(max_node->right_child == node)){
+					max_node = node;
+				}
+				// the new leaf has height 0 already, heights change from its parent up.
+				basic_type::shift_height(parent);
+				refresh_augmented_path(node);
+			}
+
+			// find_from() by data or by a key Compare orders against data.
+			template<typename Key>
+			std::pair<const_node_pointer,bool> find_key_from(const_node_pointer finger, const Key& key)const{
+				if(!finger){
+					return find_key(key);
+				}
+				if(comp(max_node->data, key)){
+					return std::make_pair(max_node, false);
+				}
+				if(comp(key, min_node->data)){
+					return std::make_pair(min_node, false);
+				}
+				const_node_pointer node = finger;
+				if(comp(finger->data, key)){
+					// an ancestor reached from its right child is less than finger.
+					for(; node->parent; node = node->parent){
+						if(node->parent->left_child == node && comp(key, node->parent->data)){
+							break;
+						}
+					}
+				}else if(comp(key, finger->data)){
+					for(; node->parent; node = node->parent){
+						if(node->parent->right_child == node && comp(node->parent->data, key)){
+							break;
+						}
+					}
+				}else{
+					return std::make_pair(finger, true);
+				}
+				return descend(node, key);
+			}
+
+			// rank() by data or by a key Compare orders against data.
+			template<typename Key>
+			size_t rank_key(const Key& key) const {
+				size_t Rank = 0;
+				if constexpr(node_bookkeeping::has_subtree_size){
+					const_node_pointer node = basic_type::_root;
+					while(node){
+						if(comp(node->data, key)){
+							Rank += node_bookkeeping::subtree_size(node->left_child) + 1;
+							node = node->right_child;
+						}else{
+							node = node->left_child;
+						}
+					}
+				}else{
+					for(const_node_pointer node = min_node; node && comp(node->data, key); node = increment(node)){
+						++Rank;
+					}
+				}
+				return Rank;
+			}
+
+			// aggregate() by data or by keys Compare orders against data. Keys may not be ordered against
+			// each other, an empty range just finds no node in it.
+			template<typename N, typename Key>
+			typename node::augmentation_trait<N>::value_type aggregate_key(const Key& lo, const Key& hi) const {
+				using trait = node::augmentation_trait<N>;
+				using monoid = typename trait::monoid_type;
+				// the highest node in the range, both bounds are searched below it.
+				const_node_pointer node = basic_type::_root;
+				while(node){
+					if(comp(node->data, lo)){
+						node = node->right_child;
+					}else if(!comp(node->data, hi)){
+						node = node->left_child;
+					}else{
+						break;
+					}
+				}
+				if(!node){
+					return monoid::identity();
+				}
+				// data not less than lo on the left, each step takes a node and its right subtree, smaller than the previous ones.
+				auto Left = monoid::identity();
+				for(const_node_pointer Cur = node->left_child; Cur;){
+					if(comp(Cur->data, lo)){
+						Cur = Cur->right_child;
+					}else{
+						Left = monoid::combine(monoid::combine(monoid::lift(Cur->data), trait::aggregate(Cur->right_child)), Left);
+						Cur = Cur->left_child;
+					}
+				}
+				// symmetric, data less than hi on the right.
+				auto Right = monoid::identity();
+				for(const_node_pointer Cur = node->right_child; Cur;){
+					if(!comp(Cur->data, hi)){
+						Cur = Cur->left_child;
+					}else{
+						Right = monoid::combine(Right, monoid::combine(trait::aggregate(Cur->left_child), monoid::lift(Cur->data)));
+						Cur = Cur->right_child;
+					}
+				}
+				return monoid::combine(monoid::combine(Left, monoid::lift(node->data)), Right);
+			}
 		public:
 			static const_node_pointer left_most(const_node_pointer node){
 				if(!node){
@@ -681,11 +1155,17 @@ namespace ronleeon::tree {
 				}
 			}
 		protected:
-			explicit abstract_bs_tree(std::nullptr_t, Compare comp_ =  Compare{}):basic_type(nullptr), comp(comp_){}
+			explicit abstract_bs_tree(std::nullptr_t, Compare comp_ =  Compare{}, const Allocator& alloc = Allocator())
+				:basic_type(nullptr, alloc), comp(comp_){}
 		public:
-			abstract_bs_tree(Compare comp_ =  Compare{}):abstract_bs_tree(nullptr, comp_){};
+			abstract_bs_tree(Compare comp_ =  Compare{}, const Allocator& alloc = Allocator()):abstract_bs_tree(nullptr, comp_, alloc){};
 			abstract_bs_tree(const abstract_bs_tree&)=delete;
-			abstract_bs_tree(const DataType data[],size_t Size,Compare comp_ =  Compare{}):basic_type(nullptr, comp_){
+			abstract_bs_tree(const DataType data[],size_t Size,Compare comp_ =  Compare{}, const Allocator& alloc = Allocator())
+				:abstract_bs_tree(nullptr, comp_, alloc){
+				if(is_sorted_unique(data, data + Size)){
+					build_from_sorted(data, data + Size);
+					return;
+				}
 				for(size_t Index=0;Index<Size;++Index){	
 					insert(data[Index]);
 				}
@@ -728,83 +1208,89 @@ namespace ronleeon::tree {
 			// if bool is false, then the first is the node.(also may be null,empty tree)
 			// whose child(left or right) is the inserted position. 
 			std::pair<const_node_pointer,bool> find(const DataType& data)const{
-				if(basic_type::is_empty()){
-					return std::make_pair(nullptr,false);
-				}
-				const_node_pointer start=basic_type::get_root();
-				while(true){
-					if(comp(data,start->data)) {
-						if (start->left_child) {
-							start=start->left_child;
-						} else {
-							return std::make_pair(start,false);
-						}
-					}else if(comp(start->data,data)) {
-						if(start->right_child){
-							start=start->right_child;
-						}else {
-							return std::make_pair(start,false);
-						}
-					}else{
-						return std::make_pair(start,true);
-					}
+				return find_key(data);
+			}
+
+			// Heterogeneous lookup: a transparent Compare(declaring is_transparent) also orders data
+			// against other keys, data are then searched by such a key without building a DataType.
+			template<typename Key, typename C = Compare, typename = typename C::is_transparent>
+			std::pair<const_node_pointer,bool> find(const Key& key)const{
+				return find_key(key);
+			}
+
+			// Finger search: find() starting from finger, a node of this tree(null searches from the root).
+			// The search climbs from finger to the first ancestor whose subtree ranges over the data, only
+			// comparing the ancestors reached from their left(right) child for a greater(less) data, then
+			// descends from there. A data next to finger, or past max_node(min_node) as in a sorted stream,
+			// is then found in amortized O(1), any data in O(log n).
+			std::pair<const_node_pointer,bool> find_from(const_node_pointer finger, const DataType& data)const{
+				return find_key_from(finger, data);
+			}
+
+			// see find(const Key&).
+			template<typename Key, typename C = Compare, typename = typename C::is_transparent>
+			std::pair<const_node_pointer,bool> find_from(const_node_pointer finger, const Key& key)const{
+				return find_key_from(finger, key);
+			}
+
+			// try_emplace() searching from finger, see find_from.
+			template<typename Key, typename... Args>
+			std::pair<const_node_pointer,bool> try_emplace_from(const_node_pointer finger, const Key& key, Args&&... args){
+				auto find_result = find_key_from(finger, key);
+				if(find_result.second){
+					return std::make_pair(find_result.first, false);
 				}
+				node_pointer node = basic_type::allocate_node(std::in_place, std::forward<Args>(args)...);
+				link_new_node(const_cast<node_pointer>(find_result.first), node);
+				return std::make_pair(node, true);
 			}
 
-			
 			// insert the data if find it, ignored!
 			// the second returns whether insert operation is successful.
-			virtual std::pair<const_node_pointer,bool> insert(const DataType& data){
-				auto find_result=find(data);
+			// Trees restore their invariants in link_new_node.
+			std::pair<const_node_pointer,bool> insert(const DataType& data){
+				return try_emplace(data, data);
+			}
+
+			// the same, the data is moved into its node.
+			std::pair<const_node_pointer,bool> insert(DataType&& data){
+				return try_emplace(data, std::move(data));
+			}
+
+			// Construct the data from args directly in a new node(see node::abstract_bs_node),
+			// the node is released if the data is already here.
+			template<typename... Args>
+			std::pair<const_node_pointer,bool> emplace(Args&&... args){
+				node_pointer node = basic_type::allocate_node(std::in_place, std::forward<Args>(args)...);
+				auto find_result = find_key(node->data);
 				if(find_result.second){
-					find_result.second=false;
-					return find_result;
+					basic_type::deallocate_node(node);
+					return std::make_pair(find_result.first, false);
 				}
-				++basic_type::num_of_nodes;
-				if(!find_result.first){
-					// root.
-					basic_type::_root=new NodeType();
-					basic_type::_root->data = data;
-					find_result.first=basic_type::_root;
-					find_result.second=true;
-					min_node = max_node = basic_type::_root;
-					return find_result;
-				}
-				auto node=const_cast<node_pointer>(find_result.first);
-				// not equal
-				if(comp(data,node->data)){
-					assert(!node->left_child);
-					node->left_child=new NodeType();
-					node->left_child->data = data;
-					find_result.first=node->left_child;
-					find_result.second=true;
-					node->is_leaf=false;
-					node->left_child->parent=node;
-					++node->child_size;
-					node = node->left_child;
-				}else{
-					assert(!node->right_child);
-					node->right_child=new NodeType();
-					node->right_child->data = data;
-					find_result.first=node->right_child;
-					find_result.second=true;
-					node->is_leaf=false;
-					node->right_child->parent=node;
-					++node->child_size;
-					node = node->right_child;
-				}
-				// update min_node and max_node.
-				if(min_node&& (min_node->left_child == node)){
-					min_node = node;
-				}
-				if(max_node&&(max_node->right_child == node)){
-					max_node = node;
+				link_new_node(const_cast<node_pointer>(find_result.first), node);
+				return std::make_pair(node, true);
+			}
+
+			// Construct the data from args in a new node unless a data equal to key is here,
+			// then nothing is built. key orders as the data built, it is that data or a key of a
+			// transparent Compare(see find(const Key&)).
+			template<typename Key, typename... Args>
+			std::pair<const_node_pointer,bool> try_emplace(const Key& key, Args&&... args){
+				auto find_result = find_key(key);
+				if(find_result.second){
+					return std::make_pair(find_result.first, false);
 				}
-				basic_type::shift_height(node);
-				return find_result;
+				node_pointer node = basic_type::allocate_node(std::in_place, std::forward<Args>(args)...);
+				link_new_node(const_cast<node_pointer>(find_result.first), node);
+				return std::make_pair(node, true);
+			}
+
+			// The data of node was changed in place without changing its order(e.g. the value of a map
+			// entry): refresh the aggregates of node and of its ancestors.
+			void refresh_data(const_node_pointer node){
+				refresh_augmented_path(const_cast<node_pointer>(node));
 			}
 
-			
 			// erase has two replacement.
 			// returns the next node.
 			// when erased node has two children,
@@ -815,98 +1301,10 @@ namespace ronleeon::tree {
 				if(!node){
 					return nullptr;
 				}
-				--basic_type::num_of_nodes;
-				const_node_pointer Ret=increment(node);
-				// get the next node.
-				if(node->left_child&&node->right_child){
-					if(left){
-						auto left=left_most(node->left_child);
-						// cannot be empty.
-						node->data=left->data;
-						// now left do not have right_child.
-						node=const_cast<node_pointer>(left);
-					}else{
-						auto right=right_most(node->right_child);
-						// cannot be empty.
-						node->data=right->data;
-						// now right do not have right_child.
-						node=const_cast<node_pointer>(right);
-					}
-				}
-				// now node cannot have two childs.
-				node_pointer parent=node->parent;
-				node_pointer* point_to_node;
-				// newParent records the new min node when node is min_node
-				// records the new max node when node is max_node
-				const_node_pointer newParent = nullptr;
-				if(!parent){
-					// root.
-					point_to_node=nullptr;
-				}else if(node==parent->left_child){
-					point_to_node=(node_pointer*)&(parent->left_child);
-				}else{
-					point_to_node=(node_pointer*)&((parent->right_child));
-				}
-				if(node->is_leaf){
-					// delete directly.
-					if(point_to_node){
-						*point_to_node=nullptr;
-						--parent->child_size;
-						if(parent->child_size==0){
-							parent->is_leaf=true;
-						}
-						basic_type::shift_height(node->parent);
-					}else{
-						basic_type::_root=nullptr;
-					}
-					newParent = node->parent;
-					node->parent=nullptr;
-				}else if(node->left_child){
-					if(point_to_node){
-						node->left_child->parent=parent;
-						*point_to_node=node->left_child;
-						--parent->child_size;
-						if(parent->child_size==0){
-							parent->is_leaf=true;
-						}
-						basic_type::shift_height(node->parent);
-					}else{
-						basic_type::_root=node->left_child;
-						node->left_child->parent=nullptr;
-					}
-					newParent = node->left_child;
-					node->parent=nullptr;
-					node->left_child=nullptr;
-				}else if(node->right_child){
-					if(point_to_node){
-						node->right_child->parent=parent;
-						*point_to_node=node->right_child;
-						--parent->child_size;
-						if(parent->child_size==0){
-							parent->is_leaf=true;
-						}
-						basic_type::shift_height(node->parent);
-					}else{
-						basic_type::_root=node->right_child;
-						node->right_child->parent=nullptr;
-					}
-					newParent = node->right_child;
-					node->parent=nullptr;
-					node->right_child=nullptr;
-				}
-				if(basic_type::_root == nullptr){
-					// empty
-					min_node = max_node = nullptr;
-				}else{
-					if(node == min_node){
-						min_node = newParent;
-					}
-					if(node == max_node){
-						max_node = newParent;
-					}
-				}
-				
-				delete node;
+				const_node_pointer Ret;
+				node=erase_position(node,left,Ret);
+				cut_node(node);
+				basic_type::deallocate_node(node);
 				return Ret;
 			}
 
@@ -923,6 +1321,54 @@ namespace ronleeon::tree {
 				erase(find_result.first,left);
 			}
 
+			// Unlink node itself and hand it over, nothing is released and its data does not move:
+			// a node with two children first takes the place of its predecessor(see swap_with_predecessor).
+			node_handle_type extract(const_node_pointer node){
+				if(!node){
+					return node_handle_type();
+				}
+				auto position=const_cast<node_pointer>(node);
+				if(position->left_child&&position->right_child){
+					swap_with_predecessor(position);
+				}
+				cut_node(position);
+				reset_node(position);
+				return node_handle_type(position, basic_type::_alloc);
+			}
+
+			// Link the node of handle unless its data is here, the handle then gives the node up
+			// (otherwise it keeps it). The node comes from a tree of this type with an equal allocator.
+			std::pair<const_node_pointer,bool> insert(node_handle_type&& handle){
+				return insert_from(nullptr, std::move(handle));
+			}
+
+			// insert(node_handle_type&&) searching from finger, see find_from.
+			std::pair<const_node_pointer,bool> insert_from(const_node_pointer finger, node_handle_type&& handle){
+				assert(!handle.empty() && "Empty node handle!");
+				assert(handle.get_allocator() == basic_type::get_allocator() && "Trees with unequal allocators can't share nodes");
+				auto find_result = find_key_from(finger, handle.value());
+				if(find_result.second){
+					return std::make_pair(find_result.first, false);
+				}
+				node_pointer node = handle.release();
+				link_new_node(const_cast<node_pointer>(find_result.first), node);
+				return std::make_pair(node, true);
+			}
+
+			// whether [first, last) is strictly increasing, that is sorted without duplicates.
+			template<typename ForwardIt>
+			bool is_sorted_unique(ForwardIt first, ForwardIt last) const {
+				return std::adjacent_find(first, last, [this](const DataType& lhs, const DataType& rhs){
+					return !comp(lhs, rhs);
+				}) == last;
+			}
+
+			// Replace the content by the strictly increasing data of [first, last), see build_balanced.
+			template<typename ForwardIt>
+			void build_from_sorted(ForwardIt first, ForwardIt last){
+				build_balanced(first, last, [](node_pointer, size_t, size_t, int, int){});
+			}
+
 			// find the min and the max data. 
 			DataType min()const{
 				const auto find_result=left_most(basic_type::_root);
@@ -943,6 +1389,93 @@ namespace ronleeon::tree {
 				return max_node;
 			}
 
+			// Order statistics, in O(log n) with nodes keeping their subtree size(see node::sized_rb_node),
+			// otherwise by walking the data in order.
+
+			// the node holding the k-th smallest data(counting from 0), null if k >= size().
+			const_node_pointer select(size_t k) const {
+				if constexpr(node_bookkeeping::has_subtree_size){
+					const_node_pointer node = basic_type::_root;
+					while(node){
+						size_t Left = node_bookkeeping::subtree_size(node->left_child);
+						if(k < Left){
+							node = node->left_child;
+						}else if(k == Left){
+							return node;
+						}else{
+							k -= Left + 1;
+							node = node->right_child;
+						}
+					}
+					return nullptr;
+				}else{
+					const_node_pointer node = min_node;
+					for(; node && k != 0; --k){
+						node = increment(node);
+					}
+					return node;
+				}
+			}
+
+			// number of data less than data.
+			size_t rank(const DataType& data) const {
+				return rank_key(data);
+			}
+
+			// number of data less than key, see find(const Key&).
+			template<typename Key, typename C = Compare, typename = typename C::is_transparent>
+			size_t rank(const Key& key) const {
+				return rank_key(key);
+			}
+
+			// number of data in [lo, hi).
+			size_t count_range(const DataType& lo, const DataType& hi) const {
+				if(!comp(lo, hi)){
+					return 0;
+				}
+				return rank(hi) - rank(lo);
+			}
+
+			// Range aggregates of augmented nodes(see node::augmented_rb_node), in O(log n):
+			// the monoid combination of the lifted data in [lo, hi), in order.
+			template<typename N = NodeType>
+			typename node::augmentation_trait<N>::value_type aggregate(const DataType& lo, const DataType& hi) const {
+				if(!comp(lo, hi)){
+					return node::augmentation_trait<N>::monoid_type::identity();
+				}
+				return aggregate_key<N>(lo, hi);
+			}
+
+			// aggregate of the data in [lo, hi) of keys, see find(const Key&).
+			template<typename Key, typename N = NodeType, typename C = Compare, typename = typename C::is_transparent>
+			typename node::augmentation_trait<N>::value_type aggregate(const Key& lo, const Key& hi) const {
+				return aggregate_key<N>(lo, hi);
+			}
+
+			// aggregate of the whole tree, in O(1).
+			template<typename N = NodeType>
+			typename node::augmentation_trait<N>::value_type aggregate() const {
+				return node::augmentation_trait<N>::aggregate(basic_type::_root);
+			}
+
+			// number of data less than the data of node.
+			static size_t index_of(const_node_pointer node){
+				size_t Index = 0;
+				if constexpr(node_bookkeeping::has_subtree_size){
+					Index = node_bookkeeping::subtree_size(node->left_child);
+					for(const_node_pointer parent = node->parent; parent; node = parent, parent = node->parent){
+						if(node == parent->right_child){
+							Index += node_bookkeeping::subtree_size(parent->left_child) + 1;
+						}
+					}
+				}else{
+					for(node = decrement(node); node; node = decrement(node)){
+						++Index;
+					}
+				}
+				return Index;
+			}
+
 			static bool is_binary_search_tree(const_node_pointer root){
 				if(!root){
 					return true;
@@ -966,9 +1499,544 @@ namespace ronleeon::tree {
 			}
 
 
-			void destroy() override {
+		protected:
+			// A node was linked or unlinked below node(or its data changed): refresh the subtree sizes and
+			// aggregates of node and of all its ancestors, rotations done on the way keep their nodes on
+			// this path or refresh them.
+			static void refresh_augmented_path(node_pointer node){
+				if constexpr(node_bookkeeping::has_subtree_size||node_bookkeeping::has_aggregate){
+					for(; node; node = node->parent){
+						node_bookkeeping::refresh(node);
+					}
+				}
+			}
+
+			// Replace the content by the strictly increasing data of [first, last) in O(n), without any comparison
+			// or rotation: every node takes the middle of its range, so two sibling subtrees differ by at most
+			// one node and all empty links are on the last two levels(the deepest one is MaxDepth).
+			// Sub-classes set their balancing fields in shape(node, Depth, MaxDepth, LeftHeight, RightHeight),
+			// called once both subtrees of node are built, an empty subtree has height 0.
+			template<typename ForwardIt, typename Shape>
+			void build_balanced(ForwardIt first, ForwardIt last, Shape shape){
 				basic_type::destroy();
+				size_t Count = static_cast<size_t>(std::distance(first, last));
+				if(Count == 0){
+					return;
+				}
+				size_t MaxDepth = 0;
+				for(size_t Nodes = Count; Nodes > 1; Nodes /= 2){
+					++MaxDepth;
+				}
+				try{
+					int Height;
+					build_balanced_subtree(first, Count, nullptr, true, 0, MaxDepth, shape, Height);
+				}catch(...){
+					// every node built so far is linked to the tree.
+					basic_type::destroy();
+					throw;
+				}
+				basic_type::num_of_nodes = Count;
+				min_node = left_most(basic_type::_root);
+				max_node = right_most(basic_type::_root);
+			}
+
+			// build the subtree of the next Count data as the left(or right) child of parent(the root if null).
+			template<typename ForwardIt, typename Shape>
+			node_pointer build_balanced_subtree(ForwardIt& first, size_t Count, node_pointer parent, bool left, size_t Depth
+				, size_t MaxDepth, Shape& shape, int& Height){
+				if(Count == 0){
+					Height = 0;
+					return nullptr;
+				}
+				node_pointer node = basic_type::allocate_node();
+				if(!parent){
+					basic_type::_root = node;
+				}else if(left){
+					parent->left_child = node;
+				}else{
+					parent->right_child = node;
+				}
+				node->parent = parent;
+				int LeftHeight, RightHeight;
+				build_balanced_subtree(first, (Count - 1) / 2, node, true, Depth + 1, MaxDepth, shape, LeftHeight);
+				node->data = *first;
+				++first;
+				build_balanced_subtree(first, Count / 2, node, false, Depth + 1, MaxDepth, shape, RightHeight);
+				Height = std::max(LeftHeight, RightHeight) + 1;
+				node_bookkeeping::refresh(node);
+				if constexpr(node_bookkeeping::has_height){
+					node->height = Height - 1;
+				}
+				shape(node, Depth, MaxDepth, LeftHeight, RightHeight);
+				return node;
+			}
+
+			// Join based set algebra, after "Just Join for Parallel Ordered Sets" (Blelloch, Ferizovic, Sun):
+			// split, union, intersection and difference only rely on joining two subtrees around a node,
+			// which is the one thing every balancing scheme does its own way. Sub-classes describe it by a
+			// Join policy working on subtrees with a rank(AVL: height, RB: black height):
+			//   int rank(const_node_pointer root): the rank of a whole tree, in O(log n).
+			//   int child_rank(const_node_pointer node, int Rank, bool left): the rank of a child of node.
+			//   node_pointer join(node_pointer l, int LeftRank, node_pointer k, node_pointer r, int RightRank, int& Rank):
+			//     link l < k < r into a balanced tree in O(|LeftRank - RightRank| + 1), k is a detached node.
+			// Nodes only move between subtrees, nothing is allocated. Unions run in O(m log(n/m + 1)) work
+			// (m <= n are the sizes), the two halves of large subproblems run in parallel: Compare must
+			// be safe to call from several threads.
+			struct join_subtree{
+				node_pointer root = nullptr;
+				int rank = 0;
+			};
+
+			// State of one task: nodes left out of the result (chained like a teardown stack,
+			// bottom kept to append the list of another task in O(1)) and the number of data found in both trees.
+			struct join_context{
+				node_pointer dropped = nullptr;
+				node_pointer dropped_bottom = nullptr;
+				size_t matches = 0;
+			};
+
+			// subproblems of fewer nodes are not worth a thread.
+			static constexpr size_t DefaultParallelGrain = size_t(1) << 14;
+
+			// make left and right the children of node, its bookkeeping fields are refreshed.
+			static void link_children(node_pointer node, node_pointer left, node_pointer right){
+				node->left_child = left;
+				node->right_child = right;
+				if(left){
+					left->parent = node;
+				}
+				if(right){
+					right->parent = node;
+				}
+				node_bookkeeping::refresh(node);
+				if constexpr(node_bookkeeping::has_height){
+					node->height = std::max(left ? static_cast<size_t>(left->height) + 1 : 0
+						, right ? static_cast<size_t>(right->height) + 1 : 0);
+				}
+			}
+
+			// drop a subtree(or a detached node) from the result, it is released once all tasks are done.
+			static void drop_subtree(join_context& Ctx, node_pointer node){
+				if(!node){
+					return;
+				}
+				if(!Ctx.dropped){
+					Ctx.dropped_bottom = node;
+				}
+				Ctx.dropped = basic_type::push_teardown(Ctx.dropped, node);
+			}
+
+			static node_pointer detach_children(node_pointer node){
+				node->left_child = node->right_child = nullptr;
+				return node;
+			}
+
+			// append what another task dropped and found.
+			static void merge_context(join_context& Ctx, join_context& Other){
+				Ctx.matches += Other.matches;
+				if(!Other.dropped){
+					return;
+				}
+				Other.dropped_bottom->parent = Ctx.dropped;
+				if(!Ctx.dropped){
+					Ctx.dropped_bottom = Other.dropped_bottom;
+				}
+				Ctx.dropped = Other.dropped;
+			}
+
+			// How many times subproblems of Nodes nodes can still be halved into two tasks:
+			// twice as many tasks as hardware threads, since the second tree splits unevenly.
+			static size_t parallel_depth(size_t Nodes, size_t ParallelGrain){
+				size_t Tasks = 2 * std::max<size_t>(std::thread::hardware_concurrency(), 1);
+				size_t Depth = 0;
+				while((size_t(1) << Depth) < Tasks && (Nodes >> (Depth + 1)) >= std::max<size_t>(ParallelGrain, 1)){
+					++Depth;
+				}
+				return Depth;
+			}
+
+			// run both tasks(on another thread for the right one while Depth allows it), return their results.
+			template<typename LeftTask, typename RightTask>
+			static std::pair<join_subtree, join_subtree> fork_join(join_context& Ctx, size_t Depth, LeftTask left, RightTask right){
+				if(Depth == 0){
+					join_subtree Left = left(Ctx, 0);
+					return {Left, right(Ctx, 0)};
+				}
+				join_context RightCtx;
+				auto Right = std::async(std::launch::async, [&right, &RightCtx, Depth]{
+					return right(RightCtx, Depth - 1);
+				});
+				join_subtree Left = left(Ctx, Depth - 1);
+				std::pair<join_subtree, join_subtree> Ret{Left, Right.get()};
+				merge_context(Ctx, RightCtx);
+				return Ret;
+			}
+
+			template<typename Join>
+			static join_subtree join_node(const Join& join, join_subtree left, node_pointer node, join_subtree right){
+				join_subtree Ret;
+				Ret.root = join.join(left.root, left.rank, node, right.root, right.rank, Ret.rank);
+				return Ret;
+			}
+
+			// tree into the data less than key, the node holding key(detached, if any) and the data greater.
+			template<typename Join>
+			void split_subtree(const Join& join, join_subtree tree, const DataType& key
+				, join_subtree& Less, node_pointer& Found, join_subtree& Greater) const {
+				if(!tree.root){
+					Less = Greater = join_subtree{};
+					Found = nullptr;
+					return;
+				}
+				node_pointer node = tree.root;
+				join_subtree Left{node->left_child, join.child_rank(node, tree.rank, true)};
+				join_subtree Right{node->right_child, join.child_rank(node, tree.rank, false)};
+				if(comp(key, node->data)){
+					join_subtree Rest;
+					split_subtree(join, Left, key, Less, Found, Rest);
+					Greater = join_node(join, Rest, node, Right);
+				}else if(comp(node->data, key)){
+					join_subtree Rest;
+					split_subtree(join, Right, key, Rest, Found, Greater);
+					Less = join_node(join, Left, node, Rest);
+				}else{
+					Less = Left;
+					Greater = Right;
+					Found = detach_children(node);
+				}
+			}
+
+			// tree without its last node, which is returned in Last.
+			template<typename Join>
+			static join_subtree split_last(const Join& join, join_subtree tree, node_pointer& Last){
+				node_pointer node = tree.root;
+				join_subtree Left{node->left_child, join.child_rank(node, tree.rank, true)};
+				join_subtree Right{node->right_child, join.child_rank(node, tree.rank, false)};
+				if(!Right.root){
+					Last = node;
+					return Left;
+				}
+				join_subtree Rest = split_last(join, Right, Last);
+				return join_node(join, Left, node, Rest);
+			}
+
+			// join two subtrees, all data of left less than the data of right.
+			template<typename Join>
+			static join_subtree join_subtrees(const Join& join, join_subtree left, join_subtree right){
+				if(!left.root){
+					return right;
+				}
+				if(!right.root){
+					return left;
+				}
+				node_pointer Last;
+				join_subtree Rest = split_last(join, left, Last);
+				return join_node(join, Rest, Last, right);
+			}
+
+			// data of a or b, the node of a is kept when both have it.
+			template<typename Join>
+			join_subtree union_subtrees(const Join& join, join_subtree a, join_subtree b, join_context& Ctx, size_t Depth) const {
+				if(!a.root){
+					return b;
+				}
+				if(!b.root){
+					return a;
+				}
+				node_pointer node = a.root;
+				join_subtree Left{node->left_child, join.child_rank(node, a.rank, true)};
+				join_subtree Right{node->right_child, join.child_rank(node, a.rank, false)};
+				join_subtree Less, Greater;
+				node_pointer Found;
+				split_subtree(join, b, node->data, Less, Found, Greater);
+				if(Found){
+					++Ctx.matches;
+					drop_subtree(Ctx, Found);
+				}
+				auto [L, R] = fork_join(Ctx, Depth
+					, [&](join_context& C, size_t D){ return union_subtrees(join, Left, Less, C, D); }
+					, [&](join_context& C, size_t D){ return union_subtrees(join, Right, Greater, C, D); });
+				return join_node(join, L, node, R);
+			}
+
+			// data of both a and b, nodes of a are kept.
+			template<typename Join>
+			join_subtree intersect_subtrees(const Join& join, join_subtree a, join_subtree b, join_context& Ctx, size_t Depth) const {
+				if(!a.root || !b.root){
+					drop_subtree(Ctx, a.root);
+					drop_subtree(Ctx, b.root);
+					return join_subtree{};
+				}
+				node_pointer node = a.root;
+				join_subtree Left{node->left_child, join.child_rank(node, a.rank, true)};
+				join_subtree Right{node->right_child, join.child_rank(node, a.rank, false)};
+				join_subtree Less, Greater;
+				node_pointer Found;
+				split_subtree(join, b, node->data, Less, Found, Greater);
+				auto [L, R] = fork_join(Ctx, Depth
+					, [&](join_context& C, size_t D){ return intersect_subtrees(join, Left, Less, C, D); }
+					, [&](join_context& C, size_t D){ return intersect_subtrees(join, Right, Greater, C, D); });
+				if(Found){
+					++Ctx.matches;
+					drop_subtree(Ctx, Found);
+					return join_node(join, L, node, R);
+				}
+				drop_subtree(Ctx, detach_children(node));
+				return join_subtrees(join, L, R);
+			}
+
+			// data of a not in b.
+			template<typename Join>
+			join_subtree difference_subtrees(const Join& join, join_subtree a, join_subtree b, join_context& Ctx, size_t Depth) const {
+				if(!a.root || !b.root){
+					drop_subtree(Ctx, b.root);
+					return a;
+				}
+				node_pointer node = b.root;
+				join_subtree Left{node->left_child, join.child_rank(node, b.rank, true)};
+				join_subtree Right{node->right_child, join.child_rank(node, b.rank, false)};
+				join_subtree Less, Greater;
+				node_pointer Found;
+				split_subtree(join, a, node->data, Less, Found, Greater);
+				if(Found){
+					++Ctx.matches;
+					drop_subtree(Ctx, Found);
+				}
+				auto [L, R] = fork_join(Ctx, Depth
+					, [&](join_context& C, size_t D){ return difference_subtrees(join, Less, Left, C, D); }
+					, [&](join_context& C, size_t D){ return difference_subtrees(join, Greater, Right, C, D); });
+				drop_subtree(Ctx, detach_children(node));
+				return join_subtrees(join, L, R);
+			}
+
+			// make the subtree the content of this tree, Size nodes.
+			void adopt_subtree(join_subtree tree, size_t Size){
+				if(tree.root){
+					tree.root->parent = nullptr;
+				}
+				basic_type::_root = tree.root;
+				basic_type::num_of_nodes = Size;
+				min_node = left_most(basic_type::_root);
+				max_node = right_most(basic_type::_root);
+			}
+
+			// Detach the nodes of both trees and run operation on them, other is left empty.
+			// Nodes of other are moved into this tree, so both must share their allocator,
+			// otherwise other is first copied with this allocator(O(m) more work) and released.
+			template<typename Join, typename Operation>
+			join_subtree run_set_operation(const Join& join, abstract_bs_tree& other, size_t ParallelGrain
+				, Operation operation, size_t& Matches){
+				assert(&other != this && "Set operations need two trees");
+				if(!(basic_type::_alloc == other._alloc)){
+					std::vector<DataType> Data;
+					Data.reserve(other.size());
+					for(auto node = other.min_node; node; node = increment(node)){
+						Data.push_back(node->data);
+					}
+					other.destroy();
+					TreeType Copy(comp, basic_type::get_allocator());
+					Copy.build_from_sorted(Data.begin(), Data.end());
+					return run_set_operation(join, static_cast<abstract_bs_tree&>(Copy), ParallelGrain, operation, Matches);
+				}
+				size_t Nodes = basic_type::size() + other.size();
+				node_pointer a = detach_nodes();
+				node_pointer b = other.detach_nodes();
+				join_context Ctx;
+				join_subtree Result = operation(join_subtree{a, join.rank(a)}, join_subtree{b, join.rank(b)}
+					, Ctx, parallel_depth(Nodes, ParallelGrain));
+				basic_type::release_teardown(basic_type::_alloc, Ctx.dropped);
+				Matches = Ctx.matches;
+				return Result;
+			}
+
+			// Add the data of other to this tree, other is left empty. Data already here is kept.
+			template<typename Join>
+			void union_of(const Join& join, abstract_bs_tree& other, size_t ParallelGrain){
+				size_t Total = basic_type::size() + other.size();
+				size_t Matches;
+				join_subtree Result = run_set_operation(join, other, ParallelGrain
+					, [this, &join](join_subtree a, join_subtree b, join_context& Ctx, size_t Depth){
+						return union_subtrees(join, a, b, Ctx, Depth);
+					}, Matches);
+				adopt_subtree(Result, Total - Matches);
+			}
+
+			// Keep the data also in other, other is left empty.
+			template<typename Join>
+			void intersection_of(const Join& join, abstract_bs_tree& other, size_t ParallelGrain){
+				size_t Matches;
+				join_subtree Result = run_set_operation(join, other, ParallelGrain
+					, [this, &join](join_subtree a, join_subtree b, join_context& Ctx, size_t Depth){
+						return intersect_subtrees(join, a, b, Ctx, Depth);
+					}, Matches);
+				adopt_subtree(Result, Matches);
+			}
+
+			// Erase the data also in other, other is left empty.
+			template<typename Join>
+			void difference_of(const Join& join, abstract_bs_tree& other, size_t ParallelGrain){
+				size_t Size = basic_type::size();
+				size_t Matches;
+				join_subtree Result = run_set_operation(join, other, ParallelGrain
+					, [this, &join](join_subtree a, join_subtree b, join_context& Ctx, size_t Depth){
+						return difference_subtrees(join, a, b, Ctx, Depth);
+					}, Matches);
+				adopt_subtree(Result, Size - Matches);
+			}
+
+			// Append the data of greater(all greater than the data here) in O(log n), greater is left empty.
+			template<typename Join>
+			void join_with(const Join& join, abstract_bs_tree& greater){
+				assert(basic_type::_alloc == greater._alloc && "Joined trees must share their allocator");
+				assert((!max_node || !greater.min_node || comp(max_node->data, greater.min_node->data))
+					&& "Joined tree must hold greater data");
+				size_t Size = basic_type::size() + greater.size();
+				node_pointer a = detach_nodes();
+				node_pointer b = greater.detach_nodes();
+				adopt_subtree(join_subtrees(join, join_subtree{a, join.rank(a)}, join_subtree{b, join.rank(b)}), Size);
+			}
+
+			// Move the data not less than key to greater(its content is released first) in O(log n),
+			// without subtree sizes in the nodes the parts are recounted by walking both in step, in O(min(size of each part)).
+			// Returns whether key was here.
+			template<typename Join>
+			bool split_at(const Join& join, const DataType& key, abstract_bs_tree& greater){
+				assert(basic_type::_alloc == greater._alloc && "Split trees must share their allocator");
+				assert(&greater != this && "Can not split a tree into itself");
+				greater.destroy();
+				size_t Size = basic_type::size();
+				node_pointer root = detach_nodes();
+				join_subtree Less, Greater;
+				node_pointer Found;
+				split_subtree(join, join_subtree{root, join.rank(root)}, key, Less, Found, Greater);
+				if(Found){
+					Greater = join_node(join, join_subtree{}, Found, Greater);
+				}
+				for(node_pointer part:{Less.root, Greater.root}){
+					if(part){
+						part->parent = nullptr;
+					}
+				}
+				size_t LessSize;
+				if constexpr(node_bookkeeping::has_subtree_size){
+					LessSize = node_bookkeeping::subtree_size(Less.root);
+				}else{
+					size_t Steps = 0;
+					const_node_pointer a = left_most(Less.root), b = left_most(Greater.root);
+					for(; a && b; ++Steps){
+						a = increment(a);
+						b = increment(b);
+					}
+					LessSize = a ? Size - Steps : Steps;
+				}
+				adopt_subtree(Less, LessSize);
+				greater.adopt_subtree(Greater, Size - LessSize);
+				return Found != nullptr;
+			}
+
+		protected:
+			// Find the node erase really unlinks: node itself if it has at most one child,
+			// otherwise its in-order predecessor (left) or successor whose data moves into node.
+			// Next receives the node holding the data following the erased one.
+			node_pointer erase_position(node_pointer node,bool left,const_node_pointer& Next){
+				Next=increment(node);
+				if(node->left_child&&node->right_child){
+					auto replace=const_cast<node_pointer>(left?right_most(node->left_child):left_most(node->right_child));
+					// replace has at most one child now.
+					node->data=std::move(replace->data);
+					if(!left){
+						Next=node;
+					}
+					node=replace;
+				}
+				return node;
+			}
+
+			// Unlink node, having at most one child(see erase_position), and restore the invariants
+			// above it, the node is not released. Trees rebalance here.
+			virtual void cut_node(node_pointer node){
+				--basic_type::num_of_nodes;
+				node_pointer parent=unlink_node(node);
+				basic_type::shift_height(parent);
+				refresh_augmented_path(parent);
+			}
+
+			// Balancing trees keep per node fields(color, balance factor) belonging to the place of the node
+			// in the tree: two nodes exchanging places swap them, a node leaving the tree gets those of a new one.
+			virtual void swap_balance(node_pointer, node_pointer){}
+			virtual void reset_balance(node_pointer){}
+
+			// node, having two children, and its in-order predecessor exchange their places(links, heights
+			// and balancing fields), node then has at most one child. No data moves.
+			void swap_with_predecessor(node_pointer node){
+				auto pred=const_cast<node_pointer>(right_most(node->left_child));
+				node_pointer parent=node->parent;
+				node_pointer left=node->left_child;
+				node_pointer right=node->right_child;
+				node_pointer predParent=pred->parent;
+				node_pointer predLeft=pred->left_child;
+				basic_type::replace_child(parent,node,pred);
+				pred->right_child=right;
+				right->parent=pred;
+				if(predParent==node){
+					pred->left_child=node;
+					node->parent=pred;
+				}else{
+					pred->left_child=left;
+					left->parent=pred;
+					predParent->right_child=node;
+					node->parent=predParent;
+				}
+				node->left_child=predLeft;
+				if(predLeft){
+					predLeft->parent=node;
+				}
+				node->right_child=nullptr;
+				// the predecessor may be the minimum, never the maximum.
+				if(pred==min_node){
+					min_node=node;
+				}
+				if constexpr(node_bookkeeping::has_height){
+					auto Height=node->height;
+					node->height=pred->height;
+					pred->height=Height;
+				}
+				swap_balance(node,pred);
+				node_bookkeeping::refresh(node);
+				node_bookkeeping::refresh(pred);
+			}
+
+			// Reset an unlinked node in place as a new leaf around its own data, nothing is moved or allocated.
+			void reset_node(node_pointer node){
+				node->parent=node->left_child=node->right_child=nullptr;
+				if constexpr(node_bookkeeping::has_height){
+					node->height=0;
+				}
+				node_bookkeeping::refresh(node);
+				reset_balance(node);
+			}
+
+			// Unlink node (having at most one child, which takes its place) and keep min_node and
+			// max_node up to date, returns the former parent of node.
+			node_pointer unlink_node(node_pointer node){
+				node_pointer parent=node->parent;
+				node_pointer child=node->left_child?node->left_child:node->right_child;
+				if(node == min_node){
+					// min node has no left child.
+					min_node = child?left_most(child):parent;
+				}
+				if(node == max_node){
+					// max node has no right child.
+					max_node = child?right_most(child):parent;
+				}
+				basic_type::replace_child(parent,node,child);
+				node->parent=node->left_child=node->right_child=nullptr;
+				return parent;
+			}
+
+			node_pointer detach_nodes() override {
 				min_node = max_node = nullptr;
+				return basic_type::detach_nodes();
 			}
 
 		};
@@ -19,8 +19,8 @@ namespace ronleeon::tree{
 				os << t->data;
 			}
 			os << "]  ";
-			os<<"[Height:"<<t->height<<"] ";
-			if (t->is_leaf) {
+			os<<"[Height:"<<node::node_bookkeeping<NodeType>::height(t)<<"] ";
+			if (node::node_bookkeeping<NodeType>::is_leaf(t)) {
 				os << "Leaf";
 			}
 			else {
@@ -33,7 +33,7 @@ namespace ronleeon::tree{
 			}else if(!t->left_child&&t->right_child){
 				os<<" has right child";
 			}
-			os<<" ,balance factor:"<<t->balance_factor;
+			os<<" ,balance factor:"<<node::avl_balance_trait<NodeType>::balance_factor(t);
 		}
 	};
 	// NOTICE:DataType must be comparable.
@@ -43,11 +43,12 @@ namespace ronleeon::tree{
 
 	// Guarantee all NodeType data are not equal,otherwise the latter
 	// will be ignored.
-	template<typename DataType,typename Compare=std::less<DataType>,typename NodeType=node::avl_node<DataType>,typename NodePrintTrait = avl_node_print_trait<NodeType>>
+	template<typename DataType,typename Compare=std::less<DataType>,typename NodeType=node::avl_node<DataType>,typename NodePrintTrait = avl_node_print_trait<NodeType>
+		,typename Allocator = std::allocator<DataType>>
 	class avl_tree:public abstract_bs_tree<DataType,Compare,NodeType
-		,avl_tree<DataType,Compare,NodeType,NodePrintTrait>, NodePrintTrait>{
+		,avl_tree<DataType,Compare,NodeType,NodePrintTrait,Allocator>, NodePrintTrait,Allocator>{
 		using basic_type=abstract_bs_tree<DataType,Compare,NodeType
-			,avl_tree<DataType,Compare,NodeType,NodePrintTrait>, NodePrintTrait>;
+			,avl_tree<DataType,Compare,NodeType,NodePrintTrait,Allocator>, NodePrintTrait,Allocator>;
 		// prohibit all create functions.
 		using basic_type::shift_height;
 
@@ -62,61 +63,48 @@ namespace ronleeon::tree{
 		using PrintTrait = typename basic_type::PrintTrait;
 	private:
 
-		explicit avl_tree(std::nullptr_t,Compare comp_ = Compare{} ):basic_type(nullptr, comp_){}
+		explicit avl_tree(std::nullptr_t,Compare comp_ = Compare{}, const Allocator& alloc = Allocator() ):basic_type(nullptr, comp_, alloc){}
 
-		void shift_avl_node(node_pointer node){
-			while(node){
-				size_t left_height=0,right_height=0;
-				if(node->left_child&&node->right_child){
-					left_height=node->left_child->height;
-					right_height=node->right_child->height;
-					node->height=std::max(left_height,right_height)+1;
-					node->balance_factor=left_height-right_height;
-					node->is_leaf=false;
-					node->child_size=2;
-				}else if(node->left_child){
-					node->height=node->left_child->height+1;
-					node->balance_factor=node->height;
-					node->is_leaf=false;
-					node->child_size=1;
-				}else if(node->right_child){
-					node->height=node->right_child->height+1;
-					node->balance_factor=-node->height;
-					node->is_leaf=false;
-					node->child_size=1;
-				}else{
-					node->is_leaf=true;
-					node->height=0;
-					node->child_size=0;
-					node->balance_factor=0;
-				}
-				node=node->parent;
-			}
+		// balance factors are read and written through the trait, tagged nodes have no field for it.
+		static int balance_factor(const_node_pointer node){
+			return node::avl_balance_trait<NodeType>::balance_factor(node);
+		}
+		static void set_balance_factor(node_pointer node,int balance_factor){
+			node::avl_balance_trait<NodeType>::set_balance_factor(node,balance_factor);
+		}
 
+		// an empty subtree counts 0, a leaf 1.
+		static int subtree_height(const_node_pointer node){
+			return node?static_cast<int>(basic_type::node_bookkeeping::height(node))+1:0;
 		}
-		// four rotate operations.
 
+		// Balancing only relies on balance factors, nodes keeping bookkeeping fields
+		// (height, is_leaf...) get them refreshed from their children here.
+		static void refresh_node(node_pointer node){
+			basic_type::node_bookkeeping::refresh(node);
+			if constexpr(basic_type::node_bookkeeping::has_height){
+				node->height=std::max(subtree_height(node->left_child),subtree_height(node->right_child));
+			}
+		}
 
-		void left_rotation(node_pointer node){
-			node_pointer right=node->right_child;
-			node_pointer left=(right)->left_child;
-			node_pointer parent=node->parent;
-			node_pointer* point_to_node=nullptr;
-			if(parent){
-				if(node==(parent)->left_child){
-					point_to_node=(node_pointer*)&(parent->left_child);
-				}else{
-					point_to_node=(node_pointer*)&(parent->right_child);
+		// refresh node and all its ancestors.
+		static void refresh_path(node_pointer node){
+			if constexpr(basic_type::node_bookkeeping::has_height||basic_type::node_bookkeeping::has_child_size
+				||basic_type::node_bookkeeping::has_is_leaf||basic_type::node_bookkeeping::has_subtree_size
+				||basic_type::node_bookkeeping::has_aggregate){
+				while(node){
+					refresh_node(node);
+					node=node->parent;
 				}
 			}
-			if(point_to_node){
-				*point_to_node=right;
-				right->parent=parent;
-			}else{
-				// node is the root.
-				basic_type::_root=right;
-				right->parent=nullptr;
-			}
+		}
+
+		// two rotate operations, balance factors are fixed by the callers.
+		// return the new root of the subtree.
+		node_pointer left_rotation(node_pointer node){
+			node_pointer right=node->right_child;
+			node_pointer left=(right)->left_child;
+			basic_type::replace_child(node->parent,node,right);
 			node->right_child=left;
 			if(left){
 				left->parent=node;
@@ -124,30 +112,15 @@ namespace ronleeon::tree{
 			right->left_child=node;
 			node->parent=right;
 			// others.
-			shift_avl_node(node);
-			shift_avl_node(right);
+			refresh_node(node);
+			refresh_node(right);
+			return right;
 		}
 		
-		void right_rotation(node_pointer node){
+		node_pointer right_rotation(node_pointer node){
 			node_pointer left=node->left_child;
 			node_pointer right=left->right_child;
-			node_pointer parent=node->parent;
-			node_pointer* point_to_node=nullptr;
-			if(parent){
-				if(node==parent->left_child){
-					point_to_node=(node_pointer*)&(parent->left_child);
-				}else{
-					point_to_node=(node_pointer*)&(parent->right_child);
-				}
-			}
-			if(point_to_node){
-				*point_to_node=left;
-				left->parent=parent;
-			}else{
-				// node is the root.
-				basic_type::_root=left;
-				left->parent=nullptr;
-			}
+			basic_type::replace_child(node->parent,node,left);
 			node->left_child=right;
 			if(right){
 				right->parent=node;
@@ -155,99 +128,70 @@ namespace ronleeon::tree{
 			left->right_child=node;
 			node->parent=left;
 			// others.
-			shift_avl_node(node);
-			shift_avl_node(left);
-
-		}
-		void left_right_rotation(node_pointer node){
-			left_rotation(node->left_child);
-			right_rotation(node);
-		}
-		void right_left_rotation(node_pointer node){
-			right_rotation(node->right_child);
-			left_rotation(node);
+			refresh_node(node);
+			refresh_node(left);
+			return left;
 		}
 
-		void rebalance(node_pointer node){
-			while(node){
-				if(node->balance_factor< -1){
-					if((node->right_child)->balance_factor<0){
-						left_rotation(node);
-					}else if((node->right_child)->balance_factor>0){
-						right_left_rotation(node);
-					}
-				}else if(node->balance_factor>1){
-					if((node->left_child)->balance_factor>0){
-						right_rotation(node);
-					}else if((node->left_child)->balance_factor<0 ){
-						left_right_rotation(node);
-					}
-				}
-				node=node->parent;
+		// node is higher by 2 on its left side, returns the new root of the subtree.
+		node_pointer rebalance_left(node_pointer node){
+			node_pointer left=node->left_child;
+			int left_balance=balance_factor(left);
+			if(left_balance>=0){
+				// after erasing, the left child may be balanced, the subtree keeps its height then.
+				node_pointer root=right_rotation(node);
+				set_balance_factor(node,left_balance==0?1:0);
+				set_balance_factor(root,left_balance==0?-1:0);
+				return root;
 			}
-		}
-	public:
-		avl_tree(Compare comp_ = Compare{} ):avl_tree(nullptr, comp_){};
-		avl_tree(const avl_tree&)=delete;
-		avl_tree(const DataType data[],size_t Size,Compare comp_ = Compare{} ):basic_type(data,Size,comp_){
-		}
-		avl_tree(avl_tree && tree):basic_type(std::move(tree)) {}
-
-		std::string to_string()const override {
-			return "<-AVL(Adelson,Velsky,Landis) Tree->";
+			node_pointer pivot=left->right_child;
+			int pivot_balance=balance_factor(pivot);
+			left_rotation(left);
+			node_pointer root=right_rotation(node);
+			set_balance_factor(left,pivot_balance<0?1:0);
+			set_balance_factor(node,pivot_balance>0?-1:0);
+			set_balance_factor(root,0);
+			return root;
 		}
 
-		static bool is_balanced(const_node_pointer root){
-			if(!root){
-				return true;
-			}
-			if(root->balance_factor>-2&&root->balance_factor<2){
-				return is_balanced(root->left_child)&&is_balanced(root->right_child);
-			}else{
-				return false;
+		// symmetric.
+		node_pointer rebalance_right(node_pointer node){
+			node_pointer right=node->right_child;
+			int right_balance=balance_factor(right);
+			if(right_balance<=0){
+				node_pointer root=left_rotation(node);
+				set_balance_factor(node,right_balance==0?-1:0);
+				set_balance_factor(root,right_balance==0?1:0);
+				return root;
 			}
+			node_pointer pivot=right->left_child;
+			int pivot_balance=balance_factor(pivot);
+			right_rotation(right);
+			node_pointer root=left_rotation(node);
+			set_balance_factor(right,pivot_balance>0?-1:0);
+			set_balance_factor(node,pivot_balance<0?1:0);
+			set_balance_factor(root,0);
+			return root;
 		}
 
-		// insert the data if find it, ignored!
-		// the second returns whether insert operation is successful.
-		std::pair<const_node_pointer,bool> insert(const DataType& data) override {
-			auto find_result=basic_type::find(data);
-			if(find_result.second){
-				find_result.second=false;
-				return find_result;
-			}
+		// the new node is a leaf, the heights above it are retraced.
+		void link_new_node(node_pointer parent, node_pointer node) override {
 			++basic_type::num_of_nodes;
-			if(!find_result.first){
+			if(!parent){
 				// root.
-				basic_type::_root=new NodeType();
-				basic_type::_root->data = data;
-				find_result.first=basic_type::_root;
-				find_result.second=true;
-				basic_type::min_node = basic_type::max_node = basic_type::_root;
-				return find_result;
+				basic_type::_root=node;
+				basic_type::min_node = basic_type::max_node = node;
+				refresh_path(node);
+				return;
 			}
-			auto node=const_cast<node_pointer>(find_result.first);
-			if(basic_type::comp(data,node->data)){
-				assert(!node->left_child);
-				node->left_child=new NodeType();
-				node->left_child->data = data;
-				find_result.first=node->left_child;
-				find_result.second=true;
-				node->is_leaf=false;
-				node->left_child->parent=node;
-				++node->child_size;
-				node = node->left_child;
+			if(basic_type::comp(node->data,parent->data)){
+				assert(!parent->left_child);
+				parent->left_child=node;
 			}else{
-				assert(!node->right_child);
-				node->right_child=new NodeType();
-				node->right_child->data = data;
-				find_result.first=node->right_child;
-				find_result.second=true;
-				node->is_leaf=false;
-				node->right_child->parent=node;
-				++node->child_size;
-				node = node->right_child;
+				assert(!parent->right_child);
+				parent->right_child=node;
 			}
+			node->parent=parent;
 			// update min_node and max_node.
 			if(basic_type::min_node&& (basic_type::min_node->left_child == node)){
 				basic_type::min_node = node;
@@ -255,114 +199,238 @@ namespace ronleeon::tree{
 			if(basic_type::max_node&&(basic_type::max_node->right_child == node)){
 				basic_type::max_node = node;
 			}
-			shift_avl_node(node);
-			rebalance(node);
-			return find_result;
+			retrace_after_insert(node);
+			refresh_path(node);
+		}
+
+		// node can not have two children, the heights above it are retraced once it is unlinked.
+		void cut_node(node_pointer node) override {
+			--basic_type::num_of_nodes;
+			bool left_shrank=node->parent&&node==node->parent->left_child;
+			node_pointer parent=basic_type::unlink_node(node);
+			retrace_after_erase(parent,left_shrank);
+			refresh_path(parent);
+		}
+
+		// balance factors belong to the place of a node, a node leaving the tree is balanced like a new one.
+		void swap_balance(node_pointer lhs, node_pointer rhs) override {
+			int Balance=balance_factor(lhs);
+			set_balance_factor(lhs,balance_factor(rhs));
+			set_balance_factor(rhs,Balance);
 		}
 
-		const_node_pointer erase(const_node_pointer node, bool left = true){
-            return erase(const_cast<node_pointer>(node), left);
-        }
+		void reset_balance(node_pointer node) override {
+			set_balance_factor(node,0);
+		}
 
-		const_node_pointer erase(node_pointer node,bool left=true) override {
-			if(!node){
-				return nullptr;
+		// the subtree of node grew by one, walk up until some subtree absorbs it.
+		void retrace_after_insert(node_pointer node){
+			for(node_pointer parent=node->parent;parent;node=parent,parent=node->parent){
+				int balance=balance_factor(parent)+(node==parent->left_child?1:-1);
+				if(balance==0){
+					set_balance_factor(parent,0);
+					return;
+				}
+				if(balance==2){
+					rebalance_left(parent);
+					return;
+				}
+				if(balance==-2){
+					rebalance_right(parent);
+					return;
+				}
+				set_balance_factor(parent,balance);
 			}
-			--basic_type::num_of_nodes;
-			const_node_pointer Ret=basic_type::increment(node);
-			if(node->left_child&&node->right_child){
-				if(left){
-					auto left=basic_type::left_most(node->left_child);
-					// cannot be empty.
-					node->data=left->data;
-					// now left do not have right_child.
-					node=const_cast<node_pointer>(left);
+		}
+
+		// the left (or right) subtree of node shrank by one, walk up while the height keeps shrinking.
+		void retrace_after_erase(node_pointer node,bool left){
+			while(node){
+				int balance=balance_factor(node)+(left?-1:1);
+				if(balance==2){
+					node=rebalance_left(node);
+					if(balance_factor(node)!=0){
+						return;
+					}
+				}else if(balance==-2){
+					node=rebalance_right(node);
+					if(balance_factor(node)!=0){
+						return;
+					}
 				}else{
-					auto right=basic_type::right_most(node->right_child);
-					// cannot be empty.
-					node->data=right->data;
-					// now right do not have right_child.
-					node=const_cast<node_pointer>(right);
+					set_balance_factor(node,balance);
+					if(balance!=0){
+						// was balanced, the height is kept.
+						return;
+					}
 				}
+				node_pointer parent=node->parent;
+				if(parent){
+					left=node==parent->left_child;
+				}
+				node=parent;
 			}
-			// now node can not have two childs.
-			node_pointer parent=node->parent;
-			node_pointer* point_to_node;
-			// newParent records the new min node when node is min_node
-            // records the new max node when node is max_node
-            const_node_pointer newParent = nullptr;
-			if(!parent){
-				// root.
-				point_to_node=nullptr;
-			}else if(node==parent->left_child){
-				point_to_node=(node_pointer*)&((parent->left_child));
-			}else{
-				point_to_node=(node_pointer*)&((parent->right_child));
+		}
+
+		// height of the subtree if every balance factor matches the real heights, otherwise -1.
+		static int checked_height(const_node_pointer root){
+			if(!root){
+				return 0;
 			}
-			if(node->is_leaf){
-				// delete directly.
-				if(point_to_node){
-					*point_to_node=nullptr;
-					--parent->child_size;
-					if(parent->child_size==0){
-						parent->is_leaf=true;
-					}
-					shift_avl_node(parent);
-					rebalance(parent);
-				}else{
-					basic_type::_root=nullptr;
+			int left_height=checked_height(root->left_child);
+			int right_height=checked_height(root->right_child);
+			if(left_height<0||right_height<0||left_height-right_height!=balance_factor(root)){
+				return -1;
+			}
+			return std::max(left_height,right_height)+1;
+		}
+
+		// Join policy of the set algebra(see abstract_bs_tree::union_of), the rank is the height.
+		struct avl_join{
+			// the height is read from the balance factors along one path.
+			static int rank(const_node_pointer root){
+				int Height = 0;
+				for(; root; ++Height){
+					root = balance_factor(root) < 0 ? root->right_child : root->left_child;
 				}
-				newParent = node->parent;
-				node->parent=nullptr;
-			}else if(node->left_child){
-				if(point_to_node){
-					node->left_child->parent=parent;
-					*point_to_node=node->left_child;
-					shift_avl_node(parent);
-					rebalance(parent);
-				}else{
-					basic_type::_root=node->left_child;
-					node->left_child->parent=nullptr;
+				return Height;
+			}
+
+			static int child_rank(const_node_pointer node, int Rank, bool left){
+				int balance = balance_factor(node);
+				return Rank - 1 - (left ? (balance < 0 ? 1 : 0) : (balance > 0 ? 1 : 0));
+			}
+
+			// node over two subtrees differing by at most one in height.
+			static node_pointer make(node_pointer l, int LeftRank, node_pointer k, node_pointer r, int RightRank, int& Rank){
+				basic_type::link_children(k, l, r);
+				set_balance_factor(k, LeftRank - RightRank);
+				Rank = std::max(LeftRank, RightRank) + 1;
+				return k;
+			}
+
+			// node over two subtrees differing by at most two in height, rotated like after an insertion.
+			static node_pointer balance(node_pointer l, int LeftRank, node_pointer k, node_pointer r, int RightRank, int& Rank){
+				if(LeftRank > RightRank + 1){
+					node_pointer ll = l->left_child, lr = l->right_child;
+					int OuterRank = child_rank(l, LeftRank, true), InnerRank = child_rank(l, LeftRank, false);
+					int KRank;
+					if(OuterRank >= InnerRank){
+						node_pointer right = make(lr, InnerRank, k, r, RightRank, KRank);
+						return make(ll, OuterRank, l, right, KRank, Rank);
+					}
+					node_pointer lrl = lr->left_child, lrr = lr->right_child;
+					int LRLRank = child_rank(lr, InnerRank, true), LRRRank = child_rank(lr, InnerRank, false);
+					int LRank;
+					node_pointer left = make(ll, OuterRank, l, lrl, LRLRank, LRank);
+					node_pointer right = make(lrr, LRRRank, k, r, RightRank, KRank);
+					return make(left, LRank, lr, right, KRank, Rank);
 				}
-				newParent = node->left_child;
-				node->parent=nullptr;
-				node->left_child=nullptr;
-			}else if(node->right_child){
-				if(point_to_node){
-					node->right_child->parent=parent;
-					*point_to_node=node->right_child;
-					shift_avl_node(parent);
-					rebalance(parent);
-				}else{
-					basic_type::_root=node->right_child;
-					node->right_child->parent=nullptr;
+				if(RightRank > LeftRank + 1){
+					// symmetric.
+					node_pointer rl = r->left_child, rr = r->right_child;
+					int OuterRank = child_rank(r, RightRank, false), InnerRank = child_rank(r, RightRank, true);
+					int KRank;
+					if(OuterRank >= InnerRank){
+						node_pointer left = make(l, LeftRank, k, rl, InnerRank, KRank);
+						return make(left, KRank, r, rr, OuterRank, Rank);
+					}
+					node_pointer rll = rl->left_child, rlr = rl->right_child;
+					int RLLRank = child_rank(rl, InnerRank, true), RLRRank = child_rank(rl, InnerRank, false);
+					int RRank;
+					node_pointer left = make(l, LeftRank, k, rll, RLLRank, KRank);
+					node_pointer right = make(rlr, RLRRank, r, rr, OuterRank, RRank);
+					return make(left, KRank, rl, right, RRank, Rank);
 				}
-				newParent = node->right_child;
-				node->parent=nullptr;
-				node->right_child=nullptr;
+				return make(l, LeftRank, k, r, RightRank, Rank);
 			}
-			if(basic_type::_root == nullptr){
-				// empty
-				basic_type::min_node = basic_type::max_node = nullptr;
-			}else{
-				if(node == basic_type::min_node){
-					basic_type::min_node = newParent;
+
+			// go down the inner side of the higher tree until heights are close, rebalance on the way up.
+			static node_pointer join(node_pointer l, int LeftRank, node_pointer k, node_pointer r, int RightRank, int& Rank){
+				if(LeftRank > RightRank + 1){
+					int Rest;
+					node_pointer right = join(l->right_child, child_rank(l, LeftRank, false), k, r, RightRank, Rest);
+					return balance(l->left_child, child_rank(l, LeftRank, true), l, right, Rest, Rank);
 				}
-				if(node == basic_type::max_node){
-					basic_type::max_node = newParent;
+				if(RightRank > LeftRank + 1){
+					int Rest;
+					node_pointer left = join(l, LeftRank, k, r->left_child, child_rank(r, RightRank, true), Rest);
+					return balance(left, Rest, r, r->right_child, child_rank(r, RightRank, false), Rank);
 				}
+				return make(l, LeftRank, k, r, RightRank, Rank);
+			}
+		};
+
+	public:
+		avl_tree(Compare comp_ = Compare{}, const Allocator& alloc = Allocator() ):avl_tree(nullptr, comp_, alloc){};
+		avl_tree(const avl_tree&)=delete;
+		avl_tree(const DataType data[],size_t Size,Compare comp_ = Compare{}, const Allocator& alloc = Allocator() ):avl_tree(nullptr, comp_, alloc){
+			if(basic_type::is_sorted_unique(data, data + Size)){
+				build_from_sorted(data, data + Size);
+				return;
+			}
+			for(size_t Index=0;Index<Size;++Index){
+				insert(data[Index]);
 			}
-			delete node;
-			return Ret;
 		}
+		avl_tree(avl_tree && tree):basic_type(std::move(tree)) {}
+
+		std::string to_string()const override {
+			return "<-AVL(Adelson,Velsky,Landis) Tree->";
+		}
+
+		// Replace the content by the strictly increasing data of [first, last) in O(n),
+		// the balance factor of a node is just the difference of its subtree heights.
+		template<typename ForwardIt>
+		void build_from_sorted(ForwardIt first, ForwardIt last){
+			basic_type::build_balanced(first, last, [](node_pointer node, size_t, size_t, int LeftHeight, int RightHeight){
+				set_balance_factor(node, LeftHeight - RightHeight);
+			});
+		}
+
+		// Set algebra by joins, in O(m log(n/m + 1)) work and on several threads for big trees
+		// (subproblems under ParallelGrain nodes stay on the calling thread).
+		// Nodes move between the trees, other is left empty, see abstract_bs_tree::union_of.
+
+		// add the data of other, data already here is kept.
+		void union_with(avl_tree& other, size_t ParallelGrain = basic_type::DefaultParallelGrain){
+			basic_type::union_of(avl_join{}, other, ParallelGrain);
+		}
+
+		// keep the data also in other.
+		void intersect_with(avl_tree& other, size_t ParallelGrain = basic_type::DefaultParallelGrain){
+			basic_type::intersection_of(avl_join{}, other, ParallelGrain);
+		}
+
+		// erase the data also in other.
+		void difference_with(avl_tree& other, size_t ParallelGrain = basic_type::DefaultParallelGrain){
+			basic_type::difference_of(avl_join{}, other, ParallelGrain);
+		}
+
+		// append greater, whose data are all greater than the data here, in O(log n).
+		void join(avl_tree& greater){
+			basic_type::join_with(avl_join{}, greater);
+		}
+
+		// move the data not less than key to greater in O(log n) (plus recounting the smaller part unless nodes are sized),
+		// returns whether key was here.
+		bool split(const DataType& key, avl_tree& greater){
+			return basic_type::split_at(avl_join{}, key, greater);
+		}
+
+		static bool is_balanced(const_node_pointer root){
+			if(!root){
+				return true;
+			}
+			// balance factors are kept in [-1,1], check them against the real heights.
+			return checked_height(root)>=0;
+		}
+
+		// insert, emplace and try_emplace link their new node through link_new_node.
+		using basic_type::insert;
 
-		void erase(const DataType& data,bool left=true){
-            auto find_result=basic_type::find(data);
-            if(!find_result.second){
-                return;
-            }
-            erase(find_result.first,left);
-        }
+		// erase and extract unlink their node through cut_node.
+		using basic_type::erase;
 
 	};
 
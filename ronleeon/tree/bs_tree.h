@@ -10,15 +10,16 @@ namespace ronleeon{
 		// will be ignored.
 
 		// C++ style compare,not java compare style.
-		template<typename DataType,typename Compare=std::less<DataType>,typename NodeType=node::bs_node<DataType>,typename NodePrintTrait = b_node_print_trait<NodeType>>
+		template<typename DataType,typename Compare=std::less<DataType>,typename NodeType=node::bs_node<DataType>,typename NodePrintTrait = b_node_print_trait<NodeType>
+			,typename Allocator = std::allocator<DataType>>
 		class bs_tree:public abstract_bs_tree<DataType,Compare,NodeType
-			,bs_tree<DataType,Compare,NodeType,NodePrintTrait>, NodePrintTrait>{
+			,bs_tree<DataType,Compare,NodeType,NodePrintTrait,Allocator>, NodePrintTrait,Allocator>{
 			using basic_type=abstract_bs_tree<DataType,Compare,NodeType
-				,bs_tree<DataType,Compare,NodeType,NodePrintTrait>, NodePrintTrait>;
+				,bs_tree<DataType,Compare,NodeType,NodePrintTrait,Allocator>, NodePrintTrait,Allocator>;
 		
 		protected:
 
-			explicit bs_tree(std::nullptr_t,Compare comp_ = Compare{} ):basic_type(nullptr,comp_){}
+			explicit bs_tree(std::nullptr_t,Compare comp_ = Compare{}, const Allocator& alloc = Allocator() ):basic_type(nullptr,comp_,alloc){}
 
 		public:
 			using node_type = NodeType;
@@ -29,9 +30,9 @@ namespace ronleeon{
 			using const_node_type_reference = const NodeType&;
 
 			using PrintTrait = typename basic_type::PrintTrait;
-			bs_tree(Compare comp_ = Compare{} ):bs_tree(nullptr,comp_){};
+			bs_tree(Compare comp_ = Compare{}, const Allocator& alloc = Allocator() ):bs_tree(nullptr,comp_,alloc){};
 			bs_tree(const bs_tree&)=delete;
-			bs_tree(const DataType data[],size_t Size,Compare comp_ = Compare{} ):basic_type(data,Size,comp_){}
+			bs_tree(const DataType data[],size_t Size,Compare comp_ = Compare{}, const Allocator& alloc = Allocator() ):basic_type(data,Size,comp_,alloc){}
 			bs_tree(bs_tree && tree):basic_type(std::move(tree)) {}
 		};
 
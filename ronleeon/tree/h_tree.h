@@ -96,7 +96,7 @@ namespace ronleeon{
 					_sorted[min_index1] = true;
 					_sorted[min_index2]=true;
 					
-					auto new_node = new NodeType();
+					auto new_node = basic_type::allocate_node();
 					new_node->data = *min_data1 + *min_data2;
 					// binary node
 					new_node->left_child=_ele[min_index1];
@@ -157,7 +157,7 @@ namespace ronleeon{
 			h_tree(const h_tree&t)=delete;
 			h_tree(const DataType data[]){
 				for(size_t Index=0;Index<Size;++Index){	
-					_ele[Index]=new NodeType();
+					_ele[Index]=basic_type::allocate_node();
 					_ele[Index]->data = data[Index];
 				}
 				for(size_t Index=Size;Index< compute_node_size<Size>::value;++Index){
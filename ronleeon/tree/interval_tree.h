@@ -1,8 +1,239 @@
 //
 // Created by ronaldo on 2/12/23.
 //
+// Provides an interval tree: a rb_tree of intervals ordered by their low endpoint, whose nodes
+// keep the maximum high endpoint of their subtree(an augmentation, see node::augmented_rb_node).
 
 #ifndef RONLEEON_ADT_INTERVAL_TREE_H
 #define RONLEEON_ADT_INTERVAL_TREE_H
 
+#include "ronleeon/tree/rb_tree.h"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+namespace ronleeon::tree{
+
+	// half-open interval [low, high), Endpoint must support '<'.
+	template<typename Endpoint>
+	struct interval{
+		Endpoint low;
+		Endpoint high;
+
+		[[nodiscard]] bool contains(const Endpoint& point) const {
+			return !(point < low) && point < high;
+		}
+
+		[[nodiscard]] bool overlaps(const Endpoint& lo, const Endpoint& hi) const {
+			return low < hi && lo < high;
+		}
+
+		friend bool operator==(const interval& lhs, const interval& rhs){
+			return !(lhs.low < rhs.low) && !(rhs.low < lhs.low) && !(lhs.high < rhs.high) && !(rhs.high < lhs.high);
+		}
+
+		friend std::ostream& operator<<(std::ostream& out, const interval& Interval){
+			out<<'['<<Interval.low<<','<<Interval.high<<')';
+			return out;
+		}
+	};
+
+	// by low endpoint, then by high endpoint.
+	template<typename Endpoint>
+	struct interval_less{
+		bool operator()(const interval<Endpoint>& lhs, const interval<Endpoint>& rhs) const {
+			if(lhs.low < rhs.low){
+				return true;
+			}
+			if(rhs.low < lhs.low){
+				return false;
+			}
+			return lhs.high < rhs.high;
+		}
+	};
+
+	// the aggregate of a subtree is its greatest high endpoint.
+	template<typename Endpoint>
+	struct interval_max_high{
+		static_assert(std::numeric_limits<Endpoint>::is_specialized, "Endpoint needs a lowest value");
+		using value_type = Endpoint;
+		static Endpoint identity(){ return std::numeric_limits<Endpoint>::lowest(); }
+		static Endpoint lift(const interval<Endpoint>& Interval){ return Interval.high; }
+		static Endpoint combine(const Endpoint& lhs, const Endpoint& rhs){ return lhs < rhs ? rhs : lhs; }
+	};
+
+	// Guarantee all intervals are not equal, otherwise the latter will be ignored.
+	// A subtree whose greatest high endpoint is not above a point holds no interval containing it,
+	// queries skip it. Every reported interval still costs the path down to it, so reporting k
+	// intervals visits O(log n + k log(n / k)) nodes, that is O(min(n, k log n)), not O(log n + k):
+	// stabbing as well as overlap. Many points are better answered together by stab_sorted.
+	template<typename Endpoint, typename Allocator = std::allocator<interval<Endpoint>>>
+	class interval_tree{
+	public:
+		using interval_type = interval<Endpoint>;
+		using node_type = node::augmented_rb_node<interval_type, interval_max_high<Endpoint>>;
+		using tree_type = rb_tree<interval_type, interval_less<Endpoint>, node_type, rb_node_print_trait<node_type>, Allocator>;
+		using const_node_pointer = typename tree_type::const_node_pointer;
+		using allocator_type = typename tree_type::allocator_type;
+	private:
+		tree_type tree;
+
+		// visit every interval of the subtree overlapping [lo, hi).
+		template<typename Visit>
+		static void overlap_subtree(const_node_pointer node, const Endpoint& lo, const Endpoint& hi, Visit& visit){
+			while(node && lo < node->aggregate){
+				overlap_subtree(node->left_child, lo, hi, visit);
+				if(!(node->data.low < hi)){
+					// all the intervals on the right start later.
+					return;
+				}
+				if(lo < node->data.high){
+					visit(node->data);
+				}
+				node = node->right_child;
+			}
+		}
+
+		// visit every interval of the subtree containing point.
+		template<typename Visit>
+		static void stab_subtree(const_node_pointer node, const Endpoint& point, Visit& visit){
+			while(node && point < node->aggregate){
+				stab_subtree(node->left_child, point, visit);
+				if(point < node->data.low){
+					return;
+				}
+				if(point < node->data.high){
+					visit(node->data);
+				}
+				node = node->right_child;
+			}
+		}
+
+	public:
+		explicit interval_tree(const allocator_type& alloc = allocator_type()):tree(interval_less<Endpoint>{}, alloc){}
+		interval_tree(std::initializer_list<interval_type> l, const allocator_type& alloc = allocator_type()):interval_tree(alloc){
+			for(const auto& Interval:l){
+				insert(Interval);
+			}
+		}
+		interval_tree(const interval_tree&) = delete;
+		interval_tree& operator=(const interval_tree&) = delete;
+
+		[[nodiscard]] size_t size() const {
+			return tree.size();
+		}
+
+		[[nodiscard]] bool empty() const {
+			return tree.size() == 0;
+		}
+
+		allocator_type get_allocator() const {
+			return tree.get_allocator();
+		}
+
+		const tree_type& get_tree() const {
+			return tree;
+		}
+
+		// returns whether the interval was inserted.
+		bool insert(const interval_type& Interval){
+			return tree.insert(Interval).second;
+		}
+
+		bool insert(const Endpoint& low, const Endpoint& high){
+			return insert(interval_type{low, high});
+		}
+
+		// returns whether the interval was there.
+		bool erase(const interval_type& Interval){
+			auto Find = tree.find(Interval);
+			if(!Find.second){
+				return false;
+			}
+			tree.erase(Find.first);
+			return true;
+		}
+
+		bool erase(const Endpoint& low, const Endpoint& high){
+			return erase(interval_type{low, high});
+		}
+
+		[[nodiscard]] bool contains(const interval_type& Interval) const {
+			return tree.find(Interval).second;
+		}
+
+		void clear(){
+			tree.destroy();
+		}
+
+		// visit(interval) for every interval overlapping [lo, hi), in order, in O(min(n, k log n)).
+		template<typename Visit>
+		void overlap(const Endpoint& lo, const Endpoint& hi, Visit visit) const {
+			if(lo < hi){
+				overlap_subtree(tree.get_root(), lo, hi, visit);
+			}
+		}
+
+		std::vector<interval_type> overlapping(const Endpoint& lo, const Endpoint& hi) const {
+			std::vector<interval_type> Ret;
+			overlap(lo, hi, [&Ret](const interval_type& Interval){ Ret.push_back(Interval); });
+			return Ret;
+		}
+
+		// visit(interval) for every interval containing point, in order, in O(min(n, k log n)).
+		template<typename Visit>
+		void stab(const Endpoint& point, Visit visit) const {
+			stab_subtree(tree.get_root(), point, visit);
+		}
+
+		std::vector<interval_type> stabbing(const Endpoint& point) const {
+			std::vector<interval_type> Ret;
+			stab(point, [&Ret](const interval_type& Interval){ Ret.push_back(Interval); });
+			return Ret;
+		}
+
+		// Batched stabbing of the sorted points of [first, last): visit(point, interval) for every
+		// interval containing each point. Few points are stabbed one by one, otherwise a single sweep
+		// walks the intervals by low endpoint and keeps the ones still open in a heap ordered by
+		// high endpoint, in O(m log m + q + k) for the m intervals starting before the last point.
+		template<typename ForwardIt, typename Visit>
+		void stab_sorted(ForwardIt first, ForwardIt last, Visit visit) const {
+			auto Points = static_cast<size_t>(std::distance(first, last));
+			size_t Depth = 1;
+			for(size_t Nodes = size(); Nodes > 1; Nodes /= 2){
+				++Depth;
+			}
+			if(Points * Depth < size()){
+				for(; first != last; ++first){
+					const Endpoint& point = *first;
+					stab(point, [&point, &visit](const interval_type& Interval){ visit(point, Interval); });
+				}
+				return;
+			}
+			// min-heap on the high endpoint.
+			auto Later = [](const_node_pointer lhs, const_node_pointer rhs){ return rhs->data.high < lhs->data.high; };
+			std::vector<const_node_pointer> Open;
+			const_node_pointer Next = tree_type::left_most(tree.get_root());
+			for(; first != last; ++first){
+				const Endpoint& point = *first;
+				for(; Next && !(point < Next->data.low); Next = tree_type::increment(Next)){
+					Open.push_back(Next);
+					std::push_heap(Open.begin(), Open.end(), Later);
+				}
+				while(!Open.empty() && !(point < Open.front()->data.high)){
+					std::pop_heap(Open.begin(), Open.end(), Later);
+					Open.pop_back();
+				}
+				for(const_node_pointer node:Open){
+					visit(point, node->data);
+				}
+			}
+		}
+	};
+
+}
+
 #endif //RONLEEON_ADT_INTERVAL_TREE_H
@@ -6,26 +6,32 @@
 #ifndef RONLEEON_ADT_NODE_H
 #define RONLEEON_ADT_NODE_H
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <list>
 #include <istream>
 #include <ostream>
 #include <iterator>
 #include <map>
+#include <type_traits>
 #include <utility>
 #include <tuple>
+#include <vector>
+#include "ronleeon/tree/node_pool.h"
 namespace ronleeon::tree::node{
 
 
 			// for m -node use an array to store all children.
 			// its iterator must provide to access tyo its m-children(include empty node).
-			template <typename NodeType,size_t Size>
+			// Link is the type of a link to another node: NodeType* or index_link<NodeType>.
+			template <typename NodeType,size_t Size,typename Link=NodeType*>
 			struct m_child_storage{
 				// default storing pointers.
-				std::array<NodeType*,Size> children;
+				std::array<Link,Size> children;
 				// in B/Bplus tree, all non-empty children must be near each other.
 				size_t child_size;// non-empty child size
 				explicit m_child_storage() {
@@ -36,10 +42,10 @@ namespace ronleeon::tree::node{
 				}
 				m_child_storage(const m_child_storage&)=delete;
 				m_child_storage(m_child_storage&& rhs) noexcept: children(std::move(rhs.children)),child_size(rhs.child_size) {}
-				using const_child_iterator=typename std::array<NodeType*,Size>::const_iterator;
-				using child_iterator=typename std::array<NodeType*,Size>::iterator;
-				using reverse_child_iterator=typename std::array<NodeType*,Size>::reverse_iterator;
-				using const_reverse_child_iterator=typename std::array<NodeType*,Size>::const_reverse_iterator;
+				using const_child_iterator=typename std::array<Link,Size>::const_iterator;
+				using child_iterator=typename std::array<Link,Size>::iterator;
+				using reverse_child_iterator=typename std::array<Link,Size>::reverse_iterator;
+				using const_reverse_child_iterator=typename std::array<Link,Size>::const_reverse_iterator;
 				child_iterator child_begin(){
 					return children.begin();
 				}
@@ -77,13 +83,112 @@ namespace ronleeon::tree::node{
 					return children.crend();
 				}
 
-				virtual ~m_child_storage(){
-					for(size_t Index = 0; Index < child_size; ++Index){
-						if(children[Index]){
-							delete children[Index];
-						}
+				// children are owned by the tree, which releases them through its allocator.
+				// no virtual destructor: nodes are never released through their storage.
+			};
+
+			// binary nodes name their two children, its iterator visits left_child then right_child,
+			// so binary nodes still work with the algorithms written for m-nodes.
+			template <typename NodeType,typename Link=NodeType*>
+			struct b_child_storage{
+				Link left_child;
+				Link right_child;
+				explicit b_child_storage():left_child(nullptr),right_child(nullptr){}
+				b_child_storage(const b_child_storage&)=delete;
+				b_child_storage(b_child_storage&& rhs) noexcept: left_child(rhs.left_child),right_child(rhs.right_child){}
+
+				template<typename Storage,typename Child>
+				class basic_child_iterator{
+					Storage* _storage;
+					size_t _index;// 0:left_child, 1:right_child, 2:end.
+				public:
+					using iterator_category = std::bidirectional_iterator_tag;
+					using value_type = NodeType*;
+					using difference_type = std::ptrdiff_t;
+					using pointer = Child*;
+					using reference = Child&;
+
+					basic_child_iterator():_storage(nullptr),_index(0){}
+					basic_child_iterator(Storage* storage,size_t index):_storage(storage),_index(index){}
+
+					reference operator*()const{
+						return _index == 0 ? _storage->left_child : _storage->right_child;
+					}
+					basic_child_iterator& operator++(){
+						++_index;
+						return *this;
+					}
+					basic_child_iterator operator++(int){
+						basic_child_iterator Tmp=*this;
+						++_index;
+						return Tmp;
+					}
+					basic_child_iterator& operator--(){
+						--_index;
+						return *this;
+					}
+					basic_child_iterator operator--(int){
+						basic_child_iterator Tmp=*this;
+						--_index;
+						return Tmp;
 					}
+					friend bool operator==(const basic_child_iterator& x,const basic_child_iterator& y){
+						return x._storage == y._storage && x._index == y._index;
+					}
+					friend bool operator!=(const basic_child_iterator& x,const basic_child_iterator& y){
+						return !(x == y);
+					}
+				};
+				using child_iterator=basic_child_iterator<b_child_storage,Link>;
+				using const_child_iterator=basic_child_iterator<const b_child_storage,const Link>;
+				using reverse_child_iterator=std::reverse_iterator<child_iterator>;
+				using const_reverse_child_iterator=std::reverse_iterator<const_child_iterator>;
+				child_iterator child_begin(){
+					return child_iterator(this,0);
+				}
+				child_iterator child_end(){
+					return child_iterator(this,2);
+				}
+				const_child_iterator child_cbegin()const{
+					return const_child_iterator(this,0);
+				}
+				const_child_iterator child_cend()const{
+					return const_child_iterator(this,2);
+				}
+				reverse_child_iterator child_rbegin(){
+					return reverse_child_iterator(child_end());
+				}
+				reverse_child_iterator child_rend(){
+					return reverse_child_iterator(child_begin());
+				}
+				const_reverse_child_iterator child_crbegin()const{
+					return const_reverse_child_iterator(child_cend());
+				}
+				const_reverse_child_iterator child_crend()const{
+					return const_reverse_child_iterator(child_cbegin());
+				}
+				const_child_iterator child_begin()const{
+					return child_cbegin();
+				}
+				const_child_iterator child_end()const{
+					return child_cend();
+				}
+				const_reverse_child_iterator child_rbegin() const {
+					return child_crbegin();
 				}
+				const_reverse_child_iterator child_rend() const {
+					return child_crend();
+				}
+			};
+
+			// binary child storage which also counts its non-empty children, like m_child_storage.
+			template <typename NodeType>
+			struct counted_b_child_storage:b_child_storage<NodeType>{
+				size_t child_size;// non-empty child size
+				explicit counted_b_child_storage():b_child_storage<NodeType>(),child_size(0){}
+				counted_b_child_storage(const counted_b_child_storage&)=delete;
+				counted_b_child_storage(counted_b_child_storage&& rhs) noexcept
+					:b_child_storage<NodeType>(std::move(rhs)),child_size(rhs.child_size){}
 			};
 
 			
@@ -92,6 +197,9 @@ namespace ronleeon::tree::node{
 			struct single_data_storage{
 				DataType data;
 				explicit single_data_storage(const DataType &Data):data(Data){}
+				// the data built from args, in place.
+				template<typename... Args>
+				explicit single_data_storage(std::in_place_t, Args&&... args):data(std::forward<Args>(args)...){}
 
 				single_data_storage(const single_data_storage&)=delete;
 				single_data_storage()=default;
@@ -101,16 +209,21 @@ namespace ronleeon::tree::node{
             template<typename NodeType,typename DataType,size_t Size
 				,typename data_storage=single_data_storage<DataType>
 				,typename child_storage=m_child_storage<NodeType,Size>
+				,typename Link=NodeType*
 			>
 			struct abstract_node:child_storage,data_storage{
 				
 				bool is_leaf;
-				NodeType* parent;
+				Link parent;
                 // In these trees: height field is useless(null).
 				// 1. B_tree/Bplus_tree(maintain exactly height for each node is hard when inserting causes the root node splitting)
 				size_t height;
 				explicit abstract_node():data_storage()
 					,child_storage(),is_leaf(true),parent(nullptr),height(0){}
+				// Nodes built with std::in_place construct their data from args, see abstract_tree::allocate_node.
+				template<typename... Args>
+				explicit abstract_node(std::in_place_t, Args&&... args):child_storage()
+					,data_storage(std::in_place, std::forward<Args>(args)...),is_leaf(true),parent(nullptr),height(0){}
 
 				abstract_node(const abstract_node&)=delete;
 				abstract_node(abstract_node&& rhs) noexcept :child_storage(std::move(rhs))
@@ -133,19 +246,15 @@ namespace ronleeon::tree::node{
 					:abstract_node<m_node<DataType,Size>,DataType,Size>(){}
 			};
 			
-			// binary node can default children storage(left and right children)
+			// binary node stores its children as left_child and right_child.
 			template <typename NodeType,typename DataType>
-			struct abstract_b_node :abstract_node<NodeType,DataType,2>{
-				// use these two field to bind children[0],and children[1]
-				NodeType* &left_child;
-				NodeType* &right_child;
+			struct abstract_b_node :abstract_node<NodeType,DataType,2
+				,single_data_storage<DataType>,counted_b_child_storage<NodeType>>{
 				explicit abstract_b_node()
-					:abstract_node<NodeType,DataType,2>()
-					,left_child(*abstract_node<NodeType,DataType,2>::child_begin()),
-					right_child(*abstract_node<NodeType,DataType,2>::child_rbegin()){
-					// only has two children.
-				}
-
+					:abstract_node<NodeType,DataType,2,single_data_storage<DataType>,counted_b_child_storage<NodeType>>(){}
+				template<typename... Args>
+				explicit abstract_b_node(std::in_place_t, Args&&... args)
+					:abstract_node<NodeType,DataType,2,single_data_storage<DataType>,counted_b_child_storage<NodeType>>(std::in_place, std::forward<Args>(args)...){}
 			};
 
 			template<typename DataType>
@@ -184,21 +293,24 @@ namespace ronleeon::tree::node{
 				}
 			};
 
+			// Binary search nodes are default constructed, or constructed with std::in_place
+			// and the arguments of their data (see abstract_bs_tree::emplace).
 			template <typename NodeType,typename DataType>
-			struct abstract_bs_node :abstract_b_node<NodeType,DataType>{};
+			struct abstract_bs_node :abstract_b_node<NodeType,DataType>{
+				using abstract_b_node<NodeType,DataType>::abstract_b_node;
+			};
 
 			template <typename DataType>
-			struct bs_node final:abstract_bs_node<bs_node<DataType>,DataType>{};
+			struct bs_node final:abstract_bs_node<bs_node<DataType>,DataType>{
+				using abstract_bs_node<bs_node<DataType>,DataType>::abstract_bs_node;
+			};
 
 			template <typename DataType>
 			struct avl_node final :abstract_bs_node<avl_node<DataType>,DataType>{
-				explicit avl_node()
-					:abstract_bs_node<avl_node<DataType>,DataType>(){
-					balance_factor=0;
-				}
+				using abstract_bs_node<avl_node<DataType>,DataType>::abstract_bs_node;
 
 				// only valid in -1,0,1
-				short balance_factor;// left_child->height-right_child->height
+				short balance_factor = 0;// left_child->height-right_child->height
 			};
 
 			// all leaves are created to red by default.
@@ -207,19 +319,426 @@ namespace ronleeon::tree::node{
 				enum class COLOR{
 					RED,BLACK
 				};
-				explicit rb_node()
-					:abstract_bs_node<rb_node<DataType>,DataType>(){
-					color=COLOR::RED;
+				using abstract_bs_node<rb_node<DataType>,DataType>::abstract_bs_node;
+
+				COLOR color = COLOR::RED;
+			};
+
+			// Compact binary search nodes keep the links, the data and whatever their tree needs
+			// to stay balanced, nothing else: no is_leaf, child_size or height (trees derive them
+			// from the links, see node_bookkeeping).
+			// Use them as NodeType of bs_tree, avl_tree and rb_tree to save memory.
+			template <typename NodeType,typename DataType>
+			struct abstract_compact_bs_node:b_child_storage<NodeType>{
+				NodeType* parent;
+				DataType data;
+				explicit abstract_compact_bs_node():b_child_storage<NodeType>(),parent(nullptr),data(){}
+				template<typename... Args>
+				explicit abstract_compact_bs_node(std::in_place_t, Args&&... args)
+					:b_child_storage<NodeType>(),parent(nullptr),data(std::forward<Args>(args)...){}
+			};
+
+			template <typename DataType>
+			struct compact_bs_node final:abstract_compact_bs_node<compact_bs_node<DataType>,DataType>{
+				using abstract_compact_bs_node<compact_bs_node<DataType>,DataType>::abstract_compact_bs_node;
+			};
+
+			// AVL tree still needs the height to rebalance, it never exceeds 1.44*log2(n).
+			template <typename DataType>
+			struct compact_avl_node final:abstract_compact_bs_node<compact_avl_node<DataType>,DataType>{
+				using abstract_compact_bs_node<compact_avl_node<DataType>,DataType>::abstract_compact_bs_node;
+
+				signed char balance_factor = 0;// left_child->height-right_child->height
+				unsigned char height = 0;
+			};
+
+			template <typename DataType>
+			struct compact_rb_node final:abstract_compact_bs_node<compact_rb_node<DataType>,DataType>{
+				enum class COLOR:unsigned char{
+					RED,BLACK
+				};
+				using abstract_compact_bs_node<compact_rb_node<DataType>,DataType>::abstract_compact_bs_node;
+
+				COLOR color = COLOR::RED;
+			};
+
+			// Sized nodes are compact nodes also counting the nodes of their subtree(itself included),
+			// trees keep it up to date so order statistics take O(log n), see abstract_bs_tree::select.
+			template <typename NodeType,typename DataType>
+			struct abstract_sized_bs_node:abstract_compact_bs_node<NodeType,DataType>{
+				size_t subtree_size;
+				explicit abstract_sized_bs_node():abstract_compact_bs_node<NodeType,DataType>(),subtree_size(1){}
+				template<typename... Args>
+				explicit abstract_sized_bs_node(std::in_place_t, Args&&... args)
+					:abstract_compact_bs_node<NodeType,DataType>(std::in_place, std::forward<Args>(args)...),subtree_size(1){}
+			};
+
+			template <typename DataType>
+			struct sized_bs_node final:abstract_sized_bs_node<sized_bs_node<DataType>,DataType>{
+				using abstract_sized_bs_node<sized_bs_node<DataType>,DataType>::abstract_sized_bs_node;
+			};
+
+			template <typename DataType>
+			struct sized_avl_node final:abstract_sized_bs_node<sized_avl_node<DataType>,DataType>{
+				using abstract_sized_bs_node<sized_avl_node<DataType>,DataType>::abstract_sized_bs_node;
+
+				signed char balance_factor = 0;// left_child->height-right_child->height
+			};
+
+			template <typename DataType>
+			struct sized_rb_node final:abstract_sized_bs_node<sized_rb_node<DataType>,DataType>{
+				enum class COLOR:unsigned char{
+					RED,BLACK
+				};
+				using abstract_sized_bs_node<sized_rb_node<DataType>,DataType>::abstract_sized_bs_node;
+
+				COLOR color = COLOR::RED;
+			};
+
+			// Augmented nodes are compact nodes also keeping an aggregate of their subtree: a monoid
+			// value combining the lifted data of the subtree in order. Monoid provides
+			//   value_type, static value_type identity(), static value_type lift(const DataType&)
+			//   and static value_type combine(const value_type&, const value_type&) (associative).
+			// Trees keep it up to date like the other bookkeeping fields, see abstract_bs_tree::aggregate.
+			template <typename NodeType,typename DataType,typename Monoid>
+			struct abstract_augmented_bs_node:abstract_compact_bs_node<NodeType,DataType>{
+				using monoid_type = Monoid;
+				typename Monoid::value_type aggregate;
+				explicit abstract_augmented_bs_node()
+					:abstract_compact_bs_node<NodeType,DataType>(),aggregate(Monoid::identity()){}
+				template<typename... Args>
+				explicit abstract_augmented_bs_node(std::in_place_t, Args&&... args)
+					:abstract_compact_bs_node<NodeType,DataType>(std::in_place, std::forward<Args>(args)...),aggregate(Monoid::identity()){}
+			};
+
+			template <typename DataType,typename Monoid>
+			struct augmented_bs_node final:abstract_augmented_bs_node<augmented_bs_node<DataType,Monoid>,DataType,Monoid>{
+				using abstract_augmented_bs_node<augmented_bs_node<DataType,Monoid>,DataType,Monoid>::abstract_augmented_bs_node;
+			};
+
+			template <typename DataType,typename Monoid>
+			struct augmented_avl_node final:abstract_augmented_bs_node<augmented_avl_node<DataType,Monoid>,DataType,Monoid>{
+				using abstract_augmented_bs_node<augmented_avl_node<DataType,Monoid>,DataType,Monoid>::abstract_augmented_bs_node;
+
+				signed char balance_factor = 0;// left_child->height-right_child->height
+			};
+
+			template <typename DataType,typename Monoid>
+			struct augmented_rb_node final:abstract_augmented_bs_node<augmented_rb_node<DataType,Monoid>,DataType,Monoid>{
+				enum class COLOR:unsigned char{
+					RED,BLACK
+				};
+				using abstract_augmented_bs_node<augmented_rb_node<DataType,Monoid>,DataType,Monoid>::abstract_augmented_bs_node;
+
+				COLOR color = COLOR::RED;
+			};
+
+			// Parent pointer whose low Bits bits (always zero as nodes are aligned) carry a small tag.
+			// It reads and assigns like a plain NodeType*: assigning a pointer keeps the tag,
+			// the tag is only changed through set_tag().
+			template <typename NodeType,size_t Bits>
+			class tagged_parent_pointer{
+				static constexpr std::uintptr_t TagMask = (std::uintptr_t(1) << Bits) - 1;
+				std::uintptr_t _value;
+			public:
+				tagged_parent_pointer():_value(0){}
+				tagged_parent_pointer(NodeType* ptr):_value(reinterpret_cast<std::uintptr_t>(ptr)){}
+				// copying a node link never copies the tag of another node.
+				tagged_parent_pointer(const tagged_parent_pointer&)=delete;
+				tagged_parent_pointer& operator=(const tagged_parent_pointer& rhs){
+					return *this = rhs.get();
+				}
+				tagged_parent_pointer& operator=(NodeType* ptr){
+					static_assert(alignof(NodeType) > TagMask, "Node alignment leaves no room for the tag");
+					_value = reinterpret_cast<std::uintptr_t>(ptr) | (_value & TagMask);
+					return *this;
+				}
+
+				NodeType* get() const {
+					return reinterpret_cast<NodeType*>(_value & ~TagMask);
+				}
+				operator NodeType*() const {
+					return get();
+				}
+				NodeType* operator->() const {
+					return get();
+				}
+
+				[[nodiscard]] size_t tag() const {
+					return static_cast<size_t>(_value & TagMask);
 				}
+				void set_tag(size_t tag){
+					assert(tag <= TagMask && "Tag does not fit");
+					_value = (_value & ~TagMask) | static_cast<std::uintptr_t>(tag);
+				}
+			};
+
+			// Tagged nodes go one step further than compact nodes: the red-black color
+			// or the AVL balance factor lives in the low bits of the parent pointer.
+			// Nodes are 3 pointers plus the data.
+			template <typename NodeType,typename DataType,size_t Bits>
+			struct abstract_tagged_bs_node:b_child_storage<NodeType>{
+				tagged_parent_pointer<NodeType,Bits> parent;
+				DataType data;
+				explicit abstract_tagged_bs_node():b_child_storage<NodeType>(),parent(),data(){}
+				template<typename... Args>
+				explicit abstract_tagged_bs_node(std::in_place_t, Args&&... args)
+					:b_child_storage<NodeType>(),parent(),data(std::forward<Args>(args)...){}
+			};
+
+			// tag 0:red, 1:black.
+			template <typename DataType>
+			struct tagged_rb_node final:abstract_tagged_bs_node<tagged_rb_node<DataType>,DataType,1>{
+				enum class COLOR:unsigned char{
+					RED,BLACK
+				};
+				using abstract_tagged_bs_node<tagged_rb_node<DataType>,DataType,1>::abstract_tagged_bs_node;
+			};
 
-				COLOR color;
+			// tag holds the balance factor in two's complement: 0, 1, or 3 for -1.
+			template <typename DataType>
+			struct tagged_avl_node final:abstract_tagged_bs_node<tagged_avl_node<DataType>,DataType,2>{
+				using abstract_tagged_bs_node<tagged_avl_node<DataType>,DataType,2>::abstract_tagged_bs_node;
+			};
+
+			// Indexed nodes live in a node_pool and link to each other by 32-bit indices,
+			// halving the links on 64-bit builds (up to 2^32-1 nodes of a type).
+			// They must be allocated by index_pool_allocator, which fills self_index.
+			template <typename NodeType,typename DataType>
+			struct abstract_indexed_bs_node:b_child_storage<NodeType,index_link<NodeType>>{
+				index_link<NodeType> parent;
+				std::uint32_t self_index;
+				DataType data;
+				explicit abstract_indexed_bs_node()
+					:b_child_storage<NodeType,index_link<NodeType>>(),parent(),self_index(0),data(){}
+				template<typename... Args>
+				explicit abstract_indexed_bs_node(std::in_place_t, Args&&... args)
+					:b_child_storage<NodeType,index_link<NodeType>>(),parent(),self_index(0),data(std::forward<Args>(args)...){}
+			};
+
+			template <typename DataType>
+			struct indexed_bs_node final:abstract_indexed_bs_node<indexed_bs_node<DataType>,DataType>{
+				using abstract_indexed_bs_node<indexed_bs_node<DataType>,DataType>::abstract_indexed_bs_node;
+			};
+
+			template <typename DataType>
+			struct indexed_avl_node final:abstract_indexed_bs_node<indexed_avl_node<DataType>,DataType>{
+				using abstract_indexed_bs_node<indexed_avl_node<DataType>,DataType>::abstract_indexed_bs_node;
+
+				signed char balance_factor = 0;// left_child->height-right_child->height
+			};
+
+			template <typename DataType>
+			struct indexed_rb_node final:abstract_indexed_bs_node<indexed_rb_node<DataType>,DataType>{
+				enum class COLOR:unsigned char{
+					RED,BLACK
+				};
+				using abstract_indexed_bs_node<indexed_rb_node<DataType>,DataType>::abstract_indexed_bs_node;
+
+				COLOR color = COLOR::RED;
+			};
+
+			template<typename NodeType,typename = void>
+			struct has_color_field:std::false_type{};
+			template<typename NodeType>
+			struct has_color_field<NodeType,std::void_t<decltype(std::declval<NodeType&>().color)>>:std::true_type{};
+
+			template<typename NodeType,typename = void>
+			struct has_balance_factor_field:std::false_type{};
+			template<typename NodeType>
+			struct has_balance_factor_field<NodeType,std::void_t<decltype(std::declval<NodeType&>().balance_factor)>>:std::true_type{};
+
+			// rb_tree reads and writes colors through here, tagged nodes keep it in the parent pointer.
+			template<typename NodeType>
+			struct rb_color_trait{
+				using COLOR = typename NodeType::COLOR;
+				static COLOR color(const NodeType* node){
+					if constexpr(has_color_field<NodeType>::value){
+						return node->color;
+					}else{
+						return node->parent.tag() ? COLOR::BLACK : COLOR::RED;
+					}
+				}
+				static void set_color(NodeType* node,COLOR color){
+					if constexpr(has_color_field<NodeType>::value){
+						node->color = color;
+					}else{
+						node->parent.set_tag(color == COLOR::BLACK ? 1 : 0);
+					}
+				}
+			};
+
+			// avl_tree reads and writes balance factors (-1, 0 or 1) through here,
+			// tagged nodes keep it in the parent pointer.
+			template<typename NodeType>
+			struct avl_balance_trait{
+				static int balance_factor(const NodeType* node){
+					if constexpr(has_balance_factor_field<NodeType>::value){
+						return node->balance_factor;
+					}else{
+						size_t Tag = node->parent.tag();
+						return Tag == 3 ? -1 : static_cast<int>(Tag);
+					}
+				}
+				static void set_balance_factor(NodeType* node,int balance_factor){
+					assert(balance_factor >= -1 && balance_factor <= 1 && "AVL tree is not balanced");
+					if constexpr(has_balance_factor_field<NodeType>::value){
+						node->balance_factor = balance_factor;
+					}else{
+						node->parent.set_tag(static_cast<size_t>(balance_factor) & 3);
+					}
+				}
+			};
+
+			template<typename NodeType,typename = void>
+			struct has_height_field:std::false_type{};
+			template<typename NodeType>
+			struct has_height_field<NodeType,std::void_t<decltype(std::declval<NodeType&>().height)>>:std::true_type{};
+
+			template<typename NodeType,typename = void>
+			struct has_child_size_field:std::false_type{};
+			template<typename NodeType>
+			struct has_child_size_field<NodeType,std::void_t<decltype(std::declval<NodeType&>().child_size)>>:std::true_type{};
+
+			template<typename NodeType,typename = void>
+			struct has_is_leaf_field:std::false_type{};
+			template<typename NodeType>
+			struct has_is_leaf_field<NodeType,std::void_t<decltype(std::declval<NodeType&>().is_leaf)>>:std::true_type{};
+
+			template<typename NodeType,typename = void>
+			struct has_subtree_size_field:std::false_type{};
+			template<typename NodeType>
+			struct has_subtree_size_field<NodeType,std::void_t<decltype(std::declval<NodeType&>().subtree_size)>>:std::true_type{};
+
+			template<typename NodeType,typename = void>
+			struct has_aggregate_field:std::false_type{};
+			template<typename NodeType>
+			struct has_aggregate_field<NodeType,std::void_t<decltype(std::declval<NodeType&>().aggregate)>>:std::true_type{};
+
+			// reads and recomputes the aggregate of augmented binary nodes.
+			template<typename NodeType>
+			struct augmentation_trait{
+				using monoid_type = typename NodeType::monoid_type;
+				using value_type = typename monoid_type::value_type;
+
+				// identity for an empty subtree.
+				static value_type aggregate(const NodeType* node){
+					return node ? node->aggregate : monoid_type::identity();
+				}
+
+				// aggregates of the children must be right already.
+				static void refresh(NodeType* node){
+					node->aggregate = monoid_type::combine(monoid_type::combine(aggregate(node->left_child)
+						, monoid_type::lift(node->data)), aggregate(node->right_child));
+				}
+			};
+
+			// Trees reach the bookkeeping fields (is_leaf, child_size, height, subtree_size, aggregate) through here,
+			// nodes leaving them out get them derived from their children.
+			template<typename NodeType>
+			struct node_bookkeeping{
+				static constexpr bool has_height = has_height_field<NodeType>::value;
+				static constexpr bool has_child_size = has_child_size_field<NodeType>::value;
+				static constexpr bool has_is_leaf = has_is_leaf_field<NodeType>::value;
+				static constexpr bool has_subtree_size = has_subtree_size_field<NodeType>::value;
+				static constexpr bool has_aggregate = has_aggregate_field<NodeType>::value;
+
+				static bool is_leaf(const NodeType* node){
+					if constexpr(has_is_leaf){
+						return node->is_leaf;
+					}else{
+						for(auto It = node->child_begin(), End = node->child_end(); It != End; ++It){
+							if(*It){
+								return false;
+							}
+						}
+						return true;
+					}
+				}
+
+				// without a height field the height is computed, in O(size of subtree).
+				static size_t height(const NodeType* node){
+					if constexpr(has_height){
+						return node->height;
+					}else{
+						size_t Height = 0;
+						std::vector<std::pair<const NodeType*,size_t>> Pending{{node, 0}};
+						while(!Pending.empty()){
+							auto [Cur, Depth] = Pending.back();
+							Pending.pop_back();
+							Height = std::max(Height, Depth);
+							for(auto It = Cur->child_begin(), End = Cur->child_end(); It != End; ++It){
+								if(*It){
+									Pending.emplace_back(*It, Depth + 1);
+								}
+							}
+						}
+						return Height;
+					}
+				}
+
+				// nodes of the subtree(0 for an empty one), without a subtree_size field they are counted in O(size of subtree).
+				static size_t subtree_size(const NodeType* node){
+					if(!node){
+						return 0;
+					}
+					if constexpr(has_subtree_size){
+						return node->subtree_size;
+					}else{
+						size_t Size = 0;
+						std::vector<const NodeType*> Pending{node};
+						while(!Pending.empty()){
+							const NodeType* Cur = Pending.back();
+							Pending.pop_back();
+							++Size;
+							for(auto It = Cur->child_begin(), End = Cur->child_end(); It != End; ++It){
+								if(*It){
+									Pending.push_back(*It);
+								}
+							}
+						}
+						return Size;
+					}
+				}
+
+				// recompute is_leaf, child_size, subtree_size and aggregate after the children(or the data) of node changed,
+				// subtree sizes and aggregates of the children must be right already.
+				static void refresh(NodeType* node){
+					if constexpr(has_aggregate){
+						augmentation_trait<NodeType>::refresh(node);
+					}
+					if constexpr(has_subtree_size){
+						size_t Size = 1;
+						for(auto It = node->child_begin(), End = node->child_end(); It != End; ++It){
+							if(*It){
+								Size += (*It)->subtree_size;
+							}
+						}
+						node->subtree_size = Size;
+					}
+					if constexpr(has_child_size || has_is_leaf){
+						size_t Size = 0;
+						for(auto It = node->child_begin(), End = node->child_end(); It != End; ++It){
+							if(*It){
+								++Size;
+							}
+						}
+						if constexpr(has_child_size){
+							node->child_size = Size;
+						}
+						if constexpr(has_is_leaf){
+							node->is_leaf = Size == 0;
+						}
+					}
+				}
 			};
 
 
 			// used for B tree , B+ tree, a node can store an array of data.
-			template <typename DataType,size_t Size>
+			// Align over-aligns the keys, e.g. to start them on a cache line.
+			template <typename DataType,size_t Size,size_t Align=alignof(DataType)>
 			struct B_data_storage{
-				std::array<DataType,Size> data;
+				alignas(Align) std::array<DataType,Size> data;
 				size_t data_size;// data size <= Size
 				explicit B_data_storage() {
 					data_size = 0;
@@ -278,6 +797,142 @@ namespace ronleeon::tree::node{
 				static_assert(Size >= 2, "A B node must have at least 2 children");
             };
 
+            // B node linked by 32-bit indices, see abstract_indexed_bs_node.
+            template <typename DataType, size_t Size>
+            struct indexed_B_node final:abstract_node<indexed_B_node<DataType,Size>,DataType,Size
+                    ,B_data_storage<DataType, Size - 1>
+                    ,m_child_storage<indexed_B_node<DataType, Size>, Size, index_link<indexed_B_node<DataType, Size>>>
+                    ,index_link<indexed_B_node<DataType, Size>>>{
+				static_assert(Size >= 2, "A B node must have at least 2 children");
+				std::uint32_t self_index = 0;
+            };
+
+            // B node whose leaves only hold their keys.
+            // Leaves are allocated as split_B_node, internal nodes as split_B_node::internal_node which
+            // adds the children, the tree tells them apart by is_leaf (a node never changes its kind).
+            // In a B tree most nodes are leaves, so they no longer carry Size null children.
+            // The keys come first, with Align = 64 they start on a cache line and the children
+            // of internal nodes stay out of the lines a lookup in the keys touches.
+            template <typename DataType, size_t Size, size_t Align = alignof(DataType)>
+            struct split_B_internal_node;
+
+            template <typename DataType, size_t Size, size_t Align = alignof(DataType)>
+            struct split_B_node:B_data_storage<DataType, Size - 1, Align>{
+				static_assert(Size >= 2, "A B node must have at least 2 children");
+				using internal_node = split_B_internal_node<DataType, Size, Align>;
+
+				bool is_leaf;
+				split_B_node* parent;
+				explicit split_B_node():B_data_storage<DataType, Size - 1, Align>(),is_leaf(true),parent(nullptr){}
+				split_B_node(const split_B_node&)=delete;
+
+				// leaves have an empty child range.
+				using child_iterator=split_B_node**;
+				using const_child_iterator=split_B_node* const*;
+				using reverse_child_iterator=std::reverse_iterator<child_iterator>;
+				using const_reverse_child_iterator=std::reverse_iterator<const_child_iterator>;
+				child_iterator child_begin(){
+					return is_leaf ? nullptr : static_cast<internal_node*>(this)->children.data();
+				}
+				child_iterator child_end(){
+					return is_leaf ? nullptr : static_cast<internal_node*>(this)->children.data() + Size;
+				}
+				const_child_iterator child_begin()const{
+					return is_leaf ? nullptr : static_cast<const internal_node*>(this)->children.data();
+				}
+				const_child_iterator child_end()const{
+					return is_leaf ? nullptr : static_cast<const internal_node*>(this)->children.data() + Size;
+				}
+				const_child_iterator child_cbegin()const{
+					return child_begin();
+				}
+				const_child_iterator child_cend()const{
+					return child_end();
+				}
+				reverse_child_iterator child_rbegin(){
+					return reverse_child_iterator(child_end());
+				}
+				reverse_child_iterator child_rend(){
+					return reverse_child_iterator(child_begin());
+				}
+				const_reverse_child_iterator child_rbegin()const{
+					return const_reverse_child_iterator(child_end());
+				}
+				const_reverse_child_iterator child_rend()const{
+					return const_reverse_child_iterator(child_begin());
+				}
+				const_reverse_child_iterator child_crbegin()const{
+					return child_rbegin();
+				}
+				const_reverse_child_iterator child_crend()const{
+					return child_rend();
+				}
+            };
+
+            template <typename DataType, size_t Size, size_t Align>
+            struct split_B_internal_node final:split_B_node<DataType, Size, Align>{
+				std::array<split_B_node<DataType, Size, Align>*, Size> children;
+				explicit split_B_internal_node():split_B_node<DataType, Size, Align>(){
+					this->is_leaf = false;
+					children.fill(nullptr);
+				}
+            };
+
+			// the internal layout of a node type, the node type itself unless it declares internal_node.
+			template<typename NodeType,typename = void>
+			struct internal_node_of{
+				using type = NodeType;
+			};
+			template<typename NodeType>
+			struct internal_node_of<NodeType,std::void_t<typename NodeType::internal_node>>{
+				using type = typename NodeType::internal_node;
+			};
+
+			// B trees reach children through here, so that they work on nodes with a single layout (B_node)
+			// as well as on nodes with separate leaf and internal layouts (split_B_node).
+			// Split internal nodes do not store child_size, it is always data_size + 1.
+			template<typename NodeType>
+			struct B_node_layout{
+				using internal_node = typename internal_node_of<NodeType>::type;
+				static constexpr bool split = !std::is_same_v<internal_node, NodeType>;
+
+				static NodeType* child(const NodeType* node, size_t Index){
+					if constexpr(split){
+						return node->is_leaf ? nullptr : static_cast<const internal_node*>(node)->children[Index];
+					}else{
+						return node->children[Index];
+					}
+				}
+				// leaves only accept null children.
+				static void set_child(NodeType* node, size_t Index, NodeType* Child){
+					if constexpr(split){
+						if(node->is_leaf){
+							assert(!Child && "A leaf has no children");
+							return;
+						}
+						static_cast<internal_node*>(node)->children[Index] = Child;
+					}else{
+						node->children[Index] = Child;
+					}
+				}
+				static size_t child_size(const NodeType* node){
+					if constexpr(split){
+						return node->is_leaf ? 0 : node->data_size + 1;
+					}else{
+						return node->child_size;
+					}
+				}
+				static void set_child_size(NodeType* node, size_t ChildSize){
+					if constexpr(!split){
+						node->child_size = ChildSize;
+					}
+				}
+				// after data_size changed.
+				static void refresh_child_size(NodeType* node){
+					set_child_size(node, node->is_leaf ? 0 : node->data_size + 1);
+				}
+			};
+
 			// Their exists another B+ tree definition, which requires the number of keys and childrens are the same,
 			// the operations of find,insertion and erase are the same procedures, here only provides the same definition of
 			// B+ tree as B tree.
@@ -291,8 +946,9 @@ namespace ronleeon::tree::node{
 				static_assert(Size >= 2, "A Bplus node must have at least 2 children");
 
 				// Points to the pre node and next node.
-				Bplus_node* Pre;
-				Bplus_node* Next;
+				// Only leaves are linked, in order, internal nodes keep them null.
+				Bplus_node* Pre = nullptr;
+				Bplus_node* Next = nullptr;
 
             };
 
@@ -300,6 +956,20 @@ namespace ronleeon::tree::node{
 
 namespace ronleeon::heap::node {
 	// node classes for binary heap node or d-ary heap node or fibonacci heap node.
+
+	// Pairing heap node: the children of a node form a list from its leftmost child through `next`,
+	// `prev` links back to the left sibling, or to the parent for the leftmost child.
+	// A root has no prev and no next.
+	template<typename DataType>
+	struct pairing_node{
+		DataType data;
+		pairing_node* child = nullptr;
+		pairing_node* next = nullptr;
+		pairing_node* prev = nullptr;
+
+		template<typename... Args>
+		explicit pairing_node(std::in_place_t, Args&&... args):data(std::forward<Args>(args)...){}
+	};
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,197 @@
+// Provides a monotonic arena and an allocator on top of it,
+// nodes are carved from contiguous slabs and released all at once.
+
+#ifndef RONLEEON_ADT_NODE_ARENA_H
+#define RONLEEON_ADT_NODE_ARENA_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace ronleeon::tree{
+
+	// Slabs grow geometrically up to MaxSlabSize, so a tree of n nodes lives in
+	// O(log(n) + n/MaxSlabSize) slabs.
+	// Freed blocks are kept in small per-size free lists and reused by the next allocations,
+	// they only return to the system when the whole arena is released.
+	class node_arena{
+		struct slab{
+			slab* next;
+			size_t size;// usable bytes following the header.
+		};
+		struct free_block{
+			free_block* next;
+		};
+		// trees allocate one or two node sizes, a few classes are enough.
+		static constexpr size_t FreeListClasses = 4;
+
+		slab* _slabs = nullptr;
+		std::byte* _cur = nullptr;
+		std::byte* _end = nullptr;
+		size_t _next_slab_size;
+		size_t _slab_count = 0;
+		size_t _free_size[FreeListClasses] = {};
+		size_t _free_align[FreeListClasses] = {};
+		free_block* _free_head[FreeListClasses] = {};
+
+		static constexpr size_t MaxSlabSize = size_t(1) << 20;
+		static constexpr size_t SlabAlign = alignof(std::max_align_t);
+
+		void grow(size_t bytes, size_t align){
+			size_t size = _next_slab_size;
+			while(size < bytes + align){
+				size *= 2;
+			}
+			if(_next_slab_size < MaxSlabSize){
+				_next_slab_size *= 2;
+			}
+			// header is padded to keep the payload max aligned.
+			constexpr size_t Header = (sizeof(slab) + SlabAlign - 1) / SlabAlign * SlabAlign;
+			auto raw = static_cast<std::byte*>(::operator new(Header + size));
+			auto s = reinterpret_cast<slab*>(raw);
+			s->next = _slabs;
+			s->size = size;
+			_slabs = s;
+			++_slab_count;
+			_cur = raw + Header;
+			_end = _cur + size;
+		}
+
+		// returns null if the block is too small to be linked or all classes are taken.
+		free_block** free_list(size_t bytes, size_t align){
+			if(bytes < sizeof(free_block)){
+				return nullptr;
+			}
+			for(size_t Index = 0; Index < FreeListClasses; ++Index){
+				if(_free_size[Index] == 0){
+					_free_size[Index] = bytes;
+					_free_align[Index] = align;
+				}
+				if(_free_size[Index] == bytes && _free_align[Index] == align){
+					return &_free_head[Index];
+				}
+			}
+			return nullptr;
+		}
+	public:
+		explicit node_arena(size_t InitialSlabSize = 4096):_next_slab_size(InitialSlabSize){
+			assert(InitialSlabSize > 0 && "Slab size must be positive");
+		}
+		node_arena(const node_arena&) = delete;
+		node_arena& operator=(const node_arena&) = delete;
+		~node_arena(){
+			release();
+		}
+
+		void* allocate(size_t bytes, size_t align){
+			if(auto head = free_list(bytes, align); head && *head){
+				free_block* block = *head;
+				*head = block->next;
+				return block;
+			}
+			auto space = static_cast<size_t>(_end - _cur);
+			void* ptr = _cur;
+			if(!_cur || !std::align(align, bytes, ptr, space)){
+				grow(bytes, align);
+				ptr = _cur;
+				space = static_cast<size_t>(_end - _cur);
+				std::align(align, bytes, ptr, space);
+			}
+			_cur = static_cast<std::byte*>(ptr) + bytes;
+			return ptr;
+		}
+
+		// keep the block for reuse, memory is not returned until release().
+		void deallocate(void* ptr, size_t bytes, size_t align){
+			if(auto head = free_list(bytes, align)){
+				auto block = static_cast<free_block*>(ptr);
+				block->next = *head;
+				*head = block;
+			}
+		}
+
+		// free all slabs in O(#slabs), every block handed out becomes invalid.
+		void release(){
+			while(_slabs){
+				slab* next = _slabs->next;
+				::operator delete(_slabs);
+				_slabs = next;
+			}
+			_cur = _end = nullptr;
+			_slab_count = 0;
+			for(size_t Index = 0; Index < FreeListClasses; ++Index){
+				_free_size[Index] = 0;
+				_free_align[Index] = 0;
+				_free_head[Index] = nullptr;
+			}
+		}
+
+		[[nodiscard]] size_t slab_count() const {
+			return _slab_count;
+		}
+	};
+
+	// Allocator handing out memory from a node_arena.
+	// A default constructed allocator owns a fresh arena, copies (and rebinds) share it,
+	// so every tree built with a default arena_allocator gets its own arena.
+	template<typename T>
+	class arena_allocator{
+		template<typename U>
+		friend class arena_allocator;
+
+		std::shared_ptr<node_arena> _arena;
+	public:
+		using value_type = T;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+
+		arena_allocator():_arena(std::make_shared<node_arena>()){}
+		explicit arena_allocator(std::shared_ptr<node_arena> arena):_arena(std::move(arena)){}
+		template<typename U>
+		arena_allocator(const arena_allocator<U>& rhs) noexcept :_arena(rhs._arena){}
+
+		T* allocate(size_t n){
+			return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+		}
+		void deallocate(T* p, size_t n) noexcept {
+			_arena->deallocate(p, n * sizeof(T), alignof(T));
+		}
+
+		// whether release() is safe: no other allocator shares the arena.
+		[[nodiscard]] bool releasable() const {
+			return _arena.use_count() == 1;
+		}
+
+		// Release every slab at once, all blocks handed out by this arena become invalid.
+		void release(){
+			_arena->release();
+		}
+
+		const std::shared_ptr<node_arena>& arena() const {
+			return _arena;
+		}
+
+		template<typename U>
+		friend bool operator==(const arena_allocator& lhs, const arena_allocator<U>& rhs){
+			return lhs._arena == rhs._arena;
+		}
+		template<typename U>
+		friend bool operator!=(const arena_allocator& lhs, const arena_allocator<U>& rhs){
+			return lhs._arena != rhs._arena;
+		}
+	};
+
+	// allocators that can drop all their memory at once.
+	template<typename Allocator, typename = void>
+	struct is_bulk_releasable:std::false_type{};
+
+	template<typename Allocator>
+	struct is_bulk_releasable<Allocator, std::void_t<decltype(std::declval<Allocator&>().release())
+		, decltype(std::declval<const Allocator&>().releasable())>>:std::true_type{};
+
+}
+
+#endif
@@ -0,0 +1,193 @@
+// Provides a pool addressing nodes by 32-bit indices, links to pooled nodes
+// and an allocator handing out pooled nodes.
+
+#ifndef RONLEEON_ADT_NODE_POOL_H
+#define RONLEEON_ADT_NODE_POOL_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ronleeon::tree{
+
+	// Nodes of one type live in fixed size chunks and are addressed by a 32-bit index,
+	// chunks are never moved so node addresses stay valid while the pool grows.
+	// Index 0 stands for the null node, so up to 2^32-1 nodes.
+	// There is one pool per node type (see instance()), shared by every tree using it,
+	// it is not thread safe: all trees of one pooled node type must stay on one thread.
+	template<typename NodeType>
+	class node_pool{
+		static constexpr size_t ChunkBits = 10;
+		static constexpr size_t ChunkSize = size_t(1) << ChunkBits;
+		static constexpr size_t ChunkMask = ChunkSize - 1;
+
+		struct alignas(NodeType) slot{
+			std::byte bytes[sizeof(NodeType)];
+		};
+		static_assert(sizeof(slot) >= sizeof(std::uint32_t), "A free slot must hold the next free index");
+
+		std::vector<slot*> _chunks;
+		// chunk address -> chunk number, to find the index of a node.
+		std::map<const void*, std::uint32_t, std::less<>> _chunk_of;
+		// freed slots are chained through their first bytes.
+		std::uint32_t _free = 0;
+		std::uint32_t _next = 1;
+		size_t _size = 0;
+
+		node_pool() = default;
+	public:
+		node_pool(const node_pool&) = delete;
+		node_pool& operator=(const node_pool&) = delete;
+
+		// never destroyed, trees with static storage may outlive any other static object.
+		static node_pool& instance(){
+			static node_pool* Pool = new node_pool();
+			return *Pool;
+		}
+
+		// raw storage for one node.
+		NodeType* allocate(){
+			std::uint32_t index;
+			if(_free){
+				index = _free;
+				std::memcpy(&_free, slot_at(index), sizeof(_free));
+			}else{
+				if(_next == std::numeric_limits<std::uint32_t>::max()){
+					throw std::bad_alloc();
+				}
+				if((_next >> ChunkBits) >= _chunks.size()){
+					auto chunk = new slot[ChunkSize];
+					_chunk_of.emplace(chunk, static_cast<std::uint32_t>(_chunks.size()));
+					_chunks.push_back(chunk);
+				}
+				index = _next++;
+			}
+			++_size;
+			return reinterpret_cast<NodeType*>(slot_at(index));
+		}
+
+		void deallocate(NodeType* node){
+			std::uint32_t index = index_of(node);
+			std::memcpy(static_cast<void*>(node), &_free, sizeof(_free));
+			_free = index;
+			--_size;
+		}
+
+		NodeType* at(std::uint32_t index) const {
+			return reinterpret_cast<NodeType*>(slot_at(index));
+		}
+
+		// O(log(#chunks)), only used when a node is created or released.
+		std::uint32_t index_of(const NodeType* node) const {
+			auto It = _chunk_of.upper_bound(static_cast<const void*>(node));
+			assert(It != _chunk_of.begin() && "Node is not from this pool");
+			--It;
+			auto offset = static_cast<size_t>(reinterpret_cast<const slot*>(node) - static_cast<const slot*>(It->first));
+			assert(offset < ChunkSize && "Node is not from this pool");
+			return static_cast<std::uint32_t>((size_t(It->second) << ChunkBits) | offset);
+		}
+
+		[[nodiscard]] size_t size() const {
+			return _size;
+		}
+
+	private:
+		slot* slot_at(std::uint32_t index) const {
+			return &_chunks[index >> ChunkBits][index & ChunkMask];
+		}
+	};
+
+	// 32-bit link to a pooled node, reads and assigns like a plain NodeType*.
+	// Nodes linked this way carry their own index in `self_index`.
+	template<typename NodeType>
+	class index_link{
+		std::uint32_t _index;
+	public:
+		index_link():_index(0){}
+		index_link(std::nullptr_t):_index(0){}
+		index_link(NodeType* node):_index(node ? node->self_index : 0){
+			assert((!node || node->self_index) && "Node is not allocated by index_pool_allocator");
+		}
+		index_link& operator=(NodeType* node){
+			return *this = index_link(node);
+		}
+		index_link(const index_link&) = default;
+		index_link& operator=(const index_link&) = default;
+
+		NodeType* get() const {
+			return _index ? node_pool<NodeType>::instance().at(_index) : nullptr;
+		}
+		operator NodeType*() const {
+			return get();
+		}
+		NodeType* operator->() const {
+			return get();
+		}
+
+		[[nodiscard]] std::uint32_t index() const {
+			return _index;
+		}
+	};
+
+	template<typename NodeType, typename = void>
+	struct has_self_index:std::false_type{};
+
+	template<typename NodeType>
+	struct has_self_index<NodeType, std::void_t<decltype(std::declval<NodeType&>().self_index)>>:std::true_type{};
+
+	// Allocator handing out nodes of the pool of its type, nodes linked by index_link
+	// must be created through it (it fills their self_index).
+	// Every instance shares the same pool, so all of them compare equal.
+	template<typename T>
+	class index_pool_allocator{
+	public:
+		using value_type = T;
+
+		index_pool_allocator() = default;
+		template<typename U>
+		index_pool_allocator(const index_pool_allocator<U>&) noexcept {}
+
+		T* allocate(size_t n){
+			assert(n == 1 && "Pooled nodes are allocated one by one");
+			return node_pool<T>::instance().allocate();
+		}
+		void deallocate(T* p, size_t) noexcept {
+			node_pool<T>::instance().deallocate(p);
+		}
+
+		template<typename U, typename... Args>
+		void construct(U* p, Args&&... args){
+			::new(static_cast<void*>(p)) U(std::forward<Args>(args)...);
+			if constexpr(has_self_index<U>::value){
+				p->self_index = node_pool<U>::instance().index_of(p);
+			}
+		}
+
+		template<typename U>
+		friend bool operator==(const index_pool_allocator&, const index_pool_allocator<U>&){
+			return true;
+		}
+		template<typename U>
+		friend bool operator!=(const index_pool_allocator&, const index_pool_allocator<U>&){
+			return false;
+		}
+	};
+
+	// allocators handing out nodes of the shared, single threaded node_pool.
+	template<typename Allocator>
+	struct is_pool_allocator:std::false_type{};
+
+	template<typename T>
+	struct is_pool_allocator<index_pool_allocator<T>>:std::true_type{};
+
+}
+
+#endif
@@ -19,8 +19,8 @@ namespace ronleeon::tree{
                 os << t->data;
             }
             os << "]  ";
-            os<<"[Height:"<<t->height<<"] ";
-            if (t->is_leaf) {
+            os<<"[Height:"<<node::node_bookkeeping<NodeType>::height(t)<<"] ";
+            if (node::node_bookkeeping<NodeType>::is_leaf(t)) {
                 os << "Leaf";
             }
             else {
@@ -33,7 +33,7 @@ namespace ronleeon::tree{
             }else if(!t->left_child&&t->right_child){
                 os<<" has right child";
             }
-            if(t->color==NodeType::COLOR::RED){
+            if(node::rb_color_trait<NodeType>::color(t)==NodeType::COLOR::RED){
                 os<<" , color:red";
             }else{
                 os<<" , color:black";
@@ -42,11 +42,12 @@ namespace ronleeon::tree{
     };
     // Guarantee all NodeType data are not equal,otherwise the latter
     // will be ignored.
-    template<typename DataType,typename Compare=std::less<DataType>,typename NodeType=node::rb_node<DataType>,typename NodePrintTrait = rb_node_print_trait<NodeType>>
+    template<typename DataType,typename Compare=std::less<DataType>,typename NodeType=node::rb_node<DataType>,typename NodePrintTrait = rb_node_print_trait<NodeType>
+        ,typename Allocator = std::allocator<DataType>>
     class rb_tree:public abstract_bs_tree<DataType,Compare,NodeType
-        ,rb_tree<DataType,Compare,NodeType,NodePrintTrait>,NodePrintTrait>{
+        ,rb_tree<DataType,Compare,NodeType,NodePrintTrait,Allocator>,NodePrintTrait,Allocator>{
         using basic_type=abstract_bs_tree<DataType,Compare,NodeType
-            ,rb_tree<DataType,Compare,NodeType,NodePrintTrait>,NodePrintTrait>;
+            ,rb_tree<DataType,Compare,NodeType,NodePrintTrait,Allocator>,NodePrintTrait,Allocator>;
         // prohibit all create functions.
         using basic_type::shift_height;
 
@@ -61,45 +62,104 @@ namespace ronleeon::tree{
 		using PrintTrait = typename basic_type::PrintTrait;
     private:
 
-        explicit rb_tree(std::nullptr_t, Compare comp_ = Compare{} ):basic_type(nullptr, comp_){}
+        explicit rb_tree(std::nullptr_t, Compare comp_ = Compare{}, const Allocator& alloc = Allocator() ):basic_type(nullptr, comp_, alloc){}
 
+        // colors are read and written through the trait, tagged nodes have no color field.
+        static typename NodeType::COLOR color(const_node_pointer node){
+            return node::rb_color_trait<NodeType>::color(node);
+        }
+        static void set_color(node_pointer node,typename NodeType::COLOR color){
+            node::rb_color_trait<NodeType>::set_color(node,color);
+        }
 
+
+        // children of node changed, keep its bookkeeping (and heights above it) right.
         void shift_rb_node(node_pointer node){
-            while(node){
-                size_t left_height=0,right_height=0;
-                if(node->left_child&&node->right_child){
-                    left_height=node->left_child->height;
-                    right_height=node->right_child->height;
-                    node->height=std::max(left_height,right_height)+1;
-                    node->is_leaf=false;
-                    node->child_size=2;
-                }else if(node->left_child){
-                    node->height=node->left_child->height+1;
-                    node->is_leaf=false;
-                    node->child_size=1;
-                }else if(node->right_child){
-                    node->height=node->right_child->height+1;
-                    node->is_leaf=false;
-                    node->child_size=1;
+            if(!node){
+                return;
+            }
+            basic_type::node_bookkeeping::refresh(node);
+            if constexpr(basic_type::node_bookkeeping::has_height){
+                // a node whose children just changed may keep its stale height while the one it replaced
+                // differs, so always recompute it and start the climb at its parent.
+                size_t height=0;
+                if(node->left_child){
+                    height=static_cast<size_t>(node->left_child->height)+1;
+                }
+                if(node->right_child){
+                    height=std::max(height,static_cast<size_t>(node->right_child->height)+1);
+                }
+                node->height=height;
+                basic_type::shift_height(node->parent);
+            }
+        }
+
+
+        // a new node is red, recolor and rotate above it.
+        void link_new_node(node_pointer parent, node_pointer node) override {
+            ++basic_type::num_of_nodes;
+            if(!parent){
+                // root.
+                basic_type::_root=node;
+                basic_type::min_node = basic_type::max_node = node;
+            }else{
+                if(basic_type::comp(node->data,parent->data)){
+                    assert(!parent->left_child);
+                    parent->left_child=node;
                 }else{
-                    node->is_leaf=true;
-                    node->height=0;
-                    node->child_size=0;
+                    assert(!parent->right_child);
+                    parent->right_child=node;
                 }
-                node=node->parent;
+                node->parent=parent;
+                basic_type::node_bookkeeping::refresh(parent);
             }
+            // update min_node and max_node.
+			if(basic_type::min_node&& (basic_type::min_node->left_child == node)){
+				basic_type::min_node = node;
+			}
+			if(basic_type::max_node&&(basic_type::max_node->right_child == node)){
+				basic_type::max_node = node;
+			}
+            shift_rb_node(node);
+            fix_after_insert(node);
+            basic_type::refresh_augmented_path(node);
+        }
 
+        // node cannot have two children, recolor and rotate above it before it is unlinked.
+        void cut_node(node_pointer node) override {
+            --basic_type::num_of_nodes;
+            node_pointer child=node->left_child?node->left_child:node->right_child;
+            if(child){
+                // if node has a child, then the child color must be red.
+                // so node color must be black, color the child black instead.
+                set_color(child,NodeType::COLOR::BLACK);
+            }else{
+                fix_after_erase(node);
+            }
+            node_pointer parent=basic_type::unlink_node(node);
+            shift_rb_node(parent);
+            basic_type::refresh_augmented_path(parent);
         }
 
+        // colors belong to the place of a node, a node leaving the tree is red again like a new one.
+        void swap_balance(node_pointer lhs, node_pointer rhs) override {
+            auto Color=color(lhs);
+            set_color(lhs,color(rhs));
+            set_color(rhs,Color);
+        }
+
+        void reset_balance(node_pointer node) override {
+            set_color(node,NodeType::COLOR::RED);
+        }
 
         void fix_after_insert(node_pointer node){
             if(node==basic_type::_root){
-                node->color=NodeType::COLOR::BLACK;
+                set_color(node,NodeType::COLOR::BLACK);
                 return;
             }
             // node is not the root.
             node_pointer parent=node->parent;
-            if(parent->color==NodeType::COLOR::BLACK){
+            if(color(parent)==NodeType::COLOR::BLACK){
                 // node is red and its parent is black, not violate
                 // any rules of rb tree.
                 return;
@@ -115,17 +175,17 @@ namespace ronleeon::tree{
                     parent=node;
                     node=parent->right_child;
                 }
-                if(uncle&&uncle->color==NodeType::COLOR::RED){
-                    parent->color=NodeType::COLOR::BLACK;
-                    gparent->color=NodeType::COLOR::RED;
-                    uncle->color=NodeType::COLOR::BLACK;
+                if(uncle&&color(uncle)==NodeType::COLOR::RED){
+                    set_color(parent,NodeType::COLOR::BLACK);
+                    set_color(gparent,NodeType::COLOR::RED);
+                    set_color(uncle,NodeType::COLOR::BLACK);
                     // this situation we need recursively re-modify because now gparent
                     // is red which may be conflict with its parent.
                     fix_after_insert(gparent);
                 }else{
                     left_rotation(gparent);
-                    gparent->color=NodeType::COLOR::RED;
-                    parent->color=NodeType::COLOR::BLACK;
+                    set_color(gparent,NodeType::COLOR::RED);
+                    set_color(parent,NodeType::COLOR::BLACK);
                 }
             }else{
                 uncle=gparent->right_child;
@@ -135,128 +195,93 @@ namespace ronleeon::tree{
                     parent=node;
                     node=parent->left_child;
                 }
-                if(uncle&&uncle->color==NodeType::COLOR::RED){
-                    parent->color=NodeType::COLOR::BLACK;
-                    gparent->color=NodeType::COLOR::RED;
-                    uncle->color=NodeType::COLOR::BLACK;
+                if(uncle&&color(uncle)==NodeType::COLOR::RED){
+                    set_color(parent,NodeType::COLOR::BLACK);
+                    set_color(gparent,NodeType::COLOR::RED);
+                    set_color(uncle,NodeType::COLOR::BLACK);
                     // this situation we need recursively re-modify because now gparent
                     // is red which may be conflict with its parent.
                     fix_after_insert(gparent);
                 }else{
                     right_rotation(gparent);
-                    gparent->color=NodeType::COLOR::RED;
-                    parent->color=NodeType::COLOR::BLACK;
+                    set_color(gparent,NodeType::COLOR::RED);
+                    set_color(parent,NodeType::COLOR::BLACK);
                 }
             }
 
         }
 
-        // property: every path within current node may have one less black.
+        // node is a leaf about to be unlinked, if it is black every path through it
+        // would have one less black, rebalance first.
         void fix_after_erase(node_pointer node){
-            assert(node->is_leaf);
-            // There are much complex cases.
-            if(node->color==NodeType::COLOR::RED){
-                // red leaf ,can safely delete ok!
-                return;
-            }
+            assert(basic_type::node_bookkeeping::is_leaf(node));
             node_pointer P;//parent
             node_pointer S;// sibling
-            node_pointer C;// close newphew
-            node_pointer D;// distant newphew
-            while((P=node->parent)!=nullptr){
+            while(node!=basic_type::_root&&is_black(node)){
+                P=node->parent;
                 // because node is black, so its sibling must be not null.
                 if(node==P->left_child){
                     S=P->right_child;
-                    if(S->color==NodeType::COLOR::RED){
+                    if(is_red(S)){
+                        set_color(S,NodeType::COLOR::BLACK);
+                        set_color(P,NodeType::COLOR::RED);
                         left_rotation(P);
-                        P->color=NodeType::COLOR::RED;
-                        S->color=NodeType::COLOR::BLACK;
-                        S=C;
+                        S=P->right_child;
                     }
-                    D=S->right_child;
-                    if(D&&D->color==NodeType::COLOR::RED){
-                        left_rotation(P);
-                        S->color=P->color;
-                        P->color=NodeType::COLOR::BLACK;
-                        D->color=NodeType::COLOR::BLACK;
-                        return;//complete
+                    if(is_black(S->left_child)&&is_black(S->right_child)){
+                        // all black.
+                        set_color(S,NodeType::COLOR::RED);
+                        node=P;
+                        continue;
                     }
-                    C=S->left_child;
-                    if(C&&C->color==NodeType::COLOR::RED){
+                    if(is_black(S->right_child)){
+                        // close nephew is red.
+                        set_color(S->left_child,NodeType::COLOR::BLACK);
+                        set_color(S,NodeType::COLOR::RED);
                         right_rotation(S);
-                        S->color=NodeType::COLOR::RED;
-                        C->color=NodeType::COLOR::BLACK;
-                        D=S;
-                        S=C;
-                    }
-                    if(P->color==NodeType::COLOR::RED){
-                        S->color=NodeType::COLOR::RED;
-                        P->color=NodeType::COLOR::BLACK;
-                        return;// complete
+                        S=P->right_child;
                     }
-                    // all black.
-                    S->color=NodeType::COLOR::RED;
-                    node=P;
+                    // distant nephew is red.
+                    set_color(S,color(P));
+                    set_color(P,NodeType::COLOR::BLACK);
+                    set_color(S->right_child,NodeType::COLOR::BLACK);
+                    left_rotation(P);
+                    return;//complete
                 }else{
                     // symmetric
                     S=P->left_child;
-                    if(S->color==NodeType::COLOR::RED){
+                    if(is_red(S)){
+                        set_color(S,NodeType::COLOR::BLACK);
+                        set_color(P,NodeType::COLOR::RED);
                         right_rotation(P);
-                        P->color=NodeType::COLOR::RED;
-                        S->color=NodeType::COLOR::BLACK;
-                        S=C;
+                        S=P->left_child;
                     }
-                    D=S->left_child;
-                    if(D&&D->color==NodeType::COLOR::RED){
-                        left_rotation(P);
-                        S->color=P->color;
-                        P->color=NodeType::COLOR::BLACK;
-                        D->color=NodeType::COLOR::BLACK;
-                        return;//complete
+                    if(is_black(S->left_child)&&is_black(S->right_child)){
+                        set_color(S,NodeType::COLOR::RED);
+                        node=P;
+                        continue;
                     }
-                    C=S->right_child;
-                    if(C&&C->color==NodeType::COLOR::RED){
+                    if(is_black(S->left_child)){
+                        set_color(S->right_child,NodeType::COLOR::BLACK);
+                        set_color(S,NodeType::COLOR::RED);
                         left_rotation(S);
-                        S->color=NodeType::COLOR::RED;
-                        C->color=NodeType::COLOR::BLACK;
-                        D=S;
-                        S=C;
-                    }
-                    if(P->color==NodeType::COLOR::RED){
-                        S->color=NodeType::COLOR::RED;
-                        P->color=NodeType::COLOR::BLACK;
-                        return;// complete
+                        S=P->left_child;
                     }
-                    // all black.
-                    S->color=NodeType::COLOR::RED;
-                    node=P;
+                    set_color(S,color(P));
+                    set_color(P,NodeType::COLOR::BLACK);
+                    set_color(S->left_child,NodeType::COLOR::BLACK);
+                    right_rotation(P);
+                    return;//complete
                 }
-
-                node->color=NodeType::COLOR::BLACK;// node may be escaped but still be black.
             }
+            set_color(node,NodeType::COLOR::BLACK);// node may be escaped but still be black.
         }
 
 
         void left_rotation(node_pointer node){
             node_pointer right=node->right_child;
             node_pointer left=(right)->left_child;
-            node_pointer parent=node->parent;
-            node_pointer* point_to_node=nullptr;
-            if(parent){
-                if(node==(parent)->left_child){
-                    point_to_node=(node_pointer*)&(parent->left_child);
-                }else{
-                    point_to_node=(node_pointer*)&(parent->right_child);
-                }
-            }
-            if(point_to_node){
-                *point_to_node=right;
-                right->parent=parent;
-            }else{
-                // node is the root.
-                basic_type::_root=right;
-                right->parent=nullptr;
-            }
+            basic_type::replace_child(node->parent,node,right);
             node->right_child=left;
             if(left){
                 left->parent=node;
@@ -271,23 +296,7 @@ namespace ronleeon::tree{
         void right_rotation(node_pointer node){
             node_pointer left=node->left_child;
             node_pointer right=left->right_child;
-            node_pointer parent=node->parent;
-            node_pointer* point_to_node=nullptr;
-            if(parent){
-                if(node==parent->left_child){
-                    point_to_node=(node_pointer*)&(parent->left_child);
-                }else{
-                    point_to_node=(node_pointer*)&(parent->right_child);
-                }
-            }
-            if(point_to_node){
-                *point_to_node=left;
-                left->parent=parent;
-            }else{
-                // node is the root.
-                basic_type::_root=left;
-                left->parent=nullptr;
-            }
+            basic_type::replace_child(node->parent,node,left);
             node->left_child=right;
             if(right){
                 right->parent=node;
@@ -300,186 +309,161 @@ namespace ronleeon::tree{
 
         }
 
-    public:
-        rb_tree(Compare comp_ = Compare{}):rb_tree(nullptr, comp_){};
-        rb_tree(const rb_tree&)=delete;
-        rb_tree(const DataType data[],size_t Size, Compare comp_ = Compare{}):basic_type(data,Size, comp_){
-        }
-        rb_tree(rb_tree && tree) noexcept :basic_type(std::move(tree)) {}
-
-        [[nodiscard]] std::string to_string()const override {
-            return "<-RB(Red,Black) Tree->";
-        }
-
-        // insert the data if find it, ignored!
-        // the second returns whether insert operation is successful.
-        std::pair<const_node_pointer,bool> insert(const DataType& data) override {
-            std::pair<const_node_pointer,bool> find_result=basic_type::find(data);
-            node_pointer node=const_cast<node_pointer>(find_result.first);
-            if(find_result.second){
-                find_result.second=false;
-                return find_result;
+        // Join policy of the set algebra(see abstract_bs_tree::union_of), the rank is the black height
+        // (black nodes on a path down to an empty link). Subtrees may have a red root.
+        struct rb_join{
+            static bool black(const_node_pointer node){
+                return !node||color(node)==NodeType::COLOR::BLACK;
             }
-            ++basic_type::num_of_nodes;
-            if(!find_result.first){
-                // root.
-                basic_type::_root=new NodeType();
-                basic_type::_root->data = data;
-                find_result.first=basic_type::_root;
-                node=basic_type::_root;
-                find_result.second=true;
-                basic_type::min_node = basic_type::max_node = basic_type::_root;
-            }else{
-                auto child=new NodeType();
-                child->data = data;
-                if(basic_type::comp(data,node->data)){
-                    assert(!node->left_child);
-                    node->left_child=child;
-                    find_result.first=node;
-                    find_result.second=true;
-                    node->is_leaf=false;
-                    child->parent=node;
-                    ++node->child_size;
-                }else{
-                    assert(!node->right_child);
-                    node->right_child=child;
-                    find_result.first=node;
-                    find_result.second=true;
-                    node->is_leaf=false;
-                    child->parent=node;
-                    ++node->child_size;
+
+            static int rank(const_node_pointer root){
+                int BlackHeight = 0;
+                for(; root; root = root->left_child){
+                    if(black(root)){
+                        ++BlackHeight;
+                    }
                 }
-                node=child;
+                return BlackHeight;
             }
-            // update min_node and max_node.
-			if(basic_type::min_node&& (basic_type::min_node->left_child == node)){
-				basic_type::min_node = node;
-			}
-			if(basic_type::max_node&&(basic_type::max_node->right_child == node)){
-				basic_type::max_node = node;
-			}            
-            shift_rb_node(node);
-            fix_after_insert(node);
-            return find_result;
-        }
 
-        const_node_pointer erase(node_pointer node,bool left = true) override {
-            if(!node){
-                return nullptr;
+            static int child_rank(const_node_pointer node, int Rank, bool){
+                return Rank - (black(node) ? 1 : 0);
             }
-            --basic_type::num_of_nodes;
-            const_node_pointer Ret=basic_type::increment(node);
-            if(node->left_child&&node->right_child){
-                if(left){
-                    auto left=basic_type::left_most(node->left_child);
-                    // cannot be empty.
-                    node->data=left->data;
-                    // now left do not have right_child.
-                    node=const_cast<node_pointer>(left);
-                }else{
-                    auto right=basic_type::right_most(node->right_child);
-                    // cannot be empty.
-                    node->data=right->data;
-                    // now right do not have right_child.
-                    node=const_cast<node_pointer>(right);
+
+            // l is higher(or red) and r has a black root, k goes down the right spine of l to the first black
+            // subtree as high as r. Only a red root with a red right child is left to the caller,
+            // a black node above fixes it by a left rotation.
+            static node_pointer join_right(node_pointer l, int LeftRank, node_pointer k, node_pointer r, int RightRank){
+                if(LeftRank == RightRank && black(l)){
+                    basic_type::link_children(k, l, r);
+                    set_color(k, NodeType::COLOR::RED);
+                    return k;
                 }
+                node_pointer right = join_right(l->right_child, child_rank(l, LeftRank, false), k, r, RightRank);
+                basic_type::link_children(l, l->left_child, right);
+                if(black(l) && !black(right) && !black(right->right_child)){
+                    set_color(right->right_child, NodeType::COLOR::BLACK);
+                    basic_type::link_children(l, l->left_child, right->left_child);
+                    basic_type::link_children(right, l, right->right_child);
+                    return right;
+                }
+                return l;
             }
-            // now node cannot have two childs.
-            node_pointer parent=node->parent;
-            node_pointer* point_to_node;
-            // newParent records the new min node when node is min_node
-            // records the new max node when node is max_node
-            const_node_pointer newParent = nullptr;
-            if(!parent){
-                // root.
-                point_to_node=nullptr;
-            }else if(node==parent->left_child){
-                point_to_node=(node_pointer*)&((parent->left_child));
-            }else{
-                point_to_node=(node_pointer*)&((parent->right_child));
+
+            // symmetric.
+            static node_pointer join_left(node_pointer l, int LeftRank, node_pointer k, node_pointer r, int RightRank){
+                if(LeftRank == RightRank && black(r)){
+                    basic_type::link_children(k, l, r);
+                    set_color(k, NodeType::COLOR::RED);
+                    return k;
+                }
+                node_pointer left = join_left(l, LeftRank, k, r->left_child, child_rank(r, RightRank, true));
+                basic_type::link_children(r, left, r->right_child);
+                if(black(r) && !black(left) && !black(left->left_child)){
+                    set_color(left->left_child, NodeType::COLOR::BLACK);
+                    basic_type::link_children(r, left->right_child, r->right_child);
+                    basic_type::link_children(left, left->left_child, r);
+                    return left;
+                }
+                return r;
             }
-            if(node->is_leaf){
-                // delete directly.
-                if(point_to_node){
-                    fix_after_erase(node);
-                    *point_to_node=nullptr;
-                    --parent->child_size;
-                    if(parent->child_size==0){
-                        parent->is_leaf=true;
-                    }
-                }else{
-                    basic_type::_root=nullptr;
+
+            // both roots are made black first, the root of the result is black too.
+            static node_pointer join(node_pointer l, int LeftRank, node_pointer k, node_pointer r, int RightRank, int& Rank){
+                if(!black(l)){
+                    set_color(l, NodeType::COLOR::BLACK);
+                    ++LeftRank;
                 }
-                newParent = node->parent;
-                node->parent=nullptr;
-                shift_rb_node(parent);
-            }else if(node->left_child){
-                // if node has left child, then its left child color must be red.
-                // so node color must be black.
-                if(point_to_node){
-                    node->left_child->parent=parent;
-                    *point_to_node=node->left_child;
-                    // color its child to black.
-                    (node->left_child)->color=NodeType::COLOR::BLACK;
-                }else{
-                    basic_type::_root=node->left_child;
-                    node->left_child->parent=nullptr;
-                    // root must be black.
-                    (node->left_child)->color=NodeType::COLOR::BLACK;
+                if(!black(r)){
+                    set_color(r, NodeType::COLOR::BLACK);
+                    ++RightRank;
                 }
-                newParent = node->left_child;
-                node->parent=nullptr;
-                node->left_child=nullptr;
-                shift_rb_node(parent);
-            }else if(node->right_child){
-                // if node has right child, then its right child color must be red.
-                // so node color must be black.
-                if(point_to_node){
-                    node->right_child->parent=parent;
-                    *point_to_node=node->right_child;
-                    // color its child to black.
-                    (node->right_child)->color=NodeType::COLOR::BLACK;
+                node_pointer root;
+                if(LeftRank > RightRank){
+                    root = join_right(l, LeftRank, k, r, RightRank);
+                }else if(RightRank > LeftRank){
+                    root = join_left(l, LeftRank, k, r, RightRank);
                 }else{
-                    basic_type::_root=node->right_child;
-                    node->right_child->parent=nullptr;
-                    // root must be black.
-                    (node->right_child)->color=NodeType::COLOR::BLACK;
+                    basic_type::link_children(k, l, r);
+                    set_color(k, NodeType::COLOR::RED);
+                    root = k;
+                }
+                Rank = std::max(LeftRank, RightRank);
+                if(!black(root)){
+                    set_color(root, NodeType::COLOR::BLACK);
+                    ++Rank;
                 }
-                newParent = node->right_child;
-                node->parent=nullptr;
-                node->right_child=nullptr;
-                shift_rb_node(parent);
+                return root;
+            }
+        };
+
+    public:
+        rb_tree(Compare comp_ = Compare{}, const Allocator& alloc = Allocator()):rb_tree(nullptr, comp_, alloc){};
+        rb_tree(const rb_tree&)=delete;
+        rb_tree(const DataType data[],size_t Size, Compare comp_ = Compare{}, const Allocator& alloc = Allocator()):rb_tree(nullptr, comp_, alloc){
+            if(basic_type::is_sorted_unique(data, data + Size)){
+                build_from_sorted(data, data + Size);
+                return;
+            }
+            for(size_t Index=0;Index<Size;++Index){
+                insert(data[Index]);
             }
-            if(basic_type::_root == nullptr){
-				// empty
-				basic_type::min_node = basic_type::max_node = nullptr;
-			}else{
-				if(node == basic_type::min_node){
-					basic_type::min_node = newParent;
-				}
-				if(node == basic_type::max_node){
-					basic_type::max_node = newParent;
-				}
-			}
-            delete node;
-            return Ret;
         }
+        rb_tree(rb_tree && tree) noexcept :basic_type(std::move(tree)) {}
 
-        const_node_pointer erase(const_node_pointer node, bool left = true){
-            return erase(const_cast<node_pointer>(node), left);
+        // Replace the content by the strictly increasing data of [first, last) in O(n).
+        // All empty links are on the last two levels: the nodes of the deepest level(unless it is the root)
+        // are red and the others black, every path then has the same number of black nodes.
+        template<typename ForwardIt>
+        void build_from_sorted(ForwardIt first, ForwardIt last){
+            basic_type::build_balanced(first, last, [](node_pointer node, size_t Depth, size_t MaxDepth, int, int){
+                set_color(node, Depth == MaxDepth && Depth > 0 ? NodeType::COLOR::RED : NodeType::COLOR::BLACK);
+            });
         }
 
-        void erase(const DataType& data,bool left=true){
-            auto find_result=basic_type::find(data);
-            if(!find_result.second){
-                return;
-            }
-            erase(find_result.first,left);
+        // Set algebra by joins, in O(m log(n/m + 1)) work and on several threads for big trees
+        // (subproblems under ParallelGrain nodes stay on the calling thread).
+        // Nodes move between the trees, other is left empty, see abstract_bs_tree::union_of.
+
+        // add the data of other, data already here is kept.
+        void union_with(rb_tree& other, size_t ParallelGrain = basic_type::DefaultParallelGrain){
+            basic_type::union_of(rb_join{}, other, ParallelGrain);
         }
 
+        // keep the data also in other.
+        void intersect_with(rb_tree& other, size_t ParallelGrain = basic_type::DefaultParallelGrain){
+            basic_type::intersection_of(rb_join{}, other, ParallelGrain);
+        }
+
+        // erase the data also in other.
+        void difference_with(rb_tree& other, size_t ParallelGrain = basic_type::DefaultParallelGrain){
+            basic_type::difference_of(rb_join{}, other, ParallelGrain);
+        }
+
+        // append greater, whose data are all greater than the data here, in O(log n).
+        void join(rb_tree& greater){
+            basic_type::join_with(rb_join{}, greater);
+        }
+
+        // move the data not less than key to greater in O(log n) (plus recounting the smaller part unless nodes are sized),
+        // returns whether key was here.
+        bool split(const DataType& key, rb_tree& greater){
+            return basic_type::split_at(rb_join{}, key, greater);
+        }
+
+        [[nodiscard]] std::string to_string()const override {
+            return "<-RB(Red,Black) Tree->";
+        }
+
+        // insert, emplace and try_emplace link their new node through link_new_node.
+        using basic_type::insert;
+
+        // erase and extract unlink their node through cut_node.
+        using basic_type::erase;
+
         // NOTE: null node is also black.
         bool is_black(const_node_pointer node) const {
-            if(!node||node->color==NodeType::COLOR::BLACK){
+            if(!node||color(node)==NodeType::COLOR::BLACK){
                 return true;
             }
             return false;
@@ -0,0 +1,328 @@
+// provides a self-adjusting binary sort tree: every access moves the accessed node to the root.
+
+#ifndef RONLEEON_ADT_SPLAY_TREE_H
+#define RONLEEON_ADT_SPLAY_TREE_H
+
+#include "ronleeon/tree/abstract_tree.h"
+#include <istream>
+namespace ronleeon::tree{
+
+	// Guarantee all NodeType data are not equal,otherwise the latter
+	// will be ignored.
+
+	// Splaying is top-down (Sleator and Tarjan): one descent from the root splits the tree into the
+	// nodes less and greater than the key and joins them below the last node reached, so no walk back
+	// through the parents is needed. Operations take O(log n) amortized, and frequently accessed data
+	// stay near the root, which pays off for skewed accesses.
+	// find on a non-const tree splays (a const tree only searches), iterators are never invalidated
+	// by splaying. The depth is unbounded, so the default node keeps no height: refreshing it would
+	// read every child hanging off the splayed path.
+	template<typename DataType,typename Compare=std::less<DataType>,typename NodeType=node::compact_bs_node<DataType>,typename NodePrintTrait = b_node_print_trait<NodeType>
+		,typename Allocator = std::allocator<DataType>>
+	class splay_tree:public abstract_bs_tree<DataType,Compare,NodeType
+		,splay_tree<DataType,Compare,NodeType,NodePrintTrait,Allocator>,NodePrintTrait,Allocator>{
+		using basic_type=abstract_bs_tree<DataType,Compare,NodeType
+			,splay_tree<DataType,Compare,NodeType,NodePrintTrait,Allocator>,NodePrintTrait,Allocator>;
+		using basic_type::shift_height;
+
+	public:
+		using node_type = NodeType;
+		using node_pointer = NodeType*;
+		using node_type_reference = NodeType&;
+		using const_node_type = const NodeType;
+		using const_node_pointer = const NodeType*;
+		using const_node_type_reference = const NodeType&;
+
+		using PrintTrait = typename basic_type::PrintTrait;
+		using node_handle_type = typename basic_type::node_handle_type;
+	private:
+
+		explicit splay_tree(std::nullptr_t, Compare comp_ = Compare{}, const Allocator& alloc = Allocator() ):basic_type(nullptr, comp_, alloc){}
+
+		// recompute the bookkeeping fields(height, size, aggregate) of node from its children.
+		static void refresh(node_pointer node){
+			basic_type::link_children(node, node->left_child, node->right_child);
+		}
+
+		// Bring the node holding data, or the last node of the search path if data is not here, to the root.
+		// data may be any key a transparent Compare orders against DataType.
+		// Nodes less than data are gathered in a left tree along its right spine, nodes greater in a right tree
+		// along its left spine, the spines are refreshed bottom-up once both trees are hung below the new root.
+		template<typename Key>
+		node_pointer splay(const Key& data){
+			node_pointer node = basic_type::_root;
+			if(!node){
+				return nullptr;
+			}
+			node_pointer LeftTop = nullptr, LeftEnd = nullptr;
+			node_pointer RightTop = nullptr, RightEnd = nullptr;
+			while(true){
+				if(basic_type::comp(data, node->data)){
+					node_pointer left = node->left_child;
+					if(!left){
+						break;
+					}
+					if(basic_type::comp(data, left->data)){
+						// zig-zig: rotate right, node is then final.
+						node->left_child = left->right_child;
+						if(node->left_child){
+							node->left_child->parent = node;
+						}
+						left->right_child = node;
+						node->parent = left;
+						refresh(node);
+						node = left;
+						if(!node->left_child){
+							break;
+						}
+					}
+					// link node to the right tree.
+					if(RightEnd){
+						RightEnd->left_child = node;
+						node->parent = RightEnd;
+					}else{
+						RightTop = node;
+					}
+					RightEnd = node;
+					node = node->left_child;
+				}else if(basic_type::comp(node->data, data)){
+					node_pointer right = node->right_child;
+					if(!right){
+						break;
+					}
+					if(basic_type::comp(right->data, data)){
+						// zig-zig: rotate left, node is then final.
+						node->right_child = right->left_child;
+						if(node->right_child){
+							node->right_child->parent = node;
+						}
+						right->left_child = node;
+						node->parent = right;
+						refresh(node);
+						node = right;
+						if(!node->right_child){
+							break;
+						}
+					}
+					// link node to the left tree.
+					if(LeftEnd){
+						LeftEnd->right_child = node;
+						node->parent = LeftEnd;
+					}else{
+						LeftTop = node;
+					}
+					LeftEnd = node;
+					node = node->right_child;
+				}else{
+					break;
+				}
+			}
+			// assemble.
+			if(LeftEnd){
+				LeftEnd->right_child = node->left_child;
+				if(LeftEnd->right_child){
+					LeftEnd->right_child->parent = LeftEnd;
+				}
+				node->left_child = LeftTop;
+				LeftTop->parent = node;
+				for(node_pointer Spine = LeftEnd; Spine != node; Spine = Spine->parent){
+					refresh(Spine);
+				}
+			}
+			if(RightEnd){
+				RightEnd->left_child = node->right_child;
+				if(RightEnd->left_child){
+					RightEnd->left_child->parent = RightEnd;
+				}
+				node->right_child = RightTop;
+				RightTop->parent = node;
+				for(node_pointer Spine = RightEnd; Spine != node; Spine = Spine->parent){
+					refresh(Spine);
+				}
+			}
+			node->parent = nullptr;
+			refresh(node);
+			basic_type::_root = node;
+			return node;
+		}
+
+		// node, new, becomes the root: root, just splayed at its data(or null for an empty tree),
+		// goes below it on the side of its order, with the subtree of root on the other side.
+		void link_root(node_pointer root, node_pointer node){
+			++basic_type::num_of_nodes;
+			if(!root){
+				basic_type::min_node = basic_type::max_node = node;
+				refresh(node);
+			}else if(basic_type::comp(node->data, root->data)){
+				node_pointer left = root->left_child;
+				basic_type::link_children(root, nullptr, root->right_child);
+				basic_type::link_children(node, left, root);
+				if(basic_type::min_node == root && !left){
+					basic_type::min_node = node;
+				}
+			}else{
+				node_pointer right = root->right_child;
+				basic_type::link_children(root, root->left_child, nullptr);
+				basic_type::link_children(node, root, right);
+				if(basic_type::max_node == root && !right){
+					basic_type::max_node = node;
+				}
+			}
+			basic_type::_root = node;
+		}
+
+		// unlink the root, its left subtree is splayed at its max which takes the right subtree.
+		// The node is returned, not released.
+		node_pointer unlink_root(){
+			node_pointer node = basic_type::_root;
+			node_pointer left = node->left_child;
+			node_pointer right = node->right_child;
+			--basic_type::num_of_nodes;
+			if(node == basic_type::min_node){
+				basic_type::min_node = basic_type::increment(node);
+			}
+			if(node == basic_type::max_node){
+				basic_type::max_node = basic_type::decrement(node);
+			}
+			if(!left){
+				basic_type::_root = right;
+				if(right){
+					right->parent = nullptr;
+				}
+			}else{
+				left->parent = nullptr;
+				basic_type::_root = left;
+				// every data of left is less than the erased one.
+				node_pointer root = splay(node->data);
+				basic_type::link_children(root, root->left_child, right);
+			}
+			node->parent = node->left_child = node->right_child = nullptr;
+			return node;
+		}
+
+		void erase_root(){
+			basic_type::deallocate_node(unlink_root());
+		}
+
+	public:
+		splay_tree(Compare comp_ = Compare{}, const Allocator& alloc = Allocator()):splay_tree(nullptr, comp_, alloc){};
+		splay_tree(const splay_tree&)=delete;
+		splay_tree(const DataType data[],size_t Size, Compare comp_ = Compare{}, const Allocator& alloc = Allocator()):splay_tree(nullptr, comp_, alloc){
+			if(basic_type::is_sorted_unique(data, data + Size)){
+				basic_type::build_from_sorted(data, data + Size);
+				return;
+			}
+			for(size_t Index=0;Index<Size;++Index){
+				insert(data[Index]);
+			}
+		}
+		splay_tree(splay_tree && tree) noexcept :basic_type(std::move(tree)) {}
+
+		[[nodiscard]] std::string to_string()const override {
+			return "<-Splay Tree->";
+		}
+
+		using basic_type::find;
+
+		// the node holding data is splayed to the root, if data is not here,
+		// the last node of the search path is (first, which is then the root).
+		std::pair<const_node_pointer,bool> find(const DataType& data){
+			node_pointer root = splay(data);
+			return std::make_pair(root, root && !basic_type::comp(data, root->data) && !basic_type::comp(root->data, data));
+		}
+
+		// see abstract_bs_tree::find(const Key&).
+		template<typename Key, typename C = Compare, typename = typename C::is_transparent>
+		std::pair<const_node_pointer,bool> find(const Key& key){
+			node_pointer root = splay(key);
+			return std::make_pair(root, root && !basic_type::comp(key, root->data) && !basic_type::comp(root->data, key));
+		}
+
+		// insert the data if find it, ignored!
+		// the second returns whether insert operation is successful.
+		// The new node becomes the root, taking the splayed neighbour as a child.
+		std::pair<const_node_pointer,bool> insert(const DataType& data){
+			return try_emplace(data, data);
+		}
+
+		std::pair<const_node_pointer,bool> insert(DataType&& data){
+			return try_emplace(data, std::move(data));
+		}
+
+		// see abstract_bs_tree::emplace, the new node becomes the root.
+		template<typename... Args>
+		std::pair<const_node_pointer,bool> emplace(Args&&... args){
+			node_pointer node = basic_type::allocate_node(std::in_place, std::forward<Args>(args)...);
+			node_pointer root = splay(node->data);
+			if(root && !basic_type::comp(node->data, root->data) && !basic_type::comp(root->data, node->data)){
+				basic_type::deallocate_node(node);
+				return std::make_pair(root, false);
+			}
+			link_root(root, node);
+			return std::make_pair(node, true);
+		}
+
+		// see abstract_bs_tree::try_emplace, the new node becomes the root.
+		template<typename Key, typename... Args>
+		std::pair<const_node_pointer,bool> try_emplace(const Key& key, Args&&... args){
+			node_pointer root = splay(key);
+			if(root && !basic_type::comp(key, root->data) && !basic_type::comp(root->data, key)){
+				return std::make_pair(root, false);
+			}
+			node_pointer node = basic_type::allocate_node(std::in_place, std::forward<Args>(args)...);
+			link_root(root, node);
+			return std::make_pair(node, true);
+		}
+
+		// see abstract_bs_tree::insert(node_handle_type&&), the node becomes the root.
+		std::pair<const_node_pointer,bool> insert(node_handle_type&& handle){
+			assert(!handle.empty() && "Empty node handle!");
+			assert(handle.get_allocator() == basic_type::get_allocator() && "Trees with unequal allocators can't share nodes");
+			node_pointer root = splay(handle.value());
+			if(root && !basic_type::comp(handle.value(), root->data) && !basic_type::comp(root->data, handle.value())){
+				return std::make_pair(root, false);
+			}
+			node_pointer node = handle.release();
+			link_root(root, node);
+			return std::make_pair(node, true);
+		}
+
+		// see abstract_bs_tree::extract, the node is splayed to the root and unlinked, no data moves.
+		node_handle_type extract(const_node_pointer node){
+			if(!node){
+				return node_handle_type();
+			}
+			splay(node->data);
+			assert(basic_type::_root == node);
+			node_pointer root = unlink_root();
+			basic_type::reset_node(root);
+			return node_handle_type(root, basic_type::_alloc);
+		}
+
+		// the left flag of abstract_bs_tree::erase is ignored: the erased node is splayed to the root and unlinked, no data moves
+		// between nodes. Returns the next node.
+		const_node_pointer erase(node_pointer node,bool = true) override {
+			if(!node){
+				return nullptr;
+			}
+			const_node_pointer Next = basic_type::increment(node);
+			splay(node->data);
+			assert(basic_type::_root == node);
+			erase_root();
+			return Next;
+		}
+
+		const_node_pointer erase(const_node_pointer node, bool left = true){
+			return erase(const_cast<node_pointer>(node), left);
+		}
+
+		void erase(const DataType& data,bool =true){
+			node_pointer root = splay(data);
+			if(root && !basic_type::comp(data, root->data) && !basic_type::comp(root->data, data)){
+				erase_root();
+			}
+		}
+	};
+
+}
+#endif
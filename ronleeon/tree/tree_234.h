@@ -1,3 +1,281 @@
-class tree_234{
+#ifndef RONLEEON_ADT_TREE_234_H
+#define RONLEEON_ADT_TREE_234_H
 
-};
\ No newline at end of file
+#include "ronleeon/tree/B_tree.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <tuple>
+#include <utility>
+namespace ronleeon::tree{
+
+    // One key of a 2-3-4 node, a position in a tree_234 is a pointer to it: it reads
+    // `slot->data` like the node of a binary sort tree, so tree_set and tree_map iterate over it.
+    template<typename DataType>
+    struct tree_234_slot{
+        DataType data;
+        tree_234_slot():data(){}
+        tree_234_slot(const DataType& Data):data(Data){}
+
+        friend std::ostream& operator<<(std::ostream& out, const tree_234_slot& Slot){
+            return out << Slot.data;
+        }
+    };
+
+    template<typename DataType, typename Compare>
+    struct tree_234_slot_less{
+        Compare comp;
+        bool operator()(const tree_234_slot<DataType>& lhs, const tree_234_slot<DataType>& rhs) const {
+            return comp(lhs.data, rhs.data);
+        }
+    };
+
+    // smallest power of two not less than value.
+    constexpr size_t tree_234_ceil2(size_t value){
+        size_t Ret = 1;
+        while(Ret < value){
+            Ret <<= 1;
+        }
+        return Ret;
+    }
+
+    // 2-3-4 tree: a B_tree_Cormen of minimum degree 2, every node holds 1 to 3 keys side by side
+    // and all leaves are on the same level, so it is at most log2(n + 1) deep and a lookup reads
+    // one short array per level instead of one node per key like rb_tree.
+    // Insertion splits full nodes on the way down and erasure fills minimal nodes on the way down,
+    // in a single descent each.
+    // Nodes are split_B_node aligned on the smallest power of two covering their 3 keys, which come
+    // first: the node holding a slot and the slot index are read from the slot address, slots then work
+    // as the node pointers tree_set and tree_map expect.
+    // Insert and erase move keys between nodes, they invalidate every position.
+    template<typename DataType, typename Compare = std::less<DataType>, typename Allocator = std::allocator<DataType>>
+    class tree_234{
+    public:
+        using node_type = tree_234_slot<DataType>;
+        using node_pointer = node_type*;
+        using const_node_pointer = const node_type*;
+        using allocator_type = Allocator;
+    private:
+        static constexpr size_t NodeAlign = std::max(tree_234_ceil2(3 * sizeof(node_type)), alignof(node_type));
+        using slot_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<node_type>;
+        using tree_node_type = node::split_B_node<node_type, 4, NodeAlign>;
+        using layout = node::B_node_layout<tree_node_type>;
+        using tree_type = B_tree_Cormen<node_type, 2, tree_234_slot_less<DataType, Compare>, tree_node_type
+            , B_node_print_trait<tree_node_type>, slot_allocator_type>;
+        using tree_node_pointer = const tree_node_type*;
+
+        tree_type tree;
+        Compare comp;
+        // the B tree counts nodes, not keys.
+        size_t _size = 0;
+
+        static tree_node_pointer node_of(const_node_pointer Slot){
+            auto Node = reinterpret_cast<tree_node_pointer>(reinterpret_cast<std::uintptr_t>(Slot) & ~(std::uintptr_t(NodeAlign) - 1));
+            assert(static_cast<size_t>(Slot - Node->data.data()) < Node->data_size && "Slot is not in a tree_234 node");
+            return Node;
+        }
+
+        static size_t slot_index(tree_node_pointer Node, const_node_pointer Slot){
+            return static_cast<size_t>(Slot - Node->data.data());
+        }
+
+        // position of Node among the children of its parent.
+        static size_t child_index(tree_node_pointer Parent, tree_node_pointer Node){
+            size_t Index = 0;
+            while(layout::child(Parent, Index) != Node){
+                ++Index;
+            }
+            return Index;
+        }
+
+        static const_node_pointer slot_at(tree_node_pointer Node, size_t Index){
+            return Node->data.data() + Index;
+        }
+
+        static const_node_pointer first_slot(tree_node_pointer Node){
+            if(!Node){
+                return nullptr;
+            }
+            while(!Node->is_leaf){
+                Node = layout::child(Node, 0);
+            }
+            return slot_at(Node, 0);
+        }
+
+        static const_node_pointer last_slot(tree_node_pointer Node){
+            if(!Node){
+                return nullptr;
+            }
+            while(!Node->is_leaf){
+                Node = layout::child(Node, Node->data_size);
+            }
+            return slot_at(Node, Node->data_size - 1);
+        }
+
+    public:
+        explicit tree_234(Compare comp_ = Compare{}, const Allocator& alloc = Allocator())
+            :tree(tree_234_slot_less<DataType, Compare>{comp_}, slot_allocator_type(alloc)), comp(comp_){}
+        tree_234(const tree_234&) = delete;
+        tree_234& operator=(const tree_234&) = delete;
+        tree_234(tree_234&& rhs) noexcept:tree(std::move(rhs.tree)), comp(std::move(rhs.comp)), _size(rhs._size){
+            rhs._size = 0;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return _size;
+        }
+
+        [[nodiscard]] bool is_empty() const {
+            return _size == 0;
+        }
+
+        allocator_type get_allocator() const {
+            return allocator_type(tree.get_allocator());
+        }
+
+        // number of levels, 0 for an empty tree.
+        [[nodiscard]] size_t get_height() const {
+            return tree.get_height();
+        }
+
+        const tree_type& get_tree() const {
+            return tree;
+        }
+
+        // the slot holding data and true, or null and false.
+        std::pair<const_node_pointer,bool> find(const DataType& data) const {
+            auto [Node, Index, Found] = tree.find(node_type(data));
+            if(!Found){
+                return {nullptr, false};
+            }
+            return {slot_at(Node, Index), true};
+        }
+
+        // insert the data if find it, ignored!
+        // the first is the slot holding data, the second returns whether insert operation is successful.
+        std::pair<const_node_pointer,bool> insert(const DataType& data){
+            auto [Node, Index, Inserted] = tree.insert(node_type(data));
+            if(Inserted){
+                ++_size;
+            }
+            return {slot_at(Node, Index), Inserted};
+        }
+
+        // The data of Slot was changed in place without changing its order, slots keep nothing about it.
+        void refresh_data(const_node_pointer){
+        }
+
+        // returns the slot holding the data following the erased one.
+        const_node_pointer erase(const_node_pointer Slot){
+            if(!Slot){
+                return nullptr;
+            }
+            // the erased key is copied, erasing moves keys through its slot.
+            node_type Key = *Slot;
+            const_node_pointer Next = increment(Slot);
+            --_size;
+            if(!Next){
+                tree.erase(Key);
+                return nullptr;
+            }
+            DataType NextData = Next->data;
+            tree.erase(Key);
+            return find(NextData).first;
+        }
+
+        void erase(const DataType& data){
+            if(tree.erase(node_type(data))){
+                --_size;
+            }
+        }
+
+        void destroy(){
+            tree.destroy();
+            _size = 0;
+        }
+
+        // whether [first, last) is strictly increasing, that is sorted without duplicates.
+        template<typename ForwardIt>
+        bool is_sorted_unique(ForwardIt first, ForwardIt last) const {
+            return std::adjacent_find(first, last, [this](const DataType& lhs, const DataType& rhs){
+                return !comp(lhs, rhs);
+            }) == last;
+        }
+
+        // Replace the content by the strictly increasing data of [first, last) in O(n), nodes are full.
+        template<typename ForwardIt>
+        void build_from_sorted(ForwardIt first, ForwardIt last){
+            tree.build_from_sorted(first, last);
+            _size = static_cast<size_t>(std::distance(first, last));
+        }
+
+        DataType min() const {
+            assert(_size && "Empty tree!");
+            return start()->data;
+        }
+
+        DataType max() const {
+            assert(_size && "Empty tree!");
+            return this->last()->data;
+        }
+
+        const_node_pointer start() const {
+            return first_slot(tree.get_root());
+        }
+
+        const_node_pointer last() const {
+            return last_slot(tree.get_root());
+        }
+
+        // Get the next slot in order: the first of the next subtree, the next key of a leaf or
+        // the key of the first ancestor reached from its left.
+        static const_node_pointer increment(const_node_pointer Slot){
+            if(!Slot){
+                return nullptr;
+            }
+            tree_node_pointer Node = node_of(Slot);
+            size_t Index = slot_index(Node, Slot);
+            if(!Node->is_leaf){
+                return first_slot(layout::child(Node, Index + 1));
+            }
+            if(Index + 1 < Node->data_size){
+                return Slot + 1;
+            }
+            for(tree_node_pointer Parent = Node->parent; Parent; Node = Parent, Parent = Node->parent){
+                size_t Child = child_index(Parent, Node);
+                if(Child < Parent->data_size){
+                    return slot_at(Parent, Child);
+                }
+            }
+            return nullptr;
+        }
+
+        // Get the pre slot in order.
+        static const_node_pointer decrement(const_node_pointer Slot){
+            if(!Slot){
+                return nullptr;
+            }
+            tree_node_pointer Node = node_of(Slot);
+            size_t Index = slot_index(Node, Slot);
+            if(!Node->is_leaf){
+                return last_slot(layout::child(Node, Index));
+            }
+            if(Index > 0){
+                return Slot - 1;
+            }
+            for(tree_node_pointer Parent = Node->parent; Parent; Node = Parent, Parent = Node->parent){
+                size_t Child = child_index(Parent, Node);
+                if(Child > 0){
+                    return slot_at(Parent, Child - 1);
+                }
+            }
+            return nullptr;
+        }
+    };
+
+}
+
+#endif //RONLEEON_ADT_TREE_234_H
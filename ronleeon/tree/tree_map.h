@@ -3,12 +3,16 @@
 #define RONLEEON_ADT_TREE_MAP_H
 
 #include "ronleeon/tree/rb_tree.h"
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <exception>
+#include <iterator>
+#include <limits>
 #include <type_traits>
 #include <utility>
 #include "ronleeon/tree/bs_tree.h"
+#include "ronleeon/tree/node_arena.h"
 
 
 namespace ronleeon{
@@ -31,6 +35,10 @@ namespace ronleeon{
 			pair() = default;
 			pair(Key&& k,Value&& v):first(std::move(k)),second(std::move(v)){
 			}
+			// the value built from args, in place(see tree_map::try_emplace).
+			template<typename K,typename... Args>
+			pair(std::in_place_t,K&& k,Args&&... args):first(std::forward<K>(k)),second(std::forward<Args>(args)...){
+			}
 			pair(pair&& pair):first(std::move(pair.first)),second(std::move(pair.second)){}
 
 			pair(const pair& pair):first(pair.first),second(pair.second){}
@@ -63,12 +71,26 @@ namespace ronleeon{
 			}
 		};
 
+		// Pairs are also ordered against a bare key, or anything keys are ordered against(like
+		// std::string_view for std::string), tree_map then searches by it without building a pair.
 		template<typename Key,typename Value>
 		struct less<pair<Key,Value>>
 		{
+			using is_transparent = void;
+
 			bool
 			operator()(const pair<Key,Value>& x, const pair<Key,Value>& y) const
 			{ return x.first < y.first; }
+
+			template<typename K>
+			bool
+			operator()(const pair<Key,Value>& x, const K& k) const
+			{ return x.first < k; }
+
+			template<typename K>
+			bool
+			operator()(const K& k, const pair<Key,Value>& y) const
+			{ return k < y.first; }
 		};
 		
 		
@@ -157,6 +179,21 @@ namespace ronleeon{
 		public:
 			typedef tree_map_iterator<typename Tree::node_type,NodeValue,tree_map> iterator;
 			typedef iterator const_iterator;
+			// nodes are allocated by the underlying tree, pick the allocator through Tree.
+			using allocator_type = typename Tree::allocator_type;
+			// an element taken out with its node by extract, see node_handle.
+			using node_type = typename node_handle_of<Tree>::type;
+			// result of insert(node_type&&): the element with the key of the node, whether the node
+			// was linked and, if not, the node given back.
+			struct insert_return_type{
+				iterator position;
+				bool inserted;
+				node_type node;
+			};
+			// Augmented nodes keep the aggregate of their subtree values, which only insert_or_assign and
+			// upsert refresh: operator[] and at() give their values read-only.
+			using value_reference = std::conditional_t<node::node_bookkeeping<typename Tree::node_type>::has_aggregate
+				, const Value&, Value&>;
 		private:
 
 
@@ -168,19 +205,182 @@ namespace ronleeon{
 			typename Tree::const_node_pointer this_end;
 
 			Tree tree;
+
+			// the node last reached by find_near or insert_near, where they start, null if it may be gone.
+			typename Tree::const_node_pointer finger = nullptr;
+
+			// whether Tree searches by a K alone, see abstract_bs_tree::find(const Key&).
+			template<typename K, typename = void>
+			struct finds_by_key:std::false_type{};
+
+			template<typename K>
+			struct finds_by_key<K, std::void_t<decltype(std::declval<const Tree&>().find(std::declval<const K&>()))>>:std::true_type{};
+
+			// the node holding key k in t, the pair searched for is only built if Tree can't search by key.
+			// Through a non-const map, a self-adjusting tree(splay_tree) adapts to the lookup.
+			template<typename TreeRef, typename K>
+			static std::pair<typename Tree::const_node_pointer,bool> find_node(TreeRef& t, const K& k){
+				if constexpr(finds_by_key<K>::value){
+					return t.find(k);
+				}else{
+					return t.find(NodeValue(k,Value()));// construct an empty Value
+				}
+			}
+
+			// whether Tree constructs its data from Args in the node, see abstract_bs_tree::emplace.
+			template<typename... Args>
+			struct emplaces_impl{
+				template<typename T, typename = decltype(std::declval<T&>().emplace(std::declval<Args>()...))>
+				static std::true_type test(int);
+				template<typename T>
+				static std::false_type test(...);
+			};
+
+			template<typename... Args>
+			using emplaces = decltype(emplaces_impl<Args...>::template test<Tree>(0));
+
+			// an emplace result of the tree, bounds updated.
+			std::pair<iterator, bool> inserted(std::pair<typename Tree::const_node_pointer,bool> InsertResult){
+				if(InsertResult.second){
+					start = tree.start();
+					last = tree.last();
+				}
+				return std::make_pair(iterator(InsertResult.first, *this), InsertResult.second);
+			}
+
+			template<typename K, typename... Args>
+			std::pair<iterator, bool> try_emplace_key(const Key& k, K&& key, Args&&... args){
+				if constexpr(finds_by_key<Key>::value){
+					// key is only moved once k is known to be missing.
+					return inserted(tree.try_emplace(k, std::in_place, std::forward<K>(key), std::forward<Args>(args)...));
+				}else{
+					if(const auto Find=find_node(tree, k); Find.second){
+						return std::make_pair(iterator(Find.first, *this), false);
+					}
+					return inserted(tree.insert(NodeValue(std::in_place, std::forward<K>(key), std::forward<Args>(args)...)));
+				}
+			}
+
+			// the map owns its nodes, values are mutable.
+			static Value& value_at(typename Tree::const_node_pointer node){
+				return const_cast<typename Tree::node_type*>(node)->data.second;
+			}
+
+			template<typename K>
+			Value& value_of(const K& k){
+				const auto Find=find_node(tree, k);
+				if(Find.second){
+					return value_at(Find.first);
+				}
+				throw "Invalid Key";
+			}
+
+			// fn(Value&) changes the value of node in place, the tree then refreshes what its nodes
+			// keep about their subtree values(see augmented_tree_map).
+			template<typename Fn>
+			void update_value(typename Tree::const_node_pointer node, Fn&& fn){
+				fn(value_at(node));
+				tree.refresh_data(node);
+			}
+
+			template<typename K, typename V>
+			iterator assign_key(K&& k, V&& v){
+				// v is only taken by try_emplace if k is inserted.
+				auto InsertResult=try_emplace(std::forward<K>(k), std::forward<V>(v));
+				if(!InsertResult.second){
+					update_value(InsertResult.first.get_node_ptr(), [&v](Value& Old){ Old=std::forward<V>(v); });
+				}
+				return InsertResult.first;
+			}
+
+			template<typename Self, typename K>
+			static const_iterator find_key(Self& self, const K& k){
+				const auto Find=find_node(self.tree, k);
+				if(Find.second){
+					return const_iterator(Find.first, self);
+				}
+				return self.end();
+			}
+
+			template<typename K>
+			void erase_key(const K& k){
+				const auto Find=find_node(tree, k);
+				if(Find.second){
+					tree.erase(Find.first);
+					reset_bounds();
+				}
+			}
+
+			// whether Tree searches from a node of its own, see abstract_bs_tree::find_from. Insertion may
+			// move data between the nodes of other trees(tree_234), they always search from the root.
+			template<typename K, typename = void>
+			struct finds_from:std::false_type{};
+
+			template<typename K>
+			struct finds_from<K, std::void_t<decltype(std::declval<const Tree&>().find_from(
+				std::declval<typename Tree::const_node_pointer>(), std::declval<const K&>()))>>:std::true_type{};
+
+			// the node a search hinted by hint starts from, end() stands for the last node.
+			typename Tree::const_node_pointer node_of(const_iterator hint) const {
+				auto node = hint.get_node_ptr();
+				if(node == this_end){
+					return size() ? last : nullptr;
+				}
+				return node;
+			}
+
+			template<typename K>
+			std::pair<typename Tree::const_node_pointer,bool> find_node_from(typename Tree::const_node_pointer from, const K& k) const {
+				if constexpr(finds_from<K>::value){
+					return tree.find_from(from, k);
+				}else{
+					return find_node(tree, k);
+				}
+			}
+
+			// insert x searching from node from, the element of its key is returned either way.
+			template<typename X>
+			iterator insert_from(typename Tree::const_node_pointer from, X&& x){
+				if constexpr(finds_from<NodeValue>::value){
+					return inserted(tree.try_emplace_from(from, x, std::forward<X>(x))).first;
+				}else{
+					if(const auto Find=find_node(tree, x.first); Find.second){
+						return iterator(Find.first, *this);
+					}
+					return inserted(tree.insert(std::forward<X>(x))).first;
+				}
+			}
+
+			// first and last node after the tree changed.
+			void reset_bounds(){
+				finger = nullptr;
+				start = tree.start();
+				last = tree.last();
+				if(!start){
+					start = last = this_end;
+				}
+			}
 		public:
-			tree_map(Compare comp_ = Compare{} ):tree(comp_),last(reinterpret_cast<typename Tree::const_node_pointer>(this)), start(reinterpret_cast<typename Tree::const_node_pointer>(this)),this_end(reinterpret_cast<typename Tree::const_node_pointer>(this)){}
+			tree_map(Compare comp_ = Compare{}, const allocator_type& alloc = allocator_type() ):tree(comp_, alloc),last(reinterpret_cast<typename Tree::const_node_pointer>(this)), start(reinterpret_cast<typename Tree::const_node_pointer>(this)),this_end(reinterpret_cast<typename Tree::const_node_pointer>(this)){}
 
 			tree_map(const tree_map&) = delete;
 
 			tree_map(tree_map&&) = delete;
 
-			tree_map(std::initializer_list<NodeValue> l,Compare comp_ = Compare{} )
-			: tree_map(comp_)
+			tree_map(std::initializer_list<NodeValue> l,Compare comp_ = Compare{}, const allocator_type& alloc = allocator_type() )
+			: tree_map(comp_, alloc)
 			{ 
 				insert(l); 
 			}
 
+			// [first, last) must be sorted by key and unique, the tree is built in O(n).
+			template<typename ForwardIterator>
+			tree_map(sorted_unique_t, ForwardIterator first, ForwardIterator last,Compare comp_ = Compare{}, const allocator_type& alloc = allocator_type() )
+			: tree_map(comp_, alloc)
+			{
+				insert(sorted_unique, first, last);
+			}
+
 
 			~tree_map() = default;
 
@@ -192,6 +392,10 @@ namespace ronleeon{
 				return tree.size();
 			}
 
+			allocator_type get_allocator() const {
+				return tree.get_allocator();
+			}
+
 			typename Tree::const_node_pointer tree_map_increment(typename Tree::const_node_pointer value) const {
 				if(value == this_end){
 					return start;
@@ -215,45 +419,66 @@ namespace ronleeon{
 				return Pre;
 			}
 
-			Value&
+			// The value of k, a value initialized one is inserted if k is missing, in a single descent.
+			value_reference
 			operator[](const Key& k){
-				const auto Find=tree.find(NodeValue(k,Value()));// construct an empty Value
-				if(Find.second){
-					return Find.first->data.second;
-				}
-				throw "Invalid Key";
+				return value_at(try_emplace(k).first.get_node_ptr());
+			}
+
+			value_reference
+			operator[](Key&& k){
+				return value_at(try_emplace(std::move(k)).first.get_node_ptr());
+			}
+
+			value_reference at(const Key& k){
+				return value_of(k);
+			}
+
+			// see find(const K&).
+			template<typename K, typename C = Compare, typename = typename C::is_transparent>
+			value_reference at(const K& k){
+				return value_of(k);
 			}
 
-			Value&
-			operator[](Key&& k)
+			std::pair<iterator, bool> insert(NodeValue&& x)
 			{
-				const auto Find=tree.find(NodeValue(k,Value()));
-				if(Find.second){
-					return Find.first->data.second;
+				if(auto InsertResult=tree.insert(std::move(x)); InsertResult.second){
+					start = tree.start();
+					last = tree.last();
+					return std::make_pair(iterator(InsertResult.first, *this), true);
+				}else{
+					return std::make_pair(end(), false);
 				}
-				throw "Invalid Key";
 			}
 
-			Value& at(const Key& k){
-				const auto Find=tree.find(NodeValue(k,Value()));
-				if(Find.second){
-					return Find.first->data.second;
+			// The pair is constructed from args directly in its node, unlike insert a pair already
+			// here is returned(like std::map::emplace). Backends without emplace(tree_234) get a built pair.
+			template<typename... Args>
+			std::pair<iterator, bool> emplace(Args&&... args)
+			{
+				if constexpr(emplaces<Args...>::value){
+					return inserted(tree.emplace(std::forward<Args>(args)...));
+				}else{
+					return inserted(tree.insert(NodeValue(std::forward<Args>(args)...)));
 				}
-				throw "Invalid Key";
 			}
 
-			Value& at(Key&& k)
+			// Nothing is built if k is here, otherwise the key and the value constructed from args
+			// go directly in a new node, so Value can be move only(like std::map::try_emplace).
+			template<typename... Args>
+			std::pair<iterator, bool> try_emplace(const Key& k, Args&&... args)
 			{
-				const auto Find=tree.find(NodeValue(k,Value()));
-				if(Find.second){
-					return Find.first->data.second;
-				}
-				throw "Invalid Key";
+				return try_emplace_key(k, k, std::forward<Args>(args)...);
+			}
+
+			template<typename... Args>
+			std::pair<iterator, bool> try_emplace(Key&& k, Args&&... args)
+			{
+				return try_emplace_key(k, std::move(k), std::forward<Args>(args)...);
 			}
 
 			std::pair<iterator, bool> insert(const NodeValue& x)
 			{ 
-				std::pair<iterator,bool> Ret;
 				if(auto InsertResult=tree.insert(x); InsertResult.second){
 					start = tree.start();
 					last = tree.last();
@@ -280,79 +505,299 @@ namespace ronleeon{
 				insert(list.begin(), list.end()); 
 			}
 
+			// an empty container is built from a sorted range in O(n), see insert(sorted_unique_t, first, last).
 			template<typename InputIterator>
 			void insert(InputIterator first, InputIterator last)
-			{ 
+			{
+				if constexpr(std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>){
+					if(size() == 0 && tree.is_sorted_unique(first, last)){
+						insert(sorted_unique, first, last);
+						return;
+					}
+				}
 				for(auto &It=first;It!=last;++It){
 					insert(*It);
-				}	
+				}
 			}
 
-			iterator insert_or_assign(const Key& k, const Value& v){
-				if(auto InsertResult=tree.insert(NodeValue(k,v)); InsertResult.second){
-					start = tree.start();
-					last = tree.last();
-					return iterator(InsertResult.first, *this);
-				}else{
-					// HACK: insert before delete
-					erase(k);
-					InsertResult = tree.insert(NodeValue(k,v));
-					start = tree.start();
-					last = tree.last();
-					return iterator(InsertResult.first, *this);
+			// [first, last) is sorted and unique, an empty container is then built in O(n)
+			// with a perfectly balanced tree, otherwise every data is inserted.
+			template<typename ForwardIterator>
+			void insert(sorted_unique_t, ForwardIterator first, ForwardIterator last)
+			{
+				if(size() != 0){
+					for(auto &It=first;It!=last;++It){
+						insert(*It);
+					}
+					return;
+				}
+				tree.build_from_sorted(first, last);
+				finger = nullptr;
+				// `last` is the parameter here.
+				this->start = tree.start();
+				this->last = tree.last();
+				if(!this->start){
+					this->start = this->last = this_end;
 				}
 			}
 
+			// Insert k with v, or assign v to the value of k if it is here, in a single descent:
+			// the node of k stays in place, only its value changes.
+			iterator insert_or_assign(const Key& k, const Value& v){
+				return assign_key(k, v);
+			}
+
+			iterator insert_or_assign(const Key& k, Value&& v){
+				return assign_key(k, std::move(v));
+			}
+
+			iterator insert_or_assign(Key&& k, const Value& v){
+				return assign_key(std::move(k), v);
+			}
+
+			iterator insert_or_assign(Key&& k, Value&& v){
+				return assign_key(std::move(k), std::move(v));
+			}
+
+			// Apply fn(Value&) to the value of k in place, a value initialized one is inserted first if
+			// k is missing, in a single descent. e.g. counting: upsert(k, [](int& Count){ ++Count; }).
+			template<typename Fn>
+			iterator upsert(const Key& k, Fn fn){
+				auto Position=try_emplace(k).first;
+				update_value(Position.get_node_ptr(), fn);
+				return Position;
+			}
+
+			template<typename Fn>
+			iterator upsert(Key&& k, Fn fn){
+				auto Position=try_emplace(std::move(k)).first;
+				update_value(Position.get_node_ptr(), fn);
+				return Position;
+			}
+
 			iterator erase(iterator position)
 			{ 
-				auto Node = position.get_node();
-				auto EraseResult=tree.erase(Node);
-				if(EraseResult){
+				auto EraseResult=tree.erase(position.get_node_ptr());
+				reset_bounds();
+				if(!EraseResult){
 					return end();
-				}else{
-					start = tree.start();
-					last = tree.last();
-					if(!start){
-						start = this_end;
-					}
-					if(!last){
-						last = this_end;
-					}
-					return iterator(EraseResult, *this);
 				}
+				return iterator(EraseResult, *this);
 			}
 			
 
 			void erase(const Key& x)
 			{
-				tree.erase(NodeValue(x,Value()));
+				erase_key(x);
+			}
+
+			// see find(const K&).
+			template<typename K, typename C = Compare, typename = typename C::is_transparent
+				, typename = std::enable_if_t<!std::is_convertible_v<const K&, iterator>>>
+			void erase(const K& x)
+			{
+				erase_key(x);
 			}
 
 
 			void clear() { 
 				tree.destroy();
+				finger = nullptr;
 				start = last = this_end;
 			}
 
+			// Unlink the element at position and hand it over with its node, nothing is released.
+			// Only iterators to it are invalidated, the element keeps its node.
+			node_type extract(const_iterator position)
+			{
+				auto Handle=tree.extract(position.get_node_ptr());
+				reset_bounds();
+				return Handle;
+			}
+
+			// empty if k is not here.
+			node_type extract(const Key& k)
+			{
+				const auto Find=find_node(tree, k);
+				if(!Find.second){
+					return node_type();
+				}
+				return extract(const_iterator(Find.first, *this));
+			}
+
+			// Link the node of an element extracted from a map of this type(with an equal allocator),
+			// no allocation: if its key is already here, the node is given back.
+			insert_return_type insert(node_type&& handle)
+			{
+				if(handle.empty()){
+					return {end(), false, node_type()};
+				}
+				auto InsertResult=tree.insert(std::move(handle));
+				if(InsertResult.second){
+					start = tree.start();
+					last = tree.last();
+				}
+				return {iterator(InsertResult.first, *this), InsertResult.second, std::move(handle)};
+			}
+
+			// Move the elements of other whose key is not here into this map by relinking their nodes,
+			// without any allocation, other keeps the rest. other is walked in order and every key
+			// is searched from the previous one(see abstract_bs_tree::find_from).
+			void merge(tree_map& other)
+			{
+				if(&other == this){
+					return;
+				}
+				typename Tree::const_node_pointer From = nullptr;
+				for(auto node = other.tree.start(); node;){
+					// extracting node moves no data into the nodes after it.
+					auto Next = Tree::increment(node);
+					const auto Find = tree.find_from(From, node->data);
+					From = Find.first;
+					if(!Find.second){
+						From = tree.insert_from(From, other.tree.extract(node)).first;
+					}
+					node = Next;
+				}
+				other.reset_bounds();
+				reset_bounds();
+			}
+
 
 
 			const_iterator find(const Key& x)
-			{ 
-				auto FindResult= tree.find(NodeValue(x,Value())); 
-				if(FindResult.second){
-					return iterator(FindResult.first, *this);
-				}else{
-					return end();
+			{
+				return find_key(*this, x);
+			}
+
+			const_iterator find(const Key& x) const
+			{
+				return find_key(*this, x);
+			}
+
+			// With a transparent Compare(tree::less of pairs is one), keys are searched by any K they
+			// are ordered against, without building a Key or a Value:
+			// find(std::string_view) on a tree_map<std::string, Value>.
+			template<typename K, typename C = Compare, typename = typename C::is_transparent>
+			const_iterator find(const K& x)
+			{
+				return find_key(*this, x);
+			}
+
+			template<typename K, typename C = Compare, typename = typename C::is_transparent>
+			const_iterator find(const K& x) const
+			{
+				return find_key(*this, x);
+			}
+
+			// Search from hint instead of the root(see abstract_bs_tree::find_from): a hint at or next
+			// to the element, e.g. the previous one found, makes it amortized O(1).
+			const_iterator find(const_iterator hint, const Key& x) const
+			{
+				const auto Find=find_node_from(node_of(hint), x);
+				return Find.second ? const_iterator(Find.first, *this) : end();
+			}
+
+			// Insert x searching from hint, the element with the key of x is returned, inserted or not
+			// (like std::map). end() or a hint next to the position of x, as for nearly sorted keys,
+			// makes it amortized O(1) plus the rebalancing.
+			iterator insert(const_iterator hint, const NodeValue& x)
+			{
+				return insert_from(node_of(hint), x);
+			}
+
+			iterator insert(const_iterator hint, NodeValue&& x)
+			{
+				return insert_from(node_of(hint), std::move(x));
+			}
+
+			// find and insert hinted by the last element they reached(the root at first, or after
+			// an erase), for keys accessed nearly in order without keeping an iterator.
+			const_iterator find_near(const Key& x)
+			{
+				const auto Find=find_node_from(finger, x);
+				if constexpr(finds_from<Key>::value){
+					finger = Find.first;
 				}
-			} 
+				return Find.second ? const_iterator(Find.first, *this) : end();
+			}
 
+			iterator insert_near(const NodeValue& x)
+			{
+				auto Position=insert_from(finger, x);
+				if constexpr(finds_from<NodeValue>::value){
+					finger = Position.get_node_ptr();
+				}
+				return Position;
+			}
+
+			iterator insert_near(NodeValue&& x)
+			{
+				auto Position=insert_from(finger, std::move(x));
+				if constexpr(finds_from<NodeValue>::value){
+					finger = Position.get_node_ptr();
+				}
+				return Position;
+			}
 
 			int count(const Key& x) const
-			{ return find(x) == end() ? 0 : 1; }
+			{ return find_node(tree, x).second ? 1 : 0; }
+
+			template<typename K, typename C = Compare, typename = typename C::is_transparent>
+			int count(const K& x) const
+			{ return find_node(tree, x).second ? 1 : 0; }
 
 			bool contains(const Key& x) const
-			{ return find(x) != end(); }
+			{ return find_node(tree, x).second; }
 
+			template<typename K, typename C = Compare, typename = typename C::is_transparent>
+			bool contains(const K& x) const
+			{ return find_node(tree, x).second; }
+
+
+			// Order statistics, O(log n) when the nodes keep their subtree size(see order_statistic_tree_map).
+
+			// the pair of the k-th smallest key(counting from 0), end() if k >= size().
+			iterator select(size_t k)
+			{
+				auto node = tree.select(k);
+				return node ? iterator(node, *this) : end();
+			}
+
+			// number of keys less than k.
+			size_t rank(const Key& k) const
+			{
+				if constexpr(finds_by_key<Key>::value){
+					return tree.rank(k);
+				}else{
+					return tree.rank(NodeValue(k,Value()));
+				}
+			}
+
+			// number of keys in [lo, hi).
+			size_t count_range(const Key& lo, const Key& hi) const
+			{
+				size_t Low = rank(lo), High = rank(hi);
+				return Low < High ? High - Low : 0;
+			}
+
+			// Monoid aggregate of the pairs whose key is in [lo, hi), in O(log n) with augmented nodes(see augmented_tree_map).
+			auto aggregate(const Key& lo, const Key& hi) const
+			{
+				if constexpr(finds_by_key<Key>::value){
+					return tree.aggregate(lo, hi);
+				}else{
+					return tree.aggregate(NodeValue(lo,Value()), NodeValue(hi,Value()));
+				}
+			}
+
+			// aggregate of the whole map, in O(1).
+			auto aggregate() const
+			{ return tree.aggregate(); }
+
+			// position of position in the map, std::distance(begin(), position) without walking.
+			size_t index_of(const_iterator position) const
+			{ return position == end() ? size() : Tree::index_of(position.get_node_ptr()); }
 
 		iterator begin(){
 			return iterator(start, *this);
@@ -362,14 +807,14 @@ namespace ronleeon{
 		}
 
 		const_iterator begin() const {
-			return const_iterator(start);
+			return const_iterator(start, *this);
 		}
 		const_iterator end() const {
 			return const_iterator(this_end, *this);
 		}
 
 		const_iterator cbegin() const {
-			return const_iterator(start);
+			return const_iterator(start, *this);
 		}
 		const_iterator cend() const {
 			return const_iterator(this_end, *this);
@@ -400,6 +845,55 @@ namespace ronleeon{
 
 		};
 
+		// tree_map whose nodes are carved from its own node_arena,
+		// clear() and destruction drop whole slabs instead of freeing node by node.
+		template <typename Key,typename Value,typename Compare=tree::less<tree::pair<Key,Value>>>
+		using arena_tree_map = tree_map<Key,Value,Compare,rb_tree<tree::pair<Key,Value>,Compare
+			,node::rb_node<tree::pair<Key,Value>>,rb_node_print_trait<node::rb_node<tree::pair<Key,Value>>>
+			,arena_allocator<tree::pair<Key,Value>>>>;
+
+		// tree_map whose nodes count their subtree, select/rank/count_range/index_of take O(log n).
+		template <typename Key,typename Value,typename Compare=tree::less<tree::pair<Key,Value>>>
+		using order_statistic_tree_map = tree_map<Key,Value,Compare,rb_tree<tree::pair<Key,Value>,Compare
+			,node::sized_rb_node<tree::pair<Key,Value>>,rb_node_print_trait<node::sized_rb_node<tree::pair<Key,Value>>>>>;
+
+		// Monoids over the values of a tree_map, for augmented_tree_map.
+		template<typename Key,typename Value>
+		struct value_sum{
+			using value_type = Value;
+			static Value identity(){ return Value(); }
+			static Value lift(const tree::pair<Key,Value>& Pair){ return Pair.second; }
+			static Value combine(const Value& lhs, const Value& rhs){ return lhs + rhs; }
+		};
+
+		template<typename Key,typename Value>
+		struct value_min{
+			using value_type = Value;
+			static Value identity(){ return std::numeric_limits<Value>::max(); }
+			static Value lift(const tree::pair<Key,Value>& Pair){ return Pair.second; }
+			static Value combine(const Value& lhs, const Value& rhs){ return std::min(lhs, rhs); }
+		};
+
+		template<typename Key,typename Value>
+		struct value_max{
+			using value_type = Value;
+			static Value identity(){ return std::numeric_limits<Value>::lowest(); }
+			static Value lift(const tree::pair<Key,Value>& Pair){ return Pair.second; }
+			static Value combine(const Value& lhs, const Value& rhs){ return std::max(lhs, rhs); }
+		};
+
+		// tree_map whose nodes keep the Monoid aggregate of their subtree, aggregate(lo, hi) takes O(log n).
+		// Values are changed through insert_or_assign or upsert, operator[] and at() only read them.
+		template <typename Key,typename Value,typename Monoid,typename Compare=tree::less<tree::pair<Key,Value>>>
+		using augmented_tree_map = tree_map<Key,Value,Compare,rb_tree<tree::pair<Key,Value>,Compare
+			,node::augmented_rb_node<tree::pair<Key,Value>,Monoid>,rb_node_print_trait<node::augmented_rb_node<tree::pair<Key,Value>,Monoid>>>>;
+
+		// tree_map whose nodes live in the shared node_pool of their type, linked by 32-bit indices.
+		template <typename Key,typename Value,typename Compare=tree::less<tree::pair<Key,Value>>>
+		using indexed_tree_map = tree_map<Key,Value,Compare,rb_tree<tree::pair<Key,Value>,Compare
+			,node::indexed_rb_node<tree::pair<Key,Value>>,rb_node_print_trait<node::indexed_rb_node<tree::pair<Key,Value>>>
+			,index_pool_allocator<tree::pair<Key,Value>>>>;
+
 	}
 }
 
@@ -3,9 +3,11 @@
 #define RONLEEON_ADT_TREE_SET_H
 
 #include "ronleeon/tree/rb_tree.h"
+#include "ronleeon/tree/node_arena.h"
 #include <functional>
 #include <exception>
 #include <iterator>
+#include <type_traits>
 #include <utility>
 
 namespace ronleeon::tree{
@@ -90,6 +92,17 @@ namespace ronleeon::tree{
 	public:
 		typedef tree_set_iterator<typename Tree::node_type,NodeValue,tree_set> iterator;
 		typedef iterator const_iterator;
+		// nodes are allocated by the underlying tree, pick the allocator through Tree.
+		using allocator_type = typename Tree::allocator_type;
+		// a data taken out with its node by extract, see node_handle.
+		using node_type = typename node_handle_of<Tree>::type;
+		// result of insert(node_type&&): the element equal to the data of the node, whether the
+		// node was linked and, if not, the node given back.
+		struct insert_return_type{
+			iterator position;
+			bool inserted;
+			node_type node;
+		};
 	private:
 		Tree tree;
 
@@ -102,19 +115,99 @@ namespace ronleeon::tree{
 		// use in end iterator, implement as `this` ptr.
 		typename Tree::const_node_pointer this_end;
 
+		// the node last reached by find_near or insert_near, where they start, null if it may be gone.
+		typename Tree::const_node_pointer finger = nullptr;
+
+		// whether Tree constructs its data from Args in the node, see abstract_bs_tree::emplace.
+		template<typename... Args>
+		struct emplaces_impl{
+			template<typename T, typename = decltype(std::declval<T&>().emplace(std::declval<Args>()...))>
+			static std::true_type test(int);
+			template<typename T>
+			static std::false_type test(...);
+		};
+
+		template<typename... Args>
+		using emplaces = decltype(emplaces_impl<Args...>::template test<Tree>(0));
+
+		// whether Tree searches from a node of its own, see abstract_bs_tree::find_from. Insertion may
+		// move data between the nodes of other trees(tree_234), they always search from the root.
+		template<typename T, typename = void>
+		struct finds_from_impl:std::false_type{};
+
+		template<typename T>
+		struct finds_from_impl<T, std::void_t<decltype(std::declval<const T&>().find_from(
+			std::declval<typename T::const_node_pointer>(), std::declval<const NodeValue&>()))>>:std::true_type{};
+
+		static constexpr bool finds_from = finds_from_impl<Tree>::value;
+
+		// the node a search hinted by hint starts from, end() stands for the last node.
+		typename Tree::const_node_pointer node_of(const_iterator hint) const {
+			auto node = hint.get_node_ptr();
+			if(node == this_end){
+				return size() ? last : nullptr;
+			}
+			return node;
+		}
+
+		std::pair<typename Tree::const_node_pointer,bool> find_node_from(typename Tree::const_node_pointer from, const NodeValue& x) const {
+			if constexpr(finds_from){
+				return tree.find_from(from, x);
+			}else{
+				return tree.find(x);
+			}
+		}
+
+		// insert x searching from node from, the element equal to x is returned either way.
+		template<typename X>
+		iterator insert_from(typename Tree::const_node_pointer from, X&& x){
+			std::pair<typename Tree::const_node_pointer,bool> InsertResult;
+			if constexpr(finds_from){
+				InsertResult=tree.try_emplace_from(from, x, std::forward<X>(x));
+			}else{
+				if(const auto Find=tree.find(x); Find.second){
+					return iterator(Find.first, *this);
+				}
+				InsertResult=tree.insert(std::forward<X>(x));
+			}
+			if(InsertResult.second){
+				start = tree.start();
+				last = tree.last();
+			}
+			return iterator(InsertResult.first, *this);
+		}
+
+		// first and last node after the tree changed as a whole.
+		void reset_bounds(){
+			finger = nullptr;
+			start = tree.start();
+			last = tree.last();
+			if(!start){
+				start = last = this_end;
+			}
+		}
+
 	public:
-		tree_set(Compare comp_ = Compare{} ):tree(comp_), last(reinterpret_cast<typename Tree::const_node_pointer>(this)), start(reinterpret_cast<typename Tree::const_node_pointer>(this)),this_end(reinterpret_cast<typename Tree::const_node_pointer>(this)){}
+		tree_set(Compare comp_ = Compare{}, const allocator_type& alloc = allocator_type() ):tree(comp_, alloc), last(reinterpret_cast<typename Tree::const_node_pointer>(this)), start(reinterpret_cast<typename Tree::const_node_pointer>(this)),this_end(reinterpret_cast<typename Tree::const_node_pointer>(this)){}
 
 		tree_set(const tree_set&) = delete;
 
 		tree_set(tree_set&&) = delete;
 
-		tree_set(std::initializer_list<NodeValue> l,Compare comp_ = Compare{})
-		: tree_set(comp_)
+		tree_set(std::initializer_list<NodeValue> l,Compare comp_ = Compare{}, const allocator_type& alloc = allocator_type())
+		: tree_set(comp_, alloc)
 		{
 			insert(l);
 		}
 
+		// [first, last) must be sorted and unique, the tree is built in O(n).
+		template<typename ForwardIterator>
+		tree_set(sorted_unique_t, ForwardIterator first, ForwardIterator last,Compare comp_ = Compare{}, const allocator_type& alloc = allocator_type())
+		: tree_set(comp_, alloc)
+		{
+			insert(sorted_unique, first, last);
+		}
+
 
 		~tree_set() = default;
 
@@ -126,6 +219,10 @@ namespace ronleeon::tree{
 			return tree.size();
 		}
 
+		allocator_type get_allocator() const {
+			return tree.get_allocator();
+		}
+
 		typename Tree::const_node_pointer tree_set_increment(typename Tree::const_node_pointer value) const {
 			if(value == this_end){
 				return start;
@@ -150,6 +247,37 @@ namespace ronleeon::tree{
 		}
 
 
+		std::pair<iterator, bool> insert(NodeValue&& x)
+		{
+			auto InsertResult=tree.insert(std::move(x));
+			if(InsertResult.second){
+				start = tree.start();
+				last = tree.last();
+				return std::make_pair<iterator, bool>(iterator(InsertResult.first, *this), true);
+			}else{
+				// end iterator
+				return std::make_pair<iterator, bool>(end(),false);
+			}
+		}
+
+		// The data is constructed from args directly in its node, unlike insert an equal data
+		// already here is returned(like std::set::emplace). Backends without emplace(tree_234) get a built data.
+		template<typename... Args>
+		std::pair<iterator, bool> emplace(Args&&... args)
+		{
+			std::pair<typename Tree::const_node_pointer,bool> InsertResult;
+			if constexpr(emplaces<Args...>::value){
+				InsertResult=tree.emplace(std::forward<Args>(args)...);
+			}else{
+				InsertResult=tree.insert(NodeValue(std::forward<Args>(args)...));
+			}
+			if(InsertResult.second){
+				start = tree.start();
+				last = tree.last();
+			}
+			return std::make_pair(iterator(InsertResult.first, *this), InsertResult.second);
+		}
+
 		std::pair<iterator, bool> insert(const NodeValue& x)
 		{
 			auto InsertResult=tree.insert(x);
@@ -168,45 +296,144 @@ namespace ronleeon::tree{
 			insert(list.begin(), list.end());
 		}
 
+		// an empty container is built from a sorted range in O(n), see insert(sorted_unique_t, first, last).
 		template<typename InputIterator>
 		void insert(InputIterator first, InputIterator last)
 		{
+			if constexpr(std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>){
+				if(size() == 0 && tree.is_sorted_unique(first, last)){
+					insert(sorted_unique, first, last);
+					return;
+				}
+			}
 			for(auto &It=first;It!=last;++It){
 				insert(*It);
 			}
 		}
 
+		// [first, last) is sorted and unique, an empty container is then built in O(n)
+		// with a perfectly balanced tree, otherwise every data is inserted.
+		template<typename ForwardIterator>
+		void insert(sorted_unique_t, ForwardIterator first, ForwardIterator last)
+		{
+			if(size() != 0){
+				for(auto &It=first;It!=last;++It){
+					insert(*It);
+				}
+				return;
+			}
+			tree.build_from_sorted(first, last);
+			finger = nullptr;
+			// `last` is the parameter here.
+			this->start = tree.start();
+			this->last = tree.last();
+			if(!this->start){
+				this->start = this->last = this_end;
+			}
+		}
+
+
+		// Set algebra on the underlying trees(avl_tree or rb_tree), in O(m log(n/m + 1)) work
+		// and in parallel for big sets. Nodes move between the sets, other is left empty.
+		void union_with(tree_set& other){
+			tree.union_with(other.tree);
+			other.reset_bounds();
+			reset_bounds();
+		}
+
+		void intersect_with(tree_set& other){
+			tree.intersect_with(other.tree);
+			other.reset_bounds();
+			reset_bounds();
+		}
+
+		void difference_with(tree_set& other){
+			tree.difference_with(other.tree);
+			other.reset_bounds();
+			reset_bounds();
+		}
 
 		iterator erase(iterator position)
 		{
 			auto EraseResult=tree.erase(position.get_node_ptr());
-			if(EraseResult){
+			reset_bounds();
+			if(!EraseResult){
 				return end();
-			}else{
-				start = tree.start();
-				last = tree.last();
-				if(!start){
-					start = this_end;
-				}
-				if(!last){
-					last = this_end;
-				}
-				return iterator(EraseResult, *this);
 			}
+			return iterator(EraseResult, *this);
 		}
 
 
 		void erase(const NodeValue& x)
 		{
 			tree.erase(x);
+			reset_bounds();
 		}
 
 
 		void clear() { 
 			tree.destroy();
+			finger = nullptr;
 			start = last = this_end;
 		}
 
+		// Unlink the element at position and hand it over with its node, nothing is released.
+		// Only iterators to it are invalidated, the element keeps its node.
+		node_type extract(const_iterator position)
+		{
+			auto Handle=tree.extract(position.get_node_ptr());
+			reset_bounds();
+			return Handle;
+		}
+
+		// empty if x is not here.
+		node_type extract(const NodeValue& x)
+		{
+			const auto Find=tree.find(x);
+			if(!Find.second){
+				return node_type();
+			}
+			return extract(const_iterator(Find.first, *this));
+		}
+
+		// Link the node of an element extracted from a set of this type(with an equal allocator),
+		// no allocation: if an equal data is already here, the node is given back.
+		insert_return_type insert(node_type&& handle)
+		{
+			if(handle.empty()){
+				return {end(), false, node_type()};
+			}
+			auto InsertResult=tree.insert(std::move(handle));
+			if(InsertResult.second){
+				start = tree.start();
+				last = tree.last();
+			}
+			return {iterator(InsertResult.first, *this), InsertResult.second, std::move(handle)};
+		}
+
+		// Move the data of other which are not here into this set by relinking their nodes,
+		// without any allocation, other keeps the rest. other is walked in order and every data
+		// is searched from the previous one(see abstract_bs_tree::find_from).
+		void merge(tree_set& other)
+		{
+			if(&other == this){
+				return;
+			}
+			typename Tree::const_node_pointer From = nullptr;
+			for(auto node = other.tree.start(); node;){
+				// extracting node moves no data into the nodes after it.
+				auto Next = Tree::increment(node);
+				const auto Find = tree.find_from(From, node->data);
+				From = Find.first;
+				if(!Find.second){
+					From = tree.insert_from(From, other.tree.extract(node)).first;
+				}
+				node = Next;
+			}
+			other.reset_bounds();
+			reset_bounds();
+		}
+
 		iterator find(const NodeValue& x)
 		{
 			auto FindResult= tree.find(x);
@@ -217,6 +444,56 @@ namespace ronleeon::tree{
 			}
 		}
 
+		// Search from hint instead of the root(see abstract_bs_tree::find_from): a hint at or next
+		// to the element, e.g. the previous one found, makes it amortized O(1).
+		const_iterator find(const_iterator hint, const NodeValue& x) const
+		{
+			const auto Find=find_node_from(node_of(hint), x);
+			return Find.second ? const_iterator(Find.first, *this) : end();
+		}
+
+		// Insert x searching from hint, the element equal to x is returned, inserted or not
+		// (like std::set). end() or a hint next to the position of x, as for nearly sorted data,
+		// makes it amortized O(1) plus the rebalancing.
+		iterator insert(const_iterator hint, const NodeValue& x)
+		{
+			return insert_from(node_of(hint), x);
+		}
+
+		iterator insert(const_iterator hint, NodeValue&& x)
+		{
+			return insert_from(node_of(hint), std::move(x));
+		}
+
+		// find and insert hinted by the last element they reached(the root at first, or after
+		// an erase), for data accessed nearly in order without keeping an iterator.
+		const_iterator find_near(const NodeValue& x)
+		{
+			const auto Find=find_node_from(finger, x);
+			if constexpr(finds_from){
+				finger = Find.first;
+			}
+			return Find.second ? const_iterator(Find.first, *this) : end();
+		}
+
+		iterator insert_near(const NodeValue& x)
+		{
+			auto Position=insert_from(finger, x);
+			if constexpr(finds_from){
+				finger = Position.get_node_ptr();
+			}
+			return Position;
+		}
+
+		iterator insert_near(NodeValue&& x)
+		{
+			auto Position=insert_from(finger, std::move(x));
+			if constexpr(finds_from){
+				finger = Position.get_node_ptr();
+			}
+			return Position;
+		}
+
 		int count(const NodeValue& x) const
 		{ return find(x) == end()? 0 : 1; }
 
@@ -225,6 +502,27 @@ namespace ronleeon::tree{
 
 
 
+		// Order statistics, O(log n) when the nodes keep their subtree size(see order_statistic_tree_set).
+
+		// the k-th smallest data(counting from 0), end() if k >= size().
+		iterator select(size_t k)
+		{
+			auto node = tree.select(k);
+			return node ? iterator(node, *this) : end();
+		}
+
+		// number of data less than x.
+		size_t rank(const NodeValue& x) const
+		{ return tree.rank(x); }
+
+		// number of data in [lo, hi).
+		size_t count_range(const NodeValue& lo, const NodeValue& hi) const
+		{ return tree.count_range(lo, hi); }
+
+		// position of position in the set, std::distance(begin(), position) without walking.
+		size_t index_of(const_iterator position) const
+		{ return position == end() ? size() : Tree::index_of(position.get_node_ptr()); }
+
 		iterator begin(){
 			return iterator(start, *this);
 		}
@@ -271,6 +569,22 @@ namespace ronleeon::tree{
 
 	};
 
+	// tree_set whose nodes are carved from its own node_arena,
+	// clear() and destruction drop whole slabs instead of freeing node by node.
+	template <typename NodeValue,typename Compare=std::less<NodeValue>>
+	using arena_tree_set = tree_set<NodeValue,Compare,rb_tree<NodeValue,Compare
+		,node::rb_node<NodeValue>,rb_node_print_trait<node::rb_node<NodeValue>>,arena_allocator<NodeValue>>>;
+
+	// tree_set whose nodes count their subtree, select/rank/count_range/index_of take O(log n).
+	template <typename NodeValue,typename Compare=std::less<NodeValue>>
+	using order_statistic_tree_set = tree_set<NodeValue,Compare,rb_tree<NodeValue,Compare
+		,node::sized_rb_node<NodeValue>,rb_node_print_trait<node::sized_rb_node<NodeValue>>>>;
+
+	// tree_set whose nodes live in the shared node_pool of their type, linked by 32-bit indices.
+	template <typename NodeValue,typename Compare=std::less<NodeValue>>
+	using indexed_tree_set = tree_set<NodeValue,Compare,rb_tree<NodeValue,Compare
+		,node::indexed_rb_node<NodeValue>,rb_node_print_trait<node::indexed_rb_node<NodeValue>>,index_pool_allocator<NodeValue>>>;
+
 }
 
 
@@ -1,6 +1,19 @@
 #include "testBTree.h"
 #include "testSet.h"
 #include "testBbTree.h"
+#include "testAllocator.h"
+
+#include "testNode.h"
+#include "testBuildBalanced.h"
+#include "testSetAlgebra.h"
+#include "testOrderStatistics.h"
+#include "testAugmented.h"
+#include "testIntervalTree.h"
+#include "testSplayTree.h"
+#include "testTree234.h"
+#include "testFingerSearch.h"
+#include "testBplusTree.h"
+#include "testHeap.h"
 #include "ronleeon/tree/m_tree.h"
 #include "ronleeon/tree/B_tree.h"
 #include <vector>
@@ -12,5 +25,32 @@ int main() {
     //testBTree();
     //testBbTree();
 	testSet();
+	testMapLookup();
+	testMapEmplace();
+	testMapUpsert();
+	testMapErase();
+	testAllocator();
+	testNodeHandle();
+	testArena();
+
+	testTeardown();
+
+	testNode();
+	testIndexedNode();
+	testSplitBNode();
+	testAutoBTree();
+	testNodeSearch();
+	testBuildFromSorted();
+	testBuildBalanced();
+	testSetAlgebra();
+	testOrderStatistics();
+	testAugmented();
+	testIntervalTree();
+	testSplayTree();
+	testTree234();
+	testFingerSearch();
+	testBplusTree();
+	testHeap();
+	testPairingHeap();
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include <iostream>
+#include <cassert>
+#include <memory>
+#include "ronleeon/tree/rb_tree.h"
+#include "ronleeon/tree/avl_tree.h"
+#include "ronleeon/tree/bs_tree.h"
+#include "ronleeon/tree/B_tree.h"
+#include "ronleeon/tree/tree_map.h"
+#include "ronleeon/tree/tree_set.h"
+#include "ronleeon/tree/splay_tree.h"
+#include <string>
+
+// counts live allocations of every rebound type.
+inline long long& live_allocations(){
+	static long long live = 0;
+	return live;
+}
+
+template<typename T>
+struct counting_allocator{
+	using value_type = T;
+	counting_allocator() = default;
+	template<typename U>
+	counting_allocator(const counting_allocator<U>&) {}
+	T* allocate(size_t n){
+		live_allocations() += n;
+		return std::allocator<T>().allocate(n);
+	}
+	void deallocate(T* p, size_t n){
+		live_allocations() -= n;
+		std::allocator<T>().deallocate(p, n);
+	}
+	template<typename U>
+	friend bool operator==(const counting_allocator&, const counting_allocator<U>&) { return true; }
+	template<typename U>
+	friend bool operator!=(const counting_allocator&, const counting_allocator<U>&) { return false; }
+};
+
+void testAllocator(){
+	using namespace ronleeon::tree;
+	{
+		rb_tree<int, std::less<int>, node::rb_node<int>, rb_node_print_trait<node::rb_node<int>>, counting_allocator<int>> t;
+		for(int i = 0; i < 100; ++i){
+			t.insert(i);
+		}
+		assert(live_allocations() == 100);
+		t.erase(50);
+		assert(live_allocations() == 99);
+	}
+	assert(live_allocations() == 0);
+	{
+		avl_tree<int, std::less<int>, node::avl_node<int>, avl_node_print_trait<node::avl_node<int>>, counting_allocator<int>> t;
+		for(int i = 0; i < 100; ++i){
+			t.insert(i);
+		}
+		t.destroy();
+		assert(live_allocations() == 0);
+	}
+	{
+		B_tree_Cormen<int, 3, std::less<int>, node::B_node<int, 6>, B_node_print_trait<node::B_node<int, 6>>, counting_allocator<int>> t;
+		for(int i = 0; i < 100; ++i){
+			t.insert(i);
+		}
+		assert(live_allocations() == static_cast<long long>(t.size()));
+	}
+	assert(live_allocations() == 0);
+	{
+		using Pair = pair<int,int>;
+		tree_map<int, int, less<Pair>, rb_tree<Pair, less<Pair>, node::rb_node<Pair>, rb_node_print_trait<node::rb_node<Pair>>, counting_allocator<Pair>>> m;
+		m.insert(1, 2);
+		m.insert(2, 3);
+		assert(live_allocations() == 2);
+		m.clear();
+		assert(live_allocations() == 0);
+	}
+	std::cout<<"allocator: all nodes released\n";
+}
+
+void testArena(){
+	using namespace ronleeon::tree;
+	arena_tree_set<int> set;
+	for(int i = 0; i < 10000; ++i){
+		set.insert(i);
+	}
+	std::shared_ptr<node_arena> arena = set.get_allocator().arena();
+	size_t slabs = arena->slab_count();
+	assert(slabs > 0 && slabs < 16);
+	// shared with `arena`, nodes are released one by one and kept for reuse.
+	set.clear();
+	assert(arena->slab_count() == slabs);
+	for(int i = 0; i < 10000; ++i){
+		set.insert(i);
+	}
+	assert(arena->slab_count() == slabs);
+	arena.reset();
+	set.clear();
+	assert(set.get_allocator().arena()->slab_count() == 0);
+
+	arena_tree_map<int, std::string> map;
+	for(int i = 0; i < 1000; ++i){
+		map.insert(i, std::to_string(i));
+	}
+	map.clear();
+	assert(map.size() == 0);
+	std::cout<<"arena: "<<slabs<<" slabs released at once\n";
+}
+
+// a bs_tree degenerated into a right leaning list of n nodes, as sorted insertion would build it.
+struct degenerate_bs_tree:ronleeon::tree::bs_tree<int, std::less<int>, ronleeon::tree::node::bs_node<int>
+	, ronleeon::tree::b_node_print_trait<ronleeon::tree::node::bs_node<int>>, counting_allocator<int>>{
+	explicit degenerate_bs_tree(int n){
+		node_pointer last = nullptr;
+		for(int i = 0; i < n; ++i){
+			node_pointer node = allocate_node();
+			node->data = i;
+			node->parent = last;
+			if(last){
+				last->right_child = node;
+				last->is_leaf = false;
+				last->child_size = 1;
+			}else{
+				_root = node;
+			}
+			last = node;
+		}
+		num_of_nodes = n;
+	}
+};
+
+void testTeardown(){
+	using namespace ronleeon::tree;
+	{
+		// recursive teardown would overflow the stack.
+		degenerate_bs_tree t(1000000);
+		assert(live_allocations() == 1000000);
+		t.destroy();
+		assert(live_allocations() == 0);
+	}
+	{
+		avl_tree<int, std::less<int>, node::avl_node<int>, avl_node_print_trait<node::avl_node<int>>, counting_allocator<int>> t;
+		for(int i = 0; i < 1000; ++i){
+			t.insert(i);
+		}
+		size_t steps = 1;
+		while(!t.destroy_step(100)){
+			assert(t.size() == 0);
+			++steps;
+		}
+		assert(steps == 10 && live_allocations() == 0);
+		// leftovers of an unfinished teardown are released along with the tree.
+		for(int i = 0; i < 1000; ++i){
+			t.insert(i);
+		}
+		t.destroy_step(10);
+		t.insert(1);
+		assert(t.size() == 1);
+	}
+	assert(live_allocations() == 0);
+	{
+		rb_tree<int, std::less<int>, node::rb_node<int>, rb_node_print_trait<node::rb_node<int>>, arena_allocator<int>> t;
+		for(int i = 0; i < 10000; ++i){
+			t.insert(i);
+		}
+		std::weak_ptr<node_arena> arena = t.get_allocator().arena();
+		auto done = t.destroy_in_background();
+		// the tree continues with a fresh arena.
+		assert(t.size() == 0 && t.get_allocator().arena() != arena.lock());
+		t.insert(1);
+		done.wait();
+		assert(arena.expired() && t.size() == 1);
+	}
+	std::cout<<"teardown: nodes released without recursion\n";
+}
+
+// nodes moved between maps by extract, insert and merge: no allocation, the rest stays balanced.
+template<typename Tree>
+void check_node_handles(){
+	using namespace ronleeon::tree;
+	using Pair = pair<int, std::string>;
+	using Map = tree_map<int, std::string, less<Pair>, Tree>;
+	{
+		Map Hot, Cold;
+		for(int i = 0; i < 1000; ++i){
+			Hot.insert(i, std::to_string(i));
+		}
+		for(int i = 500; i < 1500; i += 2){
+			Cold.insert(i, "cold");
+		}
+		const long long Live = live_allocations();
+		assert(Live == 1500);
+		// the extracted element leaves with its own node, its neighbours keep theirs.
+		for(int i = 100; i < 1000; i += 100){
+			auto Position = Hot.find(i), Before = Hot.find(i - 1), After = Hot.find(i + 1);
+			const Pair* Address = &*Position;
+			auto Taken = Hot.extract(Position);
+			assert(&Taken.value() == Address && Taken.value().second == std::to_string(i) && Hot.find(i) == Hot.end());
+			assert(Before->first == i - 1 && Before->second == std::to_string(i - 1) && &*Hot.find(i - 1) == &*Before);
+			assert(After->first == i + 1 && After->second == std::to_string(i + 1) && &*Hot.find(i + 1) == &*After);
+			assert(Hot.insert(std::move(Taken)).position->first == i && &*Hot.find(i) == Address);
+		}
+		assert(Hot.size() == 1000 && live_allocations() == Live);
+		auto Handle = Hot.extract(10);
+		assert(Handle && Handle.value().first == 10 && Handle.value().second == "10" && Hot.size() == 999);
+		assert(Hot.extract(10).empty());
+		Handle.value().second = "moved";
+		auto Result = Cold.insert(std::move(Handle));
+		assert(Result.inserted && Result.node.empty() && Result.position->second == "moved" && Cold.begin()->first == 10);
+		// a present key gives the node back.
+		auto Again = Cold.insert(Hot.extract(Hot.find(500)));
+		assert(!Again.inserted && Again.position->second == "cold" && Again.node.value().second == "500");
+		assert(Hot.insert(std::move(Again.node)).inserted && Hot.size() == 999);
+		for(int i = 0; i < 1000; i += 3){
+			auto Moved = Hot.extract(i);
+			if(Moved){
+				// a cold key keeps its value, the hot node goes back.
+				if(auto Back = Cold.insert(std::move(Moved)); !Back.inserted){
+					Hot.insert(std::move(Back.node));
+				}
+			}
+		}
+		Hot.merge(Cold);
+		assert(live_allocations() == Live);
+		assert(Hot.size() == 1000 + 250 && Cold.size() == 250);
+		int Expected = 0;
+		for(auto It = Hot.begin(); It != Hot.end(); ++It, Expected += Expected < 1000 ? 1 : 2){
+			assert(It->first == Expected);
+		}
+		for(auto It = Cold.begin(); It != Cold.end(); ++It){
+			assert(It->first >= 500 && It->first < 1000 && It->first % 2 == 0 && It->second == "cold");
+		}
+		// a node handle going away releases its node.
+		{
+			auto Dropped = Hot.extract(Hot.begin());
+		}
+		assert(live_allocations() == Live - 1 && Hot.size() == 1249 && Hot.begin()->first == 1);
+	}
+	assert(live_allocations() == 0);
+}
+
+void testNodeHandle(){
+	using namespace ronleeon::tree;
+	using Pair = pair<int, std::string>;
+	check_node_handles<rb_tree<Pair, less<Pair>, node::rb_node<Pair>, rb_node_print_trait<node::rb_node<Pair>>, counting_allocator<Pair>>>();
+	check_node_handles<avl_tree<Pair, less<Pair>, node::avl_node<Pair>, avl_node_print_trait<node::avl_node<Pair>>, counting_allocator<Pair>>>();
+	check_node_handles<splay_tree<Pair, less<Pair>, node::compact_bs_node<Pair>, b_node_print_trait<node::compact_bs_node<Pair>>, counting_allocator<Pair>>>();
+	{
+		// extracted nodes keep no stale balancing fields.
+		using Tree = rb_tree<int, std::less<int>, node::sized_rb_node<int>, rb_node_print_trait<node::sized_rb_node<int>>, counting_allocator<int>>;
+		tree_set<int, std::less<int>, Tree> Even, Odd;
+		for(int i = 0; i < 2000; ++i){
+			(i % 2 ? Odd : Even).insert(i);
+		}
+		for(int i = 0; i < 2000; i += 4){
+			Odd.insert(Even.extract(i));
+		}
+		Even.merge(Odd);
+		assert(live_allocations() == 2000 && Even.size() == 2000 && Odd.size() == 0);
+		assert(Even.rank(1000) == 1000 && *Even.select(1234) == 1234);
+	}
+	assert(live_allocations() == 0);
+	std::cout<<"node handles: nodes moved without allocation\n";
+}
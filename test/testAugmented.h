@@ -0,0 +1,91 @@
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+#include "ronleeon/tree/rb_tree.h"
+#include "ronleeon/tree/avl_tree.h"
+#include "ronleeon/tree/bs_tree.h"
+#include "ronleeon/tree/tree_map.h"
+#include "testTreeCheck.h"
+
+// polynomial hash of a sequence, combining is not commutative so the order of the data is checked too.
+struct sequence_hash{
+	using value_type = std::pair<unsigned long long,unsigned long long>;// hash, 31^length
+	static value_type identity(){ return {0,1}; }
+	static value_type lift(int data){ return {static_cast<unsigned long long>(data)+1,31}; }
+	static value_type combine(const value_type& lhs,const value_type& rhs){
+		return {lhs.first*rhs.second+rhs.first,lhs.second*rhs.second};
+	}
+};
+
+// aggregates through random inserts and erases, against folding std::set ranges.
+template<typename Tree,bool Joinable=true,typename Check>
+void check_augmented(Check check){
+	Tree t;
+	std::set<int> expected;
+	auto fold=[&](int lo,int hi){
+		auto Ret=sequence_hash::identity();
+		for(auto It=expected.lower_bound(lo);lo<hi&&It!=expected.end()&&*It<hi;++It){
+			Ret=sequence_hash::combine(Ret,sequence_hash::lift(*It));
+		}
+		return Ret;
+	};
+	random_updates(t,expected,9,5000,800,[&](int round,std::mt19937& gen){
+		if(round%250!=0){
+			return;
+		}
+		if(t.get_root()){
+			check(t.get_root());
+		}
+		assert(t.aggregate()==fold(-1,800));
+		std::uniform_int_distribution<int> dist(0,799);
+		for(int query=0;query<20;++query){
+			int lo=dist(gen),hi=dist(gen);
+			assert(t.aggregate(lo,hi)==fold(lo,hi));
+		}
+	});
+	if constexpr(Joinable){
+		Tree u;
+		std::vector<int> Data;
+		for(int value=-300;value<1200;value+=7){
+			Data.push_back(value);
+			expected.insert(value);
+		}
+		u.build_from_sorted(Data.begin(),Data.end());
+		t.union_with(u);
+		assert(t.aggregate()==fold(-1000,2000)&&t.aggregate(0,500)==fold(0,500));
+	}
+}
+
+void testAugmented(){
+	using namespace ronleeon::tree;
+	check_augmented<rb_tree<int,std::less<int>,node::augmented_rb_node<int,sequence_hash>,rb_node_print_trait<node::augmented_rb_node<int,sequence_hash>>>>(
+		[](const node::augmented_rb_node<int,sequence_hash>* root){ assert(black_height(root)>0); });
+	{
+		using tree_type = avl_tree<int,std::less<int>,node::augmented_avl_node<int,sequence_hash>,avl_node_print_trait<node::augmented_avl_node<int,sequence_hash>>>;
+		check_augmented<tree_type>([](const node::augmented_avl_node<int,sequence_hash>* root){ assert(tree_type::is_balanced(root)); });
+	}
+	check_augmented<bs_tree<int,std::less<int>,node::augmented_bs_node<int,sequence_hash>>,false>([](const node::augmented_bs_node<int,sequence_hash>*){});
+	{
+		augmented_tree_map<int,long,value_sum<int,long>> sums;
+		augmented_tree_map<int,long,value_max<int,long>> maxima;
+		for(int key=0;key<100;++key){
+			sums.insert(key,10L*key);
+			maxima.insert(key,(37L*key)%101);
+		}
+		assert(sums.aggregate(10,20)==1450&&sums.aggregate()==49500&&sums.aggregate(20,10)==0);
+		sums.insert_or_assign(15,0L);
+		assert(sums.aggregate(10,20)==1300);
+		sums.erase(11);
+		assert(sums.aggregate(10,20)==1190);
+		long Max=0;
+		for(int key=30;key<60;++key){
+			Max=std::max(Max,static_cast<long>((key*37)%101));
+		}
+		assert(maxima.aggregate(30,60)==Max);
+	}
+	std::cout<<"augmented trees: aggregates consistent\n";
+}
@@ -0,0 +1,147 @@
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+#include "ronleeon/tree/Bplus_tree.h"
+
+// walks a B+ tree checking separators, key counts and that all leaves are on one level,
+// leaves are collected left to right.
+template<typename NodeType>
+void check_Bplus_node(const NodeType* node,size_t MinKeys,size_t MaxKeys,size_t Depth,size_t& LeafDepth
+	,std::vector<const NodeType*>& Leaves){
+	if(node->parent){
+		assert(node->data_size>=MinKeys);
+	}
+	assert(node->data_size<=MaxKeys);
+	for(size_t Index=1;Index<node->data_size;++Index){
+		assert(node->data[Index-1]<node->data[Index]);
+	}
+	if(node->is_leaf){
+		if(LeafDepth==0){
+			LeafDepth=Depth;
+		}
+		assert(LeafDepth==Depth);
+		Leaves.push_back(node);
+		return;
+	}
+	assert(!node->Pre&&!node->Next);
+	for(size_t Index=0;Index<=node->data_size;++Index){
+		const NodeType* Child=node->children[Index];
+		assert(Child&&Child->parent==node);
+		// the child holds the data in [data[Index-1],data[Index]).
+		if(Index<node->data_size){
+			assert(Child->data[Child->data_size-1]<node->data[Index]);
+		}
+		if(Index>0){
+			assert(!(Child->data[0]<node->data[Index-1]));
+		}
+		check_Bplus_node(Child,MinKeys,MaxKeys,Depth+1,LeafDepth,Leaves);
+	}
+}
+
+template<typename Tree>
+void check_Bplus_tree(const Tree& t,const std::set<int>& expected,size_t Degree){
+	if(!t.get_root()){
+		assert(expected.empty()&&t.begin()==t.end());
+		return;
+	}
+	size_t LeafDepth=0;
+	std::vector<typename Tree::const_node_pointer> Leaves;
+	check_Bplus_node(t.get_root(),Degree-1,2*Degree-1,1,LeafDepth,Leaves);
+	assert(LeafDepth==t.get_height());
+	// the chain links the leaves in order.
+	for(size_t Index=0;Index<Leaves.size();++Index){
+		assert(Leaves[Index]->Pre==(Index?Leaves[Index-1]:nullptr));
+		assert(Leaves[Index]->Next==(Index+1<Leaves.size()?Leaves[Index+1]:nullptr));
+	}
+	assert(std::equal(t.begin(),t.end(),expected.begin(),expected.end()));
+}
+
+void testBplusTree(){
+	using namespace ronleeon::tree;
+	{
+		Bplus_tree<int,3> t;
+		std::mt19937 gen(7);
+		std::uniform_int_distribution<int> dist(0,999);
+		std::set<int> expected;
+		for(int round=0;round<20000;++round){
+			int value=dist(gen);
+			if(round%2){
+				t.erase(value,round%3==0,round%5==0);
+				expected.erase(value);
+			}else{
+				assert(std::get<2>(t.insert(value))==expected.insert(value).second);
+			}
+			if(round%100==0){
+				check_Bplus_tree(t,expected,3);
+			}
+		}
+		for(int value=0;value<1000;++value){
+			assert(std::get<2>(t.find(value))==(expected.count(value)>0));
+			auto It=t.lower_bound(value);
+			auto Expected=expected.lower_bound(value);
+			assert(Expected==expected.end()?It==t.end():*It==*Expected);
+			It=t.upper_bound(value);
+			Expected=expected.upper_bound(value);
+			assert(Expected==expected.end()?It==t.end():*It==*Expected);
+		}
+		for(int Low=0;Low<1000;Low+=37){
+			std::vector<int> Range;
+			t.for_each_in_range(Low,Low+200,[&](int value){ Range.push_back(value); });
+			assert(std::equal(Range.begin(),Range.end(),expected.lower_bound(Low),expected.lower_bound(Low+200)));
+		}
+		for(int value:expected){
+			t.erase(value);
+		}
+		assert(t.is_empty()&&t.get_height()==0&&t.begin()==t.end());
+	}
+	{
+		Bplus_tree<int,2> t;
+		for(int i=0;i<10000;++i){
+			t.insert(i);
+		}
+		std::set<int> expected;
+		for(int i=0;i<10000;++i){
+			expected.insert(i);
+		}
+		check_Bplus_tree(t,expected,2);
+		assert(t.min()==0&&t.max()==9999);
+		long long Sum=0;
+		t.for_each_in_range(100,200,[&](int value){ Sum+=value; });
+		assert(Sum==(100+199)*100/2);
+	}
+	{
+		std::vector<int> Data;
+		std::set<int> expected;
+		for(int value=0;value<30000;value+=3){
+			Data.push_back(value);
+			expected.insert(value);
+		}
+		for(double Fill:{1.0,0.5,0.0}){
+			Bplus_tree<int,3> t;
+			t.build_from_sorted(Data.begin(),Data.end(),Fill);
+			check_Bplus_tree(t,expected,3);
+			std::set<int> updated=expected;
+			std::mt19937 gen(7);
+			std::uniform_int_distribution<int> dist(0,29999);
+			for(int round=0;round<4000;++round){
+				int value=dist(gen);
+				if(round%2){
+					t.erase(value);
+					updated.erase(value);
+				}else{
+					t.insert(value);
+					updated.insert(value);
+				}
+			}
+			check_Bplus_tree(t,updated,3);
+			size_t Nodes=t.size();
+			t.compact();
+			check_Bplus_tree(t,updated,3);
+			assert(t.size()<=Nodes);
+		}
+	}
+	std::cout<<"B+ tree: leaf chain consistent\n";
+}
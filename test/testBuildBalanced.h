@@ -0,0 +1,90 @@
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <set>
+#include <vector>
+#include "ronleeon/tree/rb_tree.h"
+#include "ronleeon/tree/avl_tree.h"
+#include "ronleeon/tree/bs_tree.h"
+#include "ronleeon/tree/tree_set.h"
+#include "ronleeon/tree/tree_map.h"
+#include "testTreeCheck.h"
+
+// builds from 0..n-1 then goes on with random updates, check validates the balancing fields.
+template<typename Tree,typename Check>
+void check_balanced_build(Check check){
+	for(int n:{0,1,2,3,4,5,6,7,8,15,16,17,100,1000,1023,1024,5000}){
+		std::vector<int> Data(static_cast<size_t>(n));
+		for(int value=0;value<n;++value){
+			Data[static_cast<size_t>(value)]=value*2;
+		}
+		Tree t;
+		t.insert(-1);
+		t.build_from_sorted(Data.begin(),Data.end());
+		assert(t.size()==Data.size());
+		if(n==0){
+			assert(!t.get_root()&&!t.start()&&!t.last());
+			continue;
+		}
+		assert(t.start()->data==0&&t.last()->data==2*(n-1));
+		auto node=t.start();
+		for(int value:Data){
+			assert(node->data==value);
+			node=Tree::increment(node);
+		}
+		// perfectly balanced.
+		int Height=check_bookkeeping(t.get_root());
+		assert((size_t(1)<<(Height-1))<=Data.size()&&Data.size()<(size_t(1)<<Height));
+		check(t.get_root());
+		std::set<int> expected(Data.begin(),Data.end());
+		random_updates(t,expected,7,2*n,2*n+1,[](int,std::mt19937&){});
+		check_in_order(t,expected);
+		if(t.get_root()){
+			check(t.get_root());
+		}
+	}
+}
+
+void testBuildBalanced(){
+	using namespace ronleeon::tree;
+	check_balanced_build<rb_tree<int>>([](const node::rb_node<int>* root){
+		assert(black_height(root)>0&&node::rb_color_trait<node::rb_node<int>>::color(root)==node::rb_node<int>::COLOR::BLACK);
+	});
+	check_balanced_build<rb_tree<int,std::less<int>,node::tagged_rb_node<int>,rb_node_print_trait<node::tagged_rb_node<int>>>>(
+		[](const node::tagged_rb_node<int>* root){ assert(black_height(root)>0); });
+	check_balanced_build<avl_tree<int>>([](const node::avl_node<int>* root){ assert(avl_tree<int>::is_balanced(root)); });
+	{
+		using tree_type = avl_tree<int,std::less<int>,node::tagged_avl_node<int>,avl_node_print_trait<node::tagged_avl_node<int>>>;
+		check_balanced_build<tree_type>([](const node::tagged_avl_node<int>* root){ assert(tree_type::is_balanced(root)); });
+	}
+	check_balanced_build<bs_tree<int>>([](const node::bs_node<int>*){});
+	{
+		// sorted arrays are built, others inserted one by one.
+		int Sorted[]={1,2,3,4,5,6,7,8,9,10};
+		int Unsorted[]={5,1,9,3,7,2,8,4,6,10};
+		avl_tree<int> a(Sorted,10),b(Unsorted,10);
+		assert(avl_tree<int>::is_balanced(a.get_root())&&avl_tree<int>::is_balanced(b.get_root()));
+		rb_tree<int> c(Sorted,10),d(Unsorted,10);
+		assert(black_height(c.get_root())>0&&black_height(d.get_root())>0&&c.size()==10&&d.size()==10);
+	}
+	{
+		std::vector<int> Data;
+		for(int value=0;value<1000;++value){
+			Data.push_back(value);
+		}
+		tree_set<int> s(sorted_unique,Data.begin(),Data.end());
+		assert(s.size()==1000&&std::equal(s.begin(),s.end(),Data.begin(),Data.end()));
+		tree_set<int> u;
+		u.insert(Data.begin(),Data.end());
+		assert(u.size()==1000&&*u.begin()==0&&*u.rbegin()==999);
+		u.insert(sorted_unique,Data.begin(),Data.end());
+		assert(u.size()==1000);
+		std::vector<pair<int,int>> Pairs;
+		for(int value=0;value<100;++value){
+			Pairs.emplace_back(value,value*value);
+		}
+		tree_map<int,int> m(sorted_unique,Pairs.begin(),Pairs.end());
+		assert(m.size()==100&&m.begin()->first==0&&(*std::next(m.begin(),9)).second==81);
+	}
+	std::cout<<"balanced build: trees consistent\n";
+}
@@ -0,0 +1,94 @@
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include "ronleeon/tree/rb_tree.h"
+#include "ronleeon/tree/avl_tree.h"
+#include "ronleeon/tree/splay_tree.h"
+#include "ronleeon/tree/tree_234.h"
+#include "ronleeon/tree/tree_set.h"
+#include "ronleeon/tree/tree_map.h"
+#include "testTreeCheck.h"
+
+// Inserts from the last node reached(or a random one after an erase), then searches from fingers
+// nearby and past the ends: the same nodes as from the root, against std::set.
+template<typename Tree,typename Check>
+void check_finger_search(Check check){
+	Tree t;
+	std::set<int> expected;
+	typename Tree::const_node_pointer finger=nullptr;
+	random_updates(t,expected,11,6000,2000,[&](int value){
+		auto Result=t.try_emplace_from(finger,value,value);
+		finger=Result.first;
+		return Result;
+	},[&](int round,std::mt19937& gen){
+		if(round%3==2||round%5==0){
+			// the finger may be gone, take one anywhere.
+			finger=expected.empty()?nullptr:t.find(*std::next(expected.begin(),static_cast<long>(gen()%expected.size()))).first;
+		}
+	});
+	for(int value:{-7,5000}){
+		auto Result=t.try_emplace_from(finger,value,value);
+		assert(Result.second&&expected.insert(value).second&&Result.first->data==value);
+		finger=Result.first;
+	}
+	for(int value=-10;value<5010;value+=3){
+		auto Find=t.find_from(finger,value);
+		auto Root=t.find(value);
+		assert(Find.second==(expected.count(value)==1)&&Find.second==Root.second);
+		assert(!Find.second||Find.first->data==value);
+		if(!Find.second){
+			// the node the data would be linked to.
+			assert(Find.first==Root.first);
+		}
+		finger=Find.first;
+	}
+	check_in_order(t,expected);
+	check(t.get_root());
+}
+
+void testFingerSearch(){
+	using namespace ronleeon::tree;
+	check_finger_search<rb_tree<int>>([](const node::rb_node<int>* root){ assert(black_height(root)>0); });
+	check_finger_search<avl_tree<int>>([](const node::avl_node<int>* root){ assert(avl_tree<int>::is_balanced(root)); });
+	{
+		using tree_type = rb_tree<int,std::less<int>,node::sized_rb_node<int>,rb_node_print_trait<node::sized_rb_node<int>>>;
+		check_finger_search<tree_type>([](const node::sized_rb_node<int>* root){
+			assert(black_height(root)>0);
+			check_bookkeeping(root);
+		});
+	}
+	check_finger_search<splay_tree<int>>([](const node::compact_bs_node<int>*){});
+	{
+		tree_map<int,int> m;
+		for(int i=0;i<1000;++i){
+			assert(m.insert(m.end(),pair<int,int>(i,i*i))->second==i*i);
+		}
+		// an existing key is returned, not replaced.
+		assert(m.insert(m.begin(),pair<int,int>(500,0))->second==250000&&m.size()==1000);
+		for(int i=0;i<1000;i+=7){
+			auto It=m.find(m.find(std::max(i-1,0)),i);
+			assert(It!=m.end()&&It->first==i);
+			assert(m.find_near(i)->second==i*i);
+		}
+		assert(m.find(m.begin(),5000)==m.end()&&m.find_near(-1)==m.end());
+		for(int i=1999;i>=1000;--i){
+			m.insert_near(pair<int,int>(i,-i));
+		}
+		m.erase(1500);
+		assert(m.find_near(1501)->second==-1501&&m.size()==1999&&(--m.end())->first==1999);
+	}
+	{
+		tree_set<int> s;
+		tree_set<int,std::less<int>,tree_234<int>> s234;
+		for(int i=0;i<500;++i){
+			s.insert_near(i*2);
+			s234.insert(s234.end(),i*2);
+		}
+		assert(*s.insert(s.end(),1)==1&&*s234.insert(s234.begin(),1)==1&&s.size()==501&&s234.size()==501);
+		assert(*s.find(s.begin(),998)==998&&*s234.find_near(998)==998&&s.find_near(3)==s.end());
+	}
+	std::cout<<"finger search: same nodes as from the root\n";
+}
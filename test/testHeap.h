@@ -0,0 +1,255 @@
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <set>
+#include <string>
+#include <vector>
+#include "ronleeon/heap/d_ary_heap.h"
+#include "ronleeon/heap/pairing_heap.h"
+
+// random pushes, batches and pops against a sorted copy.
+template<typename Heap,typename Make>
+void check_d_ary_heap(Make make){
+	using value_type = typename Heap::value_type;
+	std::mt19937 gen(19);
+	std::uniform_int_distribution<int> dist(-500,500);
+	Heap h;
+	std::vector<value_type> expected;
+	auto pop_check=[&]{
+		auto Least=std::min_element(expected.begin(),expected.end());
+		assert(!(h.top()<*Least)&&!(*Least<h.top()));
+		expected.erase(Least);
+		h.pop();
+	};
+	for(int round=0;round<5000;++round){
+		switch(round%7){
+			case 0:{
+				// batches from a single element to more than the heap.
+				std::vector<value_type> Batch;
+				for(int count=round%5==0?400:round%3;count>0;--count){
+					Batch.push_back(make(dist(gen)));
+				}
+				h.push_batch(Batch.begin(),Batch.end());
+				expected.insert(expected.end(),Batch.begin(),Batch.end());
+				break;
+			}
+			case 1:
+			case 2:
+			case 3:
+				if(!expected.empty()){
+					pop_check();
+					break;
+				}
+				[[fallthrough]];
+			default:{
+				auto Value=make(dist(gen));
+				h.push(Value);
+				expected.push_back(Value);
+			}
+		}
+		assert(h.size()==expected.size());
+		if(round%100==0){
+			assert(h.is_heap());
+		}
+	}
+	std::vector<value_type> Data;
+	for(int count=0;count<3000;++count){
+		Data.push_back(make(dist(gen)));
+	}
+	h.heapify(Data.begin(),Data.end());
+	assert(h.is_heap()&&h.size()==Data.size());
+	std::sort(Data.begin(),Data.end());
+	for(const auto& Value:Data){
+		assert(!(h.top()<Value)&&!(Value<h.top()));
+		h.pop();
+	}
+	assert(h.empty());
+}
+
+void testHeap(){
+	using namespace ronleeon::heap;
+	auto same=[](int value){ return value; };
+	check_d_ary_heap<d_ary_heap<int,4>>(same);
+	check_d_ary_heap<d_ary_heap<int,8>>(same);
+	check_d_ary_heap<d_ary_heap<long,4>>([](int value){ return static_cast<long>(value); });
+	check_d_ary_heap<d_ary_heap<long,8>>([](int value){ return static_cast<long>(value)*(1L<<33); });
+	check_d_ary_heap<d_ary_heap<unsigned,8>>([](int value){ return static_cast<unsigned>(value)+0x7fffffffu; });
+	check_d_ary_heap<d_ary_heap<unsigned long,8>>([](int value){ return static_cast<unsigned long>(value)*3; });
+	check_d_ary_heap<d_ary_heap<float,8>>([](int value){ return value/8.0f; });
+	check_d_ary_heap<d_ary_heap<float,16>>([](int value){ return value/8.0f; });
+	check_d_ary_heap<d_ary_heap<double,8>>([](int value){ return value/8.0; });
+	check_d_ary_heap<d_ary_heap<int,3>>(same);
+	check_d_ary_heap<d_ary_heap<std::string,4>>([](int value){ return std::to_string(value); });
+	{
+		// a max-heap, and a min-heap keeping the 10 greatest values seen.
+		d_ary_heap<int,4,std::greater<int>> h;
+		d_ary_heap<int,8> top_k;
+		for(int value=0;value<1000;++value){
+			int Value=(value*7919)%1000;
+			h.push(Value);
+			if(top_k.size()<10){
+				top_k.push(Value);
+			}else if(top_k.top()<Value){
+				top_k.replace_top(Value);
+			}
+		}
+		assert(h.top()==999&&h.extract_top()==999&&h.top()==998);
+		assert(top_k.size()==10&&top_k.top()==990&&top_k.is_heap());
+	}
+	std::cout<<"d-ary heap: heap order kept\n";
+}
+
+// random pushes, decreases, erases, pops and melds of (priority, id) against a std::set.
+template<typename Heap>
+void check_pairing_heap(){
+	using handle = typename Heap::handle;
+	std::mt19937 gen(23);
+	std::uniform_int_distribution<int> dist(0,1000);
+	Heap h, other;
+	std::set<std::pair<int,int>> expected;
+	std::vector<handle> handles;
+	std::vector<int> live;
+	auto pick=[&]{
+		size_t index=std::uniform_int_distribution<size_t>(0,live.size()-1)(gen);
+		int id=live[index];
+		live[index]=live.back();
+		live.pop_back();
+		return id;
+	};
+	for(int round=0;round<20000;++round){
+		if(round%9>=3&&round%27!=4){
+			// handles are only given back to the heap holding them.
+			h.meld(other);
+			assert(other.empty());
+		}
+		switch(round%9){
+			case 0:
+			case 1:
+			case 2:{
+				// pushed to the other heap now and then, melded later.
+				int id=static_cast<int>(handles.size());
+				std::pair<int,int> Value(dist(gen),id);
+				handles.push_back(round%4==0?other.push(Value):h.push(Value));
+				expected.insert(Value);
+				live.push_back(id);
+				break;
+			}
+			case 3:
+			case 4:
+			case 5:
+				if(other.empty()&&!live.empty()){
+					int id=pick();
+					live.push_back(id);
+					auto Value=handles[id]->data;
+					expected.erase(Value);
+					Value.first-=dist(gen)%50;
+					expected.insert(Value);
+					h.decrease(handles[id],Value);
+				}
+				break;
+			case 6:
+				if(other.empty()&&!live.empty()){
+					int id=pick();
+					expected.erase(handles[id]->data);
+					h.erase(handles[id]);
+				}
+				break;
+			default:
+				if(other.empty()&&!h.empty()){
+					assert(h.top()==*expected.begin());
+					live.erase(std::find(live.begin(),live.end(),h.top().second));
+					expected.erase(expected.begin());
+					h.pop();
+				}
+				break;
+		}
+		if(round%500==0){
+			assert(h.is_heap()&&other.is_heap());
+			assert(h.size()+other.size()==expected.size());
+		}
+	}
+	h.meld(other);
+	assert(h.is_heap()&&h.size()==expected.size());
+	for(auto& Value:expected){
+		assert(h.top()==Value);
+		h.pop();
+	}
+	assert(h.empty()&&h.is_heap());
+}
+
+void testPairingHeap(){
+	using namespace ronleeon::heap;
+	check_pairing_heap<pairing_heap<std::pair<int,int>>>();
+	{
+		// Dijkstra with decrease-key against one with stale entries in a d-ary heap.
+		std::mt19937 gen(5);
+		const int Vertices=2000;
+		std::vector<std::vector<std::pair<int,int>>> Edges(Vertices);
+		for(int edge=0;edge<Vertices*8;++edge){
+			int from=static_cast<int>(gen()%Vertices),to=static_cast<int>(gen()%Vertices);
+			Edges[from].emplace_back(to,static_cast<int>(gen()%100));
+		}
+		const int Unreached=std::numeric_limits<int>::max();
+		std::vector<int> Dist(Vertices,Unreached),Want(Vertices,Unreached);
+		pairing_heap<std::pair<int,int>> Queue;
+		std::vector<pairing_heap<std::pair<int,int>>::handle> Handles(Vertices,nullptr);
+		std::vector<bool> Done(Vertices,false);
+		Dist[0]=0;
+		Handles[0]=Queue.push({0,0});
+		while(!Queue.empty()){
+			int from=Queue.extract_top().second;
+			Done[from]=true;
+			for(auto [to,weight]:Edges[from]){
+				if(Done[to]||Dist[from]+weight>=Dist[to]){
+					continue;
+				}
+				Dist[to]=Dist[from]+weight;
+				if(Handles[to]){
+					Queue.decrease(Handles[to],{Dist[to],to});
+				}else{
+					Handles[to]=Queue.push({Dist[to],to});
+				}
+			}
+		}
+		d_ary_heap<std::pair<int,int>,4> Lazy;
+		Want[0]=0;
+		Lazy.push({0,0});
+		while(!Lazy.empty()){
+			auto [dist,from]=Lazy.extract_top();
+			if(dist>Want[from]){
+				continue;
+			}
+			for(auto [to,weight]:Edges[from]){
+				if(dist+weight<Want[to]){
+					Want[to]=dist+weight;
+					Lazy.push({Want[to],to});
+				}
+			}
+		}
+		assert(Dist==Want);
+	}
+	{
+		pairing_heap<int,std::less<int>,node::pairing_node<int>,counting_allocator<int>> h, other;
+		for(int value=0;value<100;++value){
+			(value%2?h:other).push((value*37)%100);
+		}
+		assert(live_allocations()==100);
+		h.meld(other);
+		auto Handle=h.push(500);
+		h.decrease(Handle,-1);
+		assert(h.top()==-1&&h.top_handle()==Handle);
+		h.erase(Handle);
+		h.pop();
+		assert(live_allocations()==99&&h.top()==1);
+		h.clear();
+		assert(live_allocations()==0);
+		for(int value=0;value<10;++value){
+			h.push(value);
+		}
+	}
+	assert(live_allocations()==0);
+	std::cout<<"pairing heap: heap order kept\n";
+}
@@ -0,0 +1,75 @@
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+#include "ronleeon/tree/interval_tree.h"
+#include "testTreeCheck.h"
+
+// overlap, stabbing and batched stabbing queries through random inserts and erases, against a scan.
+void testIntervalTree(){
+	using namespace ronleeon::tree;
+	using interval_type = interval<int>;
+	std::mt19937 gen(16);
+	std::uniform_int_distribution<int> dist(0,999);
+	std::uniform_int_distribution<int> length(1,60);
+	interval_tree<int> t;
+	std::set<interval_type,interval_less<int>> expected;
+	auto scan=[&](int lo,int hi){
+		std::vector<interval_type> Ret;
+		for(const auto& Interval:expected){
+			if(Interval.overlaps(lo,hi)){
+				Ret.push_back(Interval);
+			}
+		}
+		return Ret;
+	};
+	for(int round=0;round<4000;++round){
+		int low=dist(gen);
+		interval_type Interval{low,low+length(gen)};
+		if(round%4==3&&!expected.empty()){
+			auto It=expected.lower_bound(Interval);
+			if(It==expected.end()){
+				It=expected.begin();
+			}
+			assert(t.erase(*It));
+			expected.erase(It);
+		}else{
+			assert(t.insert(Interval)==expected.insert(Interval).second);
+		}
+		if(round%200==0){
+			assert(t.size()==expected.size()&&black_height(t.get_tree().get_root())>0);
+			for(int query=0;query<20;++query){
+				int lo=dist(gen),hi=lo+length(gen);
+				assert(t.overlapping(lo,hi)==scan(lo,hi));
+				assert(t.stabbing(lo)==scan(lo,lo+1));
+			}
+		}
+	}
+	assert(t.overlapping(5,5).empty()&&!t.contains({-5,-1})&&!t.erase(-5,-1));
+	for(size_t points:{size_t(3),size_t(2000)}){
+		std::vector<int> Points;
+		for(size_t i=0;i<points;++i){
+			Points.push_back(dist(gen));
+		}
+		std::sort(Points.begin(),Points.end());
+		std::vector<std::pair<int,interval_type>> Hits,Want;
+		t.stab_sorted(Points.begin(),Points.end(),[&Hits](int point,const interval_type& Interval){ Hits.emplace_back(point,Interval); });
+		for(int point:Points){
+			for(const auto& Interval:scan(point,point+1)){
+				Want.emplace_back(point,Interval);
+			}
+		}
+		auto Less=[](const std::pair<int,interval_type>& lhs,const std::pair<int,interval_type>& rhs){
+			return lhs.first!=rhs.first?lhs.first<rhs.first:interval_less<int>{}(lhs.second,rhs.second);
+		};
+		std::sort(Hits.begin(),Hits.end(),Less);
+		std::sort(Want.begin(),Want.end(),Less);
+		assert(Hits==Want);
+	}
+	t.clear();
+	assert(t.empty()&&t.stabbing(10).empty());
+	std::cout<<"interval tree: queries consistent\n";
+}
@@ -0,0 +1,381 @@
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <algorithm>
+#include <array>
+#include <set>
+#include <vector>
+#include "ronleeon/tree/rb_tree.h"
+#include "ronleeon/tree/avl_tree.h"
+#include "ronleeon/tree/bs_tree.h"
+#include "ronleeon/tree/B_tree.h"
+#include "ronleeon/tree/tree_set.h"
+#include "ronleeon/tree/tree_map.h"
+#include "testTreeCheck.h"
+
+// random inserts and erases checked against std::set, through the in-order links.
+template<typename Tree,typename Check>
+void check_against_set(Tree& t,Check check){
+	std::set<int> expected;
+	random_updates(t,expected,7,4000,500,[](int,std::mt19937&){});
+	check_in_order(t,expected);
+	check(t.get_root());
+}
+
+void testNode(){
+	using namespace ronleeon::tree;
+	std::cout<<"sizeof rb_node<int>: "<<sizeof(node::rb_node<int>)
+		<<", compact_rb_node<int>: "<<sizeof(node::compact_rb_node<int>)<<'\n';
+	std::cout<<"sizeof avl_node<int>: "<<sizeof(node::avl_node<int>)
+		<<", compact_avl_node<int>: "<<sizeof(node::compact_avl_node<int>)<<'\n';
+	std::cout<<"sizeof bs_node<int>: "<<sizeof(node::bs_node<int>)
+		<<", compact_bs_node<int>: "<<sizeof(node::compact_bs_node<int>)<<'\n';
+	// with a pointer sized key, the tag saves the padded color/balance word.
+	std::cout<<"sizeof compact_rb_node<long>: "<<sizeof(node::compact_rb_node<long>)
+		<<", tagged_rb_node<long>: "<<sizeof(node::tagged_rb_node<long>)<<'\n';
+	std::cout<<"sizeof compact_avl_node<long>: "<<sizeof(node::compact_avl_node<long>)
+		<<", tagged_avl_node<long>: "<<sizeof(node::tagged_avl_node<long>)<<'\n';
+	static_assert(sizeof(node::compact_rb_node<int>)<=4*sizeof(void*));
+	static_assert(sizeof(node::compact_avl_node<int>)<=4*sizeof(void*));
+	static_assert(sizeof(node::tagged_rb_node<long>)==3*sizeof(void*)+sizeof(long));
+	static_assert(sizeof(node::tagged_avl_node<long>)==3*sizeof(void*)+sizeof(long));
+
+	{
+		rb_tree<int> t;
+		check_against_set(t,[](const node::rb_node<int>* root){
+			assert(black_height(root)>0);
+			check_bookkeeping(root);
+		});
+	}
+	{
+		rb_tree<int,std::less<int>,node::compact_rb_node<int>,rb_node_print_trait<node::compact_rb_node<int>>> t;
+		check_against_set(t,[](const node::compact_rb_node<int>* root){
+			assert(black_height(root)>0);
+			check_bookkeeping(root);
+		});
+	}
+	{
+		using tree_type = avl_tree<int>;
+		tree_type t;
+		check_against_set(t,[](const node::avl_node<int>* root){ assert(tree_type::is_balanced(root)); });
+	}
+	{
+		using tree_type = avl_tree<int,std::less<int>,node::compact_avl_node<int>,avl_node_print_trait<node::compact_avl_node<int>>>;
+		tree_type t;
+		check_against_set(t,[](const node::compact_avl_node<int>* root){ assert(tree_type::is_balanced(root)); });
+		assert(t.get_height(t.get_root())<12);
+	}
+	{
+		rb_tree<int,std::less<int>,node::tagged_rb_node<int>,rb_node_print_trait<node::tagged_rb_node<int>>> t;
+		check_against_set(t,[](const node::tagged_rb_node<int>* root){ assert(black_height(root)>0); });
+		// the color bit never leaks into the links.
+		for(auto node=t.start();node;node=decltype(t)::increment(node)){
+			assert(reinterpret_cast<std::uintptr_t>(node)%alignof(node::tagged_rb_node<int>)==0);
+		}
+	}
+	{
+		using tree_type = avl_tree<int,std::less<int>,node::tagged_avl_node<int>,avl_node_print_trait<node::tagged_avl_node<int>>>;
+		tree_type t;
+		check_against_set(t,[](const node::tagged_avl_node<int>* root){ assert(tree_type::is_balanced(root)); });
+	}
+	{
+		bs_tree<int> t;
+		check_against_set(t,[](const node::bs_node<int>* root){ check_bookkeeping(root); });
+	}
+	{
+		bs_tree<int,std::less<int>,node::compact_bs_node<int>,b_node_print_trait<node::compact_bs_node<int>>> t;
+		check_against_set(t,[](const node::compact_bs_node<int>* root){ check_bookkeeping(root); });
+		t.pre_order<false>(t.get_root(),std::cout);
+		t.post_order<false>(t.get_root(),std::cout);
+	}
+	std::cout<<"compact nodes: trees consistent\n";
+}
+
+void testIndexedNode(){
+	using namespace ronleeon::tree;
+	std::cout<<"sizeof rb_node<int>: "<<sizeof(node::rb_node<int>)
+		<<", indexed_rb_node<int>: "<<sizeof(node::indexed_rb_node<int>)<<'\n';
+	std::cout<<"sizeof B_node<int,6>: "<<sizeof(node::B_node<int,6>)
+		<<", indexed_B_node<int,6>: "<<sizeof(node::indexed_B_node<int,6>)<<'\n';
+	static_assert(sizeof(node::indexed_rb_node<int>)<=sizeof(node::rb_node<int>)/2);
+	{
+		rb_tree<int,std::less<int>,node::indexed_rb_node<int>,rb_node_print_trait<node::indexed_rb_node<int>>,index_pool_allocator<int>> t;
+		check_against_set(t,[](const node::indexed_rb_node<int>* root){ assert(black_height(root)>0); });
+	}
+	{
+		using tree_type = avl_tree<int,std::less<int>,node::indexed_avl_node<int>,avl_node_print_trait<node::indexed_avl_node<int>>,index_pool_allocator<int>>;
+		tree_type t;
+		check_against_set(t,[](const node::indexed_avl_node<int>* root){ assert(tree_type::is_balanced(root)); });
+	}
+	// every node went back to the pool.
+	assert(node_pool<node::indexed_rb_node<int>>::instance().size()==0);
+	assert(node_pool<node::indexed_avl_node<int>>::instance().size()==0);
+	{
+		using node_type = node::indexed_B_node<int,6>;
+		B_tree_Cormen<int,3,std::less<int>,node_type,B_node_print_trait<node_type>,index_pool_allocator<int>> t;
+		std::mt19937 gen(7);
+		std::uniform_int_distribution<int> dist(0,999);
+		std::set<int> expected;
+		for(int round=0;round<20000;++round){
+			int value=dist(gen);
+			if(round%2){
+				t.erase(value,round%4==1,round%3==0,round%5==0);
+				expected.erase(value);
+			}else{
+				t.insert(value);
+				expected.insert(value);
+			}
+		}
+		for(int value=0;value<1000;++value){
+			assert(std::get<2>(t.find(value))==(expected.count(value)>0));
+		}
+		assert(node_pool<node_type>::instance().size()==t.size());
+		for(int value:expected){
+			t.erase(value);
+		}
+		assert(t.is_empty()&&node_pool<node_type>::instance().size()==0);
+	}
+	{
+		indexed_tree_set<int> set;
+		for(int i=999;i>=0;--i){
+			set.insert(i);
+		}
+		int expected=0;
+		for(int value:set){
+			assert(value==expected++);
+		}
+		assert(expected==1000&&set.find(500)!=set.end());
+		indexed_tree_map<int,int> map;
+		for(int i=0;i<100;++i){
+			map.insert(i,i*i);
+		}
+		int key=9;
+		assert(map.find(key)!=map.end()&&map.size()==100);
+		map.erase(key);
+		assert(map.find(key)==map.end());
+	}
+	std::cout<<"indexed nodes: trees consistent\n";
+}
+
+// walks a B tree checking key order, key counts and that all leaves are on one level,
+// returns the number of keys.
+template<typename NodeType>
+size_t check_B_node(const NodeType* node,size_t MinKeys,size_t MaxKeys,size_t Depth,size_t& LeafDepth){
+	if(node->parent){
+		assert(node->data_size>=MinKeys);
+	}
+	assert(node->data_size<=MaxKeys);
+	for(size_t Index=1;Index<node->data_size;++Index){
+		assert(node->data[Index-1]<node->data[Index]);
+	}
+	if(node->is_leaf){
+		for(auto It=node->child_begin();It!=node->child_end();++It){
+			assert(!*It);
+		}
+		if(LeafDepth==0){
+			LeafDepth=Depth;
+		}
+		assert(LeafDepth==Depth);
+		return node->data_size;
+	}
+	size_t Keys=node->data_size;
+	auto It=node->child_begin();
+	for(size_t Index=0;Index<=node->data_size;++Index,++It){
+		assert(*It&&(*It)->parent==node);
+		if(Index<node->data_size){
+			assert((*It)->data[(*It)->data_size-1]<node->data[Index]);
+		}
+		Keys+=check_B_node<NodeType>(*It,MinKeys,MaxKeys,Depth+1,LeafDepth);
+	}
+	return Keys;
+}
+
+// random inserts and erases with every erase policy, checked against std::set.
+template<typename Tree>
+void check_B_tree(Tree& t,size_t MinKeys,size_t MaxKeys){
+	std::mt19937 gen(7);
+	std::uniform_int_distribution<int> dist(0,999);
+	std::set<int> expected;
+	for(int round=0;round<20000;++round){
+		int value=dist(gen);
+		if(round%2){
+			t.erase(value,round%4==1,round%3==0,round%5==0);
+			expected.erase(value);
+		}else{
+			t.insert(value);
+			expected.insert(value);
+		}
+		if(round%100==0&&t.get_root()){
+			size_t LeafDepth=0;
+			assert(check_B_node(t.get_root(),MinKeys,MaxKeys,1,LeafDepth)==expected.size());
+			assert(LeafDepth==t.get_height());
+		}
+	}
+	for(int value=0;value<1000;++value){
+		assert(std::get<2>(t.find(value))==(expected.count(value)>0));
+	}
+	for(int value:expected){
+		t.erase(value);
+	}
+	assert(t.is_empty()&&t.get_height()==0);
+}
+
+void testSplitBNode(){
+	using namespace ronleeon::tree;
+	std::cout<<"sizeof B_node<int,16>: "<<sizeof(node::B_node<int,16>)
+		<<", split_B_node<int,16> leaf: "<<sizeof(node::split_B_node<int,16>)
+		<<", internal: "<<sizeof(node::split_B_internal_node<int,16>)<<'\n';
+	static_assert(sizeof(node::split_B_node<int,16>)<sizeof(node::B_node<int,16>)/2);
+	{
+		B_tree_Kruth<int,5> t;
+		check_B_tree(t,2,4);
+	}
+	{
+		B_tree_Kruth<int,4,std::less<int>,node::B_node<int,4>> t;
+		check_B_tree(t,1,3);
+	}
+	{
+		B_tree_Cormen<int,3> t;
+		check_B_tree(t,2,5);
+	}
+	{
+		B_tree_Cormen<int,2,std::less<int>,node::B_node<int,4>> t;
+		check_B_tree(t,1,3);
+	}
+	std::cout<<"split B nodes: trees consistent\n";
+}
+
+void testAutoBTree(){
+	using namespace ronleeon::tree;
+	using line_node = B_tree_auto<long,B_node_cache_line>::node_type;
+	using two_line_node = B_tree_auto<long>::node_type;
+	using block_node = B_tree_auto<long,B_node_block>::node_type;
+	std::cout<<"B_tree_auto<long>: "<<B_auto_degree<long,B_node_cache_line>::value*2-1<<" keys in "<<sizeof(line_node)
+		<<" bytes, "<<B_auto_degree<long,B_node_two_lines>::value*2-1<<" keys in "<<sizeof(two_line_node)
+		<<" bytes, "<<B_auto_degree<long,B_node_block>::value*2-1<<" keys in "<<sizeof(block_node)
+		<<" bytes, "<<B_auto_degree<long,B_node_page>::value*2-1<<" keys in "
+		<<sizeof(B_tree_auto<long,B_node_page>::node_type)<<" bytes\n";
+	// leaves fill the target and their keys start on a cache line.
+	static_assert(sizeof(line_node)==B_node_cache_line&&alignof(line_node)==B_node_cache_line);
+	static_assert(sizeof(block_node)<=B_node_block&&sizeof(B_tree_auto<int,B_node_page>::node_type)<=B_node_page);
+	static_assert(B_auto_degree<long,B_node_cache_line>::value*2-1==5);
+	// by default the keys of 8-byte data take at most two cache lines.
+	static_assert(sizeof(two_line_node)==B_node_two_lines&&(B_auto_degree<long,B_node_two_lines>::value*2-1)*sizeof(long)<=2*B_node_cache_line);
+	{
+		B_tree_auto<int,B_node_cache_line> t;
+		constexpr size_t Degree = B_auto_degree<int,B_node_cache_line>::value;
+		check_B_tree(t,Degree-1,2*Degree-1);
+	}
+	{
+		B_tree_auto<int> t;
+		constexpr size_t Degree = B_auto_degree<int,B_node_two_lines>::value;
+		check_B_tree(t,Degree-1,2*Degree-1);
+	}
+	{
+		B_tree_auto<int,B_node_block> t;
+		constexpr size_t Degree = B_auto_degree<int,B_node_block>::value;
+		check_B_tree(t,Degree-1,2*Degree-1);
+	}
+	std::cout<<"auto B trees: trees consistent\n";
+}
+
+template<typename DataType,size_t Capacity,typename Compare=std::less<DataType>>
+void check_node_search(){
+	using namespace ronleeon::tree;
+	std::mt19937 gen(7);
+	std::uniform_int_distribution<int> dis(-50,50);
+	std::array<DataType,Capacity> Keys{};
+	Compare comp;
+	for(size_t Size=0;Size<=Capacity;++Size){
+		for(size_t I=0;I<Size;++I){
+			Keys[I]=static_cast<DataType>(dis(gen));
+		}
+		std::sort(Keys.begin(),Keys.begin()+Size,comp);
+		for(int Value=-52;Value<=52;++Value){
+			DataType Data=static_cast<DataType>(Value);
+			auto Expected=std::lower_bound(Keys.begin(),Keys.begin()+Size,Data,comp)-Keys.begin();
+			auto [Position,Found]=B_node_search(Keys,Size,Data,comp);
+			assert(Position==static_cast<size_t>(Expected));
+			assert(Found==(Position<Size&&!comp(Data,Keys[Position])));
+		}
+	}
+}
+
+void testNodeSearch(){
+	using namespace ronleeon::tree;
+	// scanned when the instruction set allows.
+	check_node_search<int,15>();
+	check_node_search<int,29>();
+	check_node_search<unsigned,29>();
+	check_node_search<long,29>();
+	check_node_search<unsigned long,5>();
+	check_node_search<float,29>();
+	check_node_search<double,29>();
+	// always bisected.
+	check_node_search<int,509>();
+	check_node_search<double,509>();
+	check_node_search<int,29,std::greater<int>>();
+	std::cout<<"node search: "<<(is_simd_searchable<int,std::less<int>>::value?"simd":"scalar")
+		<<" scan agrees with lower_bound\n";
+}
+
+// bulk loading checked against one insert per data, then the tree goes on with random updates.
+template<typename Tree>
+void check_B_build(size_t MinKeys,size_t MaxKeys){
+	std::vector<int> Data;
+	for(int value=0;value<30000;value+=3){
+		Data.push_back(value);
+	}
+	Tree Inserted;
+	for(int value:Data){
+		Inserted.insert(value);
+	}
+	for(double Fill:{1.0,0.7,0.0}){
+		Tree t;
+		t.build_from_sorted(Data.begin(),Data.end(),Fill);
+		size_t LeafDepth=0;
+		assert(check_B_node(t.get_root(),MinKeys,MaxKeys,1,LeafDepth)==Data.size());
+		assert(LeafDepth==t.get_height());
+		if(Fill==1.0){
+			assert(t.size()<Inserted.size());
+		}
+		std::mt19937 gen(7);
+		std::uniform_int_distribution<int> dist(0,29999);
+		std::set<int> expected(Data.begin(),Data.end());
+		for(int round=0;round<4000;++round){
+			int value=dist(gen);
+			if(round%2){
+				t.erase(value);
+				expected.erase(value);
+			}else{
+				t.insert(value);
+				expected.insert(value);
+			}
+		}
+		LeafDepth=0;
+		assert(check_B_node(t.get_root(),MinKeys,MaxKeys,1,LeafDepth)==expected.size());
+		size_t Nodes=t.size();
+		t.compact();
+		LeafDepth=0;
+		assert(check_B_node(t.get_root(),MinKeys,MaxKeys,1,LeafDepth)==expected.size());
+		assert(LeafDepth==t.get_height()&&t.size()<=Nodes);
+		for(int value=0;value<30000;value+=7){
+			assert(std::get<2>(t.find(value))==(expected.count(value)>0));
+		}
+	}
+	Tree t;
+	t.build_from_sorted(Data.begin(),Data.begin());
+	assert(t.is_empty());
+	t.build_from_sorted(Data.begin(),Data.begin()+1);
+	assert(t.size()==1&&t.get_height()==1);
+}
+
+void testBuildFromSorted(){
+	using namespace ronleeon::tree;
+	check_B_build<B_tree_Cormen<int,3>>(2,5);
+	check_B_build<B_tree_Cormen<int,2,std::less<int>,node::B_node<int,4>>>(1,3);
+	check_B_build<B_tree_Kruth<int,5>>(2,4);
+	check_B_build<B_tree_Kruth<int,4>>(1,3);
+	check_B_build<B_tree_auto<int>>(B_auto_degree<int,B_node_two_lines>::value-1,2*B_auto_degree<int,B_node_two_lines>::value-1);
+	std::cout<<"build from sorted: trees consistent\n";
+}
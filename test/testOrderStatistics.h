@@ -0,0 +1,80 @@
+#include <iostream>
+#include <cassert>
+#include <iterator>
+#include <random>
+#include <set>
+#include "ronleeon/tree/rb_tree.h"
+#include "ronleeon/tree/avl_tree.h"
+#include "ronleeon/tree/tree_set.h"
+#include "ronleeon/tree/tree_map.h"
+#include "testTreeCheck.h"
+
+// subtree sizes through random inserts and erases, order statistics against std::set.
+template<typename Tree,bool Joinable=true,typename Check>
+void check_order_statistics(Check check){
+	Tree t;
+	std::set<int> expected;
+	random_updates(t,expected,5,6000,1000,[&](int round,std::mt19937& gen){
+		if(round%500!=0&&round!=5999){
+			return;
+		}
+		check_bookkeeping(t.get_root());
+		check(t.get_root());
+		size_t Index=0;
+		for(int data:expected){
+			auto node=t.select(Index);
+			assert(node&&node->data==data&&Tree::index_of(node)==Index);
+			assert(t.rank(data)==Index&&t.rank(data+1)==Index+1);
+			++Index;
+		}
+		assert(!t.select(expected.size()));
+		std::uniform_int_distribution<int> dist(0,999);
+		int lo=dist(gen),hi=dist(gen);
+		assert(t.count_range(lo,hi)==(lo<hi?static_cast<size_t>(std::distance(expected.lower_bound(lo),expected.lower_bound(hi))):0));
+	});
+	// joins keep the sizes too.
+	if constexpr(Joinable){
+		Tree u;
+		for(int value=500;value<1500;value+=3){
+			u.insert(value);
+			expected.insert(value);
+		}
+		t.union_with(u);
+		check_bookkeeping(t.get_root());
+		assert(t.size()==expected.size()&&t.get_root()->subtree_size==expected.size());
+		assert(t.select(expected.size()-1)->data==*expected.rbegin());
+	}
+}
+
+void testOrderStatistics(){
+	using namespace ronleeon::tree;
+	check_order_statistics<rb_tree<int,std::less<int>,node::sized_rb_node<int>,rb_node_print_trait<node::sized_rb_node<int>>>>(
+		[](const node::sized_rb_node<int>* root){ assert(black_height(root)>0); });
+	{
+		using tree_type = avl_tree<int,std::less<int>,node::sized_avl_node<int>,avl_node_print_trait<node::sized_avl_node<int>>>;
+		check_order_statistics<tree_type>([](const node::sized_avl_node<int>* root){ assert(tree_type::is_balanced(root)); });
+	}
+	{
+		// without sizes the same answers come from walking in order.
+		rb_tree<int> t;
+		for(int value:{5,1,9,3,7}){
+			t.insert(value);
+		}
+		assert(t.select(2)->data==5&&t.rank(6)==3&&t.count_range(2,9)==3&&rb_tree<int>::index_of(t.select(4))==4);
+	}
+	{
+		order_statistic_tree_set<int> s;
+		for(int value=0;value<100;++value){
+			s.insert(value*2);
+		}
+		assert(*s.select(10)==20&&s.select(100)==s.end());
+		assert(s.rank(21)==11&&s.count_range(10,20)==5);
+		assert(s.index_of(s.find(40))==20&&s.index_of(s.end())==100);
+		order_statistic_tree_map<int,int> m;
+		for(int value=0;value<100;++value){
+			m.insert(value,value*value);
+		}
+		assert(m.select(7)->second==49&&m.rank(50)==50&&m.count_range(10,15)==5&&m.index_of(m.find(33))==33);
+	}
+	std::cout<<"order statistics: subtree sizes consistent\n";
+}
@@ -3,6 +3,12 @@
 #include "ronleeon/tree/bs_tree.h"
 #include "ronleeon/tree/tree_map.h"
 #include "ronleeon/tree/tree_set.h"
+#include "ronleeon/tree/splay_tree.h"
+#include "ronleeon/tree/tree_234.h"
+#include <cassert>
+#include <memory>
+#include <string>
+#include <string_view>
 
 void testSet() {
 	ronleeon::tree::tree_set<std::string, std::less<std::string>,ronleeon::tree::avl_tree<std::string>> set{
@@ -30,4 +36,238 @@ void testSet() {
 	}
 	std::cout<<*(++set.rend())<<'\n';
 	std::cout<<(--m.end())->first<<","<<(--m.end())->second<<'\n';
-}
\ No newline at end of file
+}
+// Value counting its default constructions, lookups must not make any.
+struct lookup_value{
+	static int& defaults(){
+		static int count = 0;
+		return count;
+	}
+	int v = 0;
+	lookup_value(){ ++defaults(); }
+	lookup_value(int v_):v(v_){}
+};
+
+void testMapLookup(){
+	using namespace ronleeon::tree;
+	{
+		tree_map<std::string,lookup_value> m;
+		for(int i=0;i<100;++i){
+			m.insert(std::to_string(i),lookup_value(i));
+		}
+		int Defaults=lookup_value::defaults();
+		for(int i=0;i<100;++i){
+			std::string Key=std::to_string(i);
+			std::string_view View(Key);
+			assert(m.find(View)!=m.end()&&m.find(View)->second.v==i);
+			assert(m.at(View).v==i&&m.contains(View)&&m.count(View)==1);
+			assert(m[Key].v==i&&m.at(Key).v==i&&m.find(Key)->first==Key);
+		}
+		assert(m.find(std::string_view("100"))==m.end()&&!m.contains(std::string_view("x")));
+		assert(m.find("42")->second.v==42);
+		m.at(std::string_view("7")).v=700;
+		assert(m.find(std::string("7"))->second.v==700);
+		m.erase(std::string_view("7"));
+		m.erase(std::string("8"));
+		m.erase(std::string_view("missing"));
+		assert(m.size()==98&&!m.contains(std::string_view("7"))&&!m.contains(std::string("8")));
+		assert(lookup_value::defaults()==Defaults);
+		const auto& Const=m;
+		assert(Const.find(std::string_view("9"))!=Const.end()&&Const.begin()->first=="0");
+	}
+	{
+		// sized nodes rank by key too.
+		order_statistic_tree_map<int,lookup_value> m;
+		for(int i=0;i<50;++i){
+			m.insert(i*2,lookup_value(i));
+		}
+		int Defaults=lookup_value::defaults();
+		assert(m.rank(10)==5&&m.count_range(10,20)==5&&m.count_range(20,10)==0);
+		assert(lookup_value::defaults()==Defaults);
+	}
+	{
+		// a backend without search by key builds the pair, a splay tree searches by key.
+		tree_map<int,int,less<pair<int,int>>,tree_234<pair<int,int>,less<pair<int,int>>>> m234;
+		tree_map<int,int,less<pair<int,int>>,splay_tree<pair<int,int>,less<pair<int,int>>>> splay;
+		for(int i=0;i<20;++i){
+			m234.insert(i,i*i);
+			splay.insert(i,i*i);
+		}
+		assert(m234.at(5)==25&&m234.contains(19)&&!m234.contains(20));
+		assert(splay.at(5)==25&&splay.find(7)->second==49&&splay.count(3)==1);
+		splay.erase(5);
+		m234.erase(5);
+		assert(!splay.contains(5)&&!m234.contains(5)&&splay.size()==19&&m234.size()==19);
+	}
+	std::cout<<"tree_map: lookups by key build no value\n";
+}
+
+// Value counting its constructions and copies, emplace must build it once in its node.
+struct emplace_value{
+	static int& constructions(){
+		static int count = 0;
+		return count;
+	}
+	static int& copies(){
+		static int count = 0;
+		return count;
+	}
+	int v = 0;
+	explicit emplace_value(int v_):v(v_){ ++constructions(); }
+	emplace_value(int a, int b):v(a+b){ ++constructions(); }
+	emplace_value(const emplace_value& rhs):v(rhs.v){ ++copies(); }
+	emplace_value(emplace_value&& rhs) noexcept :v(rhs.v){}
+	emplace_value& operator=(const emplace_value& rhs){ v=rhs.v; ++copies(); return *this; }
+	emplace_value& operator=(emplace_value&&) noexcept = default;
+};
+
+template<typename Map>
+void testMapEmplaceOn(){
+	using namespace ronleeon::tree;
+	Map m;
+	for(int i=0;i<50;++i){
+		auto [It,Inserted]=m.try_emplace(i,std::make_unique<int>(i));
+		assert(Inserted&&It->first==i&&*It->second==i);
+	}
+	// nothing is moved from on a present key.
+	auto Ptr=std::make_unique<int>(-1);
+	auto [It,Inserted]=m.try_emplace(7,std::move(Ptr));
+	assert(!Inserted&&*It->second==7&&Ptr);
+	auto Emplaced=m.emplace(std::in_place,50,std::make_unique<int>(50));
+	assert(Emplaced.second&&*Emplaced.first->second==50&&m.size()==51);
+	assert(!m.emplace(std::in_place,3,nullptr).second&&*m.find(3)->second==3);
+	assert(m.insert(pair<int,std::unique_ptr<int>>(60,std::make_unique<int>(60))).second);
+	int Expected=0;
+	for(auto It2=m.begin();It2!=m.end();++It2,++Expected){
+		assert(It2->first==Expected&&*It2->second==Expected);
+		if(Expected==50){
+			Expected=59;
+		}
+	}
+	m.erase(10);
+	assert(m.size()==51&&!m.contains(10)&&(--m.end())->first==60);
+}
+
+void testMapEmplace(){
+	using namespace ronleeon::tree;
+	using node_value = pair<int,std::unique_ptr<int>>;
+	testMapEmplaceOn<tree_map<int,std::unique_ptr<int>>>();
+	testMapEmplaceOn<tree_map<int,std::unique_ptr<int>,less<node_value>,avl_tree<node_value,less<node_value>>>>();
+	testMapEmplaceOn<tree_map<int,std::unique_ptr<int>,less<node_value>,splay_tree<node_value,less<node_value>>>>();
+	{
+		tree_map<int,emplace_value> m;
+		emplace_value::constructions()=emplace_value::copies()=0;
+		for(int i=0;i<20;++i){
+			m.try_emplace(i,i,1);
+		}
+		assert(emplace_value::constructions()==20&&emplace_value::copies()==0);
+		m.try_emplace(5,0);
+		m.emplace(std::in_place,30,3);
+		m.insert(pair<int,emplace_value>(std::in_place,31,4));
+		assert(emplace_value::constructions()==22&&emplace_value::copies()==0);
+		assert(m.at(5).v==6&&m.at(30).v==3&&m.at(31).v==4&&m.size()==22);
+	}
+	{
+		tree_set<std::string> set;
+		assert(set.emplace(3,'a').second&&set.emplace("b").second&&!set.emplace(3,'a').second);
+		std::string Moved("c");
+		assert(set.insert(std::move(Moved)).second&&set.size()==3&&*set.begin()=="aaa");
+		// a backend without emplace builds the data first.
+		tree_set<std::string,std::less<std::string>,tree_234<std::string>> set234;
+		assert(set234.emplace(2,'z').second&&!set234.emplace("zz").second&&*set234.begin()=="zz");
+	}
+	std::cout<<"tree_map: emplace builds values in place\n";
+}
+
+// insert_or_assign, operator[] and upsert find or link the node in one descent, a present node keeps its place.
+void testMapUpsert(){
+	using namespace ronleeon::tree;
+	{
+		tree_map<std::string,int> m;
+		const char* Words[]={"b","a","c","a","b","a"};
+		for(const char* Word:Words){
+			m.upsert(Word,[](int& Count){ ++Count; });
+		}
+		assert(m.size()==3&&m.at("a")==3&&m.at("b")==2&&m.at("c")==1);
+		assert(m["d"]==0&&m.size()==4);
+		++m[std::string("d")];
+		assert(m.at("d")==1);
+		auto Node=m.find("b").get_node_ptr();
+		auto It=m.insert_or_assign("b",20);
+		assert(It.get_node_ptr()==Node&&m.at("b")==20&&m.size()==4);
+		assert(m.insert_or_assign("e",5)->second==5&&(--m.end())->first=="e"&&m.size()==5);
+	}
+	{
+		// a present value is assigned, not copied into a new node.
+		tree_map<int,emplace_value,less<pair<int,emplace_value>>,splay_tree<pair<int,emplace_value>,less<pair<int,emplace_value>>>> m;
+		for(int i=0;i<10;++i){
+			m.try_emplace(i,i);
+		}
+		emplace_value::copies()=0;
+		m.insert_or_assign(3,emplace_value(30));
+		int Four=4;
+		m.insert_or_assign(std::move(Four),emplace_value(40));
+		assert(emplace_value::copies()==0&&m.at(3).v==30&&m.at(4).v==40&&m.size()==10);
+	}
+	{
+		// aggregates above an updated value are refreshed.
+		augmented_tree_map<int,long,value_sum<int,long>> sums;
+		augmented_tree_map<int,long,value_max<int,long>> maxima;
+		for(int i=0;i<100;++i){
+			sums.insert_or_assign(i,i);
+			maxima.upsert(i,[i](long& Value){ Value=i; });
+		}
+		sums.insert_or_assign(10,1000);
+		sums.upsert(20,[](long& Value){ Value+=100; });
+		maxima.upsert(50,[](long& Value){ Value=500; });
+		assert(sums.aggregate()==4950-10+1000+100&&sums.aggregate(10,21)==1000+135+120);
+		assert(maxima.aggregate()==500&&maxima.aggregate(0,50)==49);
+		assert(sums.aggregate(30,10)==0&&sums.aggregate(10,10)==0&&sums.aggregate(-5,0)==0&&sums.aggregate(99,200)==99);
+		// their values are only read through operator[] and at().
+		static_assert(std::is_same_v<decltype(sums[0]),const long&>&&std::is_same_v<decltype(sums.at(0)),const long&>);
+		assert(sums[10]==1000&&sums.at(20)==120&&sums[100]==0&&sums.aggregate()==4950-10+1000+100);
+	}
+	{
+		tree_map<int,int,less<pair<int,int>>,tree_234<pair<int,int>,less<pair<int,int>>>> m234;
+		for(int i=0;i<30;++i){
+			m234.upsert(i%10,[](int& Count){ ++Count; });
+		}
+		m234.insert_or_assign(2,7);
+		assert(m234.size()==10&&m234.at(1)==3&&m234.at(2)==7&&m234[11]==0&&m234.size()==11);
+	}
+	std::cout<<"tree_map: upserts keep their node\n";
+}
+
+// erasing the first, a middle and the last pair by iterator returns the next one and keeps the bounds.
+template<typename Map>
+void check_map_erase(){
+	Map m;
+	for(int i=0;i<10;++i){
+		m.insert(i,i*i);
+	}
+	auto First=m.erase(m.begin());
+	assert(First==m.begin()&&First->first==1&&m.size()==9);
+	auto Middle=m.erase(m.find(5));
+	assert(Middle->first==6&&Middle->second==36&&m.find(5)==m.end()&&m.size()==8);
+	auto Last=m.erase(--m.end());
+	assert(Last==m.end()&&(--m.end())->first==8&&m.begin()->first==1&&m.size()==7);
+	int Count=0;
+	for(auto It=m.begin();It!=m.end();++It){
+		assert(It->second==It->first*It->first);
+		++Count;
+	}
+	assert(Count==7);
+	while(m.size()){
+		m.erase(m.begin());
+	}
+	assert(m.begin()==m.end());
+}
+
+void testMapErase(){
+	using namespace ronleeon::tree;
+	check_map_erase<tree_map<int,int>>();
+	check_map_erase<tree_map<int,int,less<pair<int,int>>,avl_tree<pair<int,int>,less<pair<int,int>>>>>();
+	check_map_erase<tree_map<int,int,less<pair<int,int>>,splay_tree<pair<int,int>,less<pair<int,int>>>>>();
+	check_map_erase<tree_map<int,int,less<pair<int,int>>,tree_234<pair<int,int>,less<pair<int,int>>>>>();
+	std::cout<<"tree_map: erase by iterator keeps the bounds\n";
+}
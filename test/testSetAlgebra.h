@@ -0,0 +1,105 @@
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <set>
+#include <type_traits>
+#include "ronleeon/tree/rb_tree.h"
+#include "ronleeon/tree/avl_tree.h"
+#include "ronleeon/tree/tree_set.h"
+#include "testTreeCheck.h"
+
+// union, intersection, difference, join and split of random trees against std::set,
+// on one thread and with tasks forked down to small subproblems.
+template<typename Tree,typename Check>
+void check_set_algebra(Check check){
+	std::mt19937 gen(11);
+	for(int round=0;round<60;++round){
+		std::uniform_int_distribution<int> size(0,round<40?64:4000);
+		std::uniform_int_distribution<int> dist(0,round%3==0?100:10000);
+		std::set<int> a,b;
+		for(int count=size(gen);count>0;--count){
+			a.insert(dist(gen));
+		}
+		for(int count=size(gen);count>0;--count){
+			b.insert(dist(gen));
+		}
+		size_t Grain=round%2?1:std::numeric_limits<size_t>::max();
+		for(int op=0;op<3;++op){
+			// built trees have exact bookkeeping fields, rb_tree insertions do not refresh every height.
+			Tree x,y;
+			x.build_from_sorted(a.begin(),a.end());
+			y.build_from_sorted(b.begin(),b.end());
+			std::set<int> expected;
+			if(op==0){
+				std::set_union(a.begin(),a.end(),b.begin(),b.end(),std::inserter(expected,expected.end()));
+				x.union_with(y,Grain);
+			}else if(op==1){
+				std::set_intersection(a.begin(),a.end(),b.begin(),b.end(),std::inserter(expected,expected.end()));
+				x.intersect_with(y,Grain);
+			}else{
+				std::set_difference(a.begin(),a.end(),b.begin(),b.end(),std::inserter(expected,expected.end()));
+				x.difference_with(y,Grain);
+			}
+			check_joined(x,expected,check);
+			assert(y.size()==0&&!y.get_root()&&!y.start());
+			// still a valid tree.
+			x.insert(-1);
+			x.erase(-1);
+			assert(x.size()==expected.size());
+			if(x.get_root()){
+				check(x.get_root());
+			}
+		}
+		// split at a random key then join the parts back.
+		Tree x;
+		Tree y({},x.get_allocator());
+		x.build_from_sorted(a.begin(),a.end());
+		int key=dist(gen);
+		bool Found=x.split(key,y);
+		assert(Found==(a.count(key)==1));
+		std::set<int> less(a.begin(),a.lower_bound(key)),greater(a.lower_bound(key),a.end());
+		check_joined(x,less,check);
+		check_joined(y,greater,check);
+		x.join(y);
+		check_joined(x,a,check);
+		assert(y.size()==0);
+		assert(!x.size()||(x.start()->data==*a.begin()&&x.last()->data==*a.rbegin()));
+	}
+}
+
+void testSetAlgebra(){
+	using namespace ronleeon::tree;
+	auto rb_check=[](auto root){
+		using NodeType=std::remove_cv_t<std::remove_pointer_t<decltype(root)>>;
+		assert(black_height(root)>0&&node::rb_color_trait<NodeType>::color(root)==NodeType::COLOR::BLACK);
+	};
+	check_set_algebra<rb_tree<int>>(rb_check);
+	check_set_algebra<rb_tree<int,std::less<int>,node::tagged_rb_node<int>,rb_node_print_trait<node::tagged_rb_node<int>>>>(rb_check);
+	check_set_algebra<rb_tree<int,std::less<int>,node::indexed_rb_node<int>,rb_node_print_trait<node::indexed_rb_node<int>>,index_pool_allocator<int>>>(rb_check);
+	// every tree has its own arena, the other tree is copied first.
+	check_set_algebra<rb_tree<int,std::less<int>,node::rb_node<int>,rb_node_print_trait<node::rb_node<int>>,arena_allocator<int>>>(rb_check);
+	check_set_algebra<avl_tree<int>>([](const node::avl_node<int>* root){ assert(avl_tree<int>::is_balanced(root)); });
+	{
+		using tree_type = avl_tree<int,std::less<int>,node::tagged_avl_node<int>,avl_node_print_trait<node::tagged_avl_node<int>>>;
+		check_set_algebra<tree_type>([](const node::tagged_avl_node<int>* root){ assert(tree_type::is_balanced(root)); });
+	}
+	{
+		using tree_type = avl_tree<int,std::less<int>,node::compact_avl_node<int>,avl_node_print_trait<node::compact_avl_node<int>>>;
+		check_set_algebra<tree_type>([](const node::compact_avl_node<int>* root){ assert(tree_type::is_balanced(root)); });
+	}
+	{
+		tree_set<int> s{1,2,3,4,5},t{4,5,6,7};
+		s.union_with(t);
+		assert(s.size()==7&&t.size()==0&&t.begin()==t.end()&&*s.begin()==1&&*s.rbegin()==7);
+		tree_set<int> u{0,2,4,6,8};
+		s.intersect_with(u);
+		assert(s.size()==3&&*s.begin()==2&&*s.rbegin()==6);
+		tree_set<int> v{2,6};
+		s.difference_with(v);
+		assert(s.size()==1&&*s.begin()==4&&*s.rbegin()==4);
+	}
+	std::cout<<"set algebra: joined trees consistent\n";
+}
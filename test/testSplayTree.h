@@ -0,0 +1,87 @@
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <set>
+#include "ronleeon/tree/splay_tree.h"
+#include "ronleeon/tree/tree_set.h"
+#include "ronleeon/tree/tree_map.h"
+#include "testTreeCheck.h"
+// check_order_statistics is from testOrderStatistics.h, check_augmented and sequence_hash from testAugmented.h.
+
+// random inserts, finds and erases against std::set: the accessed node becomes the root and the
+// structure(parents, heights, sizes, start and last) stays consistent.
+template<typename Tree>
+void check_splay(){
+	std::mt19937 gen(17);
+	std::uniform_int_distribution<int> dist(0,1999);
+	Tree t;
+	std::set<int> expected;
+	auto none=[](const typename Tree::node_type*){};
+	for(int round=0;round<20000;++round){
+		int value=dist(gen);
+		switch(round%4){
+			case 0:
+			case 1:
+				assert(t.insert(value).second==expected.insert(value).second);
+				assert(t.get_root()->data==value);
+				break;
+			case 2:{
+				auto Find=t.find(value);
+				assert(Find.second==(expected.count(value)==1)&&Find.first==t.get_root());
+				break;
+			}
+			default:
+				if(round%8==3){
+					t.erase(value);
+				}else if(auto Find=t.find(value);Find.second){
+					auto Next=expected.upper_bound(value);
+					auto NextNode=t.erase(Find.first);
+					assert(Next==expected.end()?!NextNode:NextNode->data==*Next);
+				}
+				expected.erase(value);
+		}
+		if(round%1000==0||round==19999){
+			check_joined(t,expected,none);
+			assert(expected.empty()?!t.start()&&!t.last():t.start()->data==*expected.begin()&&t.last()->data==*expected.rbegin());
+		}
+	}
+	// skewed accesses keep the hot data near the root.
+	for(int round=0;round<1000;++round){
+		t.find(round%2?7:11);
+	}
+	const auto Const=&t;
+	assert(Const->find(11).second==expected.count(11));
+	check_joined(t,expected,none);
+}
+
+void testSplayTree(){
+	using namespace ronleeon::tree;
+	check_splay<splay_tree<int>>();
+	check_splay<splay_tree<int,std::less<int>,node::sized_bs_node<int>>>();
+	check_order_statistics<splay_tree<int,std::less<int>,node::sized_bs_node<int>>,false>([](const node::sized_bs_node<int>*){});
+	check_augmented<splay_tree<int,std::less<int>,node::augmented_bs_node<int,sequence_hash>>,false>([](const node::augmented_bs_node<int,sequence_hash>*){});
+	{
+		int Data[]={4,2,8,6};
+		splay_tree<int> t(Data,4);
+		assert(t.size()==4&&t.min()==2&&t.max()==8&&t.find(6).second&&t.get_root()->data==6);
+	}
+	{
+		tree_set<int,std::less<int>,splay_tree<int>> set{5,3,9,3,1};
+		assert(set.size()==4&&*set.begin()==1&&*set.rbegin()==9&&set.find(3)!=set.end()&&set.find(4)==set.end());
+		set.erase(set.find(1));
+		assert(*set.begin()==3);
+		tree_map<int,int,less<pair<int,int>>,splay_tree<pair<int,int>,less<pair<int,int>>>> m;
+		for(int key=0;key<50;++key){
+			m.insert(key,key*key);
+		}
+		assert(m.find(7)->second==49&&m.find(60)==m.end()&&m.size()==50);
+		m.erase(7);
+		int Count=0;
+		for(auto It=m.begin();It!=m.end();++It){
+			assert(It->second==It->first*It->first);
+			++Count;
+		}
+		assert(Count==49);
+	}
+	std::cout<<"splay tree: structure consistent\n";
+}
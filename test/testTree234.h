@@ -0,0 +1,94 @@
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "ronleeon/tree/tree_234.h"
+#include "ronleeon/tree/tree_set.h"
+#include "ronleeon/tree/tree_map.h"
+#include "ronleeon/tree/node_arena.h"
+
+// random inserts and erases against std::set, walking the slots both ways and checking the depth bound.
+template<typename Tree>
+void check_tree_234(){
+	std::mt19937 gen(18);
+	std::uniform_int_distribution<int> dist(0,2999);
+	Tree t;
+	std::set<int> expected;
+	for(int round=0;round<20000;++round){
+		int value=dist(gen);
+		if(round%3==2){
+			if(auto Find=t.find(value);Find.second&&round%2==0){
+				auto Next=expected.upper_bound(value);
+				auto NextSlot=t.erase(Find.first);
+				assert(Next==expected.end()?!NextSlot:NextSlot->data==*Next);
+			}else{
+				t.erase(value);
+			}
+			expected.erase(value);
+		}else{
+			auto Insert=t.insert(value);
+			assert(Insert.second==expected.insert(value).second&&Insert.first->data==value);
+		}
+		if(round%1000==0||round==19999){
+			assert(t.size()==expected.size());
+			assert((size_t(1)<<t.get_height())<=t.size()+1);
+			auto Slot=t.start();
+			for(int data:expected){
+				assert(Slot&&Slot->data==data);
+				Slot=Tree::increment(Slot);
+			}
+			assert(!Slot);
+			Slot=t.last();
+			for(auto It=expected.rbegin();It!=expected.rend();++It){
+				assert(Slot&&Slot->data==*It&&t.find(*It).first==Slot);
+				Slot=Tree::decrement(Slot);
+			}
+			assert(!Slot);
+		}
+	}
+}
+
+void testTree234(){
+	using namespace ronleeon::tree;
+	check_tree_234<tree_234<int>>();
+	check_tree_234<tree_234<int,std::less<int>,arena_allocator<int>>>();
+	{
+		std::vector<long> Data;
+		for(long value=0;value<1000;value+=2){
+			Data.push_back(value);
+		}
+		tree_234<long> t;
+		t.insert(7);
+		t.build_from_sorted(Data.begin(),Data.end());
+		assert(t.size()==500&&t.min()==0&&t.max()==998&&!t.find(7).second&&t.find(500).second);
+		assert((size_t(1)<<t.get_height())<=t.size()+1);
+		size_t Height=t.get_height();
+		tree_234<long> moved(std::move(t));
+		assert(moved.get_height()==Height&&moved.size()==500&&t.get_height()==0&&t.is_empty());
+		moved.erase(7);
+		assert(moved.size()==500);
+		moved.erase(500);
+		assert(moved.size()==499&&!moved.find(500).second);
+	}
+	{
+		tree_set<int,std::less<int>,tree_234<int>> set{5,3,9,3,1};
+		assert(set.size()==4&&*set.begin()==1&&*set.rbegin()==9&&set.find(3)!=set.end()&&set.find(4)==set.end());
+		set.erase(set.find(1));
+		assert(*set.begin()==3);
+		tree_map<int,std::string,less<pair<int,std::string>>,tree_234<pair<int,std::string>,less<pair<int,std::string>>>> m;
+		for(int key=0;key<50;++key){
+			m.insert(key,std::to_string(key));
+		}
+		assert(m.find(7)->second=="7"&&m.find(60)==m.end()&&m.size()==50);
+		m.erase(7);
+		int Count=0;
+		for(auto It=m.begin();It!=m.end();++It){
+			assert(It->second==std::to_string(It->first));
+			++Count;
+		}
+		assert(Count==49);
+	}
+	std::cout<<"2-3-4 tree: structure consistent\n";
+}
@@ -0,0 +1,136 @@
+// Structure checks of binary sort trees and the randomized driver the tree tests share.
+#ifndef RONLEEON_TEST_TREE_CHECK_H
+#define RONLEEON_TEST_TREE_CHECK_H
+
+#include <cassert>
+#include <algorithm>
+#include <random>
+#include <set>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ronleeon/tree/node.h"
+
+// black height of the subtree, or -1 if a red-black rule is broken.
+template<typename NodeType>
+int black_height(const NodeType* node){
+	using color_trait = ronleeon::tree::node::rb_color_trait<NodeType>;
+	if(!node){
+		return 1;
+	}
+	if(color_trait::color(node)==NodeType::COLOR::RED){
+		for(const NodeType* child:{node->left_child,node->right_child}){
+			if(child&&color_trait::color(child)==NodeType::COLOR::RED){
+				return -1;
+			}
+		}
+	}
+	int left=black_height<NodeType>(node->left_child);
+	int right=black_height<NodeType>(node->right_child);
+	if(left<0||left!=right){
+		return -1;
+	}
+	return left+(color_trait::color(node)==NodeType::COLOR::BLACK?1:0);
+}
+
+// height of every node(a leaf is 0), is_leaf and subtree_size are the real ones, returns the subtree height plus one.
+template<typename NodeType>
+int check_bookkeeping(const NodeType* node){
+	using bookkeeping=ronleeon::tree::node::node_bookkeeping<NodeType>;
+	if(!node){
+		return 0;
+	}
+	int Height=std::max(check_bookkeeping<NodeType>(node->left_child),check_bookkeeping<NodeType>(node->right_child))+1;
+	if constexpr(bookkeeping::has_height){
+		assert(node->height==static_cast<size_t>(Height-1));
+	}
+	assert(bookkeeping::is_leaf(node)==(!node->left_child&&!node->right_child));
+	if constexpr(bookkeeping::has_subtree_size){
+		assert(node->subtree_size==1+bookkeeping::subtree_size(node->left_child)+bookkeeping::subtree_size(node->right_child));
+	}
+	return Height;
+}
+
+// t holds expected, walked through the in-order links from start() and up to last().
+template<typename Tree>
+void check_in_order(Tree& t,const std::set<int>& expected){
+	assert(t.size()==expected.size());
+	auto node=t.start();
+	for(int value:expected){
+		assert(node&&node->data==value);
+		node=Tree::increment(node);
+	}
+	assert(!node);
+	assert(expected.empty()?!t.last():t.last()&&t.last()->data==*expected.rbegin());
+}
+
+// in-order data, parent links and bookkeeping of t match expected.
+template<typename Tree,typename Check>
+void check_joined(const Tree& t,const std::set<int>& expected,Check check){
+	assert(t.size()==expected.size());
+	auto root=t.get_root();
+	if(!root){
+		assert(expected.empty());
+		return;
+	}
+	assert(!root->parent);
+	check_bookkeeping(root);
+	check(root);
+	std::vector<const typename Tree::node_type*> Pending{root};
+	while(!Pending.empty()){
+		auto node=Pending.back();
+		Pending.pop_back();
+		for(auto child:{node->left_child,node->right_child}){
+			if(child){
+				assert(child->parent==node);
+				Pending.push_back(child);
+			}
+		}
+	}
+	auto node=Tree::left_most(root);
+	for(int value:expected){
+		assert(node&&node->data==value);
+		node=Tree::increment(node);
+	}
+	assert(!node);
+}
+
+// whether Tree chooses the side a node with two children is replaced from, see abstract_bs_tree::erase.
+template<typename Tree,typename = void>
+struct erases_from_side:std::false_type{};
+
+template<typename Tree>
+struct erases_from_side<Tree,std::void_t<decltype(std::declval<Tree&>().erase(std::declval<const int&>(),true))>>:std::true_type{};
+
+// Seeded random updates mirrored on std::set: each round draws a value of [0, Range), every third round
+// erases it(from the left and from the right in turn) and the others insert it through insert(value),
+// which returns the (node, inserted) pair of the tree. check(round, gen) runs after every round,
+// gen draws the values of its queries.
+template<typename Tree,typename Insert,typename Check>
+void random_updates(Tree& t,std::set<int>& expected,unsigned Seed,int Rounds,int Range,Insert insert,Check check){
+	std::mt19937 gen(Seed);
+	std::uniform_int_distribution<int> dist(0,Range-1);
+	for(int round=0;round<Rounds;++round){
+		int value=dist(gen);
+		if(round%3==2){
+			if constexpr(erases_from_side<Tree>::value){
+				t.erase(value,round%2==0);
+			}else{
+				t.erase(value);
+			}
+			expected.erase(value);
+		}else{
+			auto Inserted=insert(value);
+			assert(Inserted.second==expected.insert(value).second&&Inserted.first->data==value);
+		}
+		assert(t.size()==expected.size());
+		check(round,gen);
+	}
+}
+
+template<typename Tree,typename Check>
+void random_updates(Tree& t,std::set<int>& expected,unsigned Seed,int Rounds,int Range,Check check){
+	random_updates(t,expected,Seed,Rounds,Range,[&t](int value){ return t.insert(value); },check);
+}
+
+#endif